@@ -0,0 +1,20 @@
+#-------------------------------------------------
+#
+# Headless benchmarks of QWave data model, parser and renderer
+#
+#-------------------------------------------------
+
+QT       += core gui
+TARGET = qwave-benchmark
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+DEFINES += QT_NO_DEBUG_OUTPUT
+
+include(../QWave.pri)
+
+SOURCES += \
+    main.cpp
+
+HEADERS += \
+    BenchmarkDevice.h
@@ -0,0 +1,86 @@
+//
+//   BenchmarkDevice.h
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef BENCHMARKDEVICE_H
+#define BENCHMARKDEVICE_H
+
+#include "../Device/AbstractDevice.h"
+#include <QVector>
+
+/**
+ * @brief The BenchmarkDevice class is device holding synthetic raw data, used to
+ * feed CaptureController::updateData without hardware or capture thread.
+ */
+class BenchmarkDevice : public AbstractDevice
+{
+    Q_OBJECT
+    QVector<uint8_t> analog1;
+    QVector<uint8_t> analog2;
+    QVector<uint16_t> digital;
+    QVector<uint8_t*> rawDataList;
+public:
+    BenchmarkDevice(unsigned int length) : analog1(length), analog2(length), digital(length)
+    {
+        for(unsigned int i = 0; i < length; ++i)
+        {
+            analog1[i] = (i*7)%256;
+            analog2[i] = 255-(i*3)%256;
+            digital[i] = (i*0x9E37)^(i >> 3);
+        }
+        rawDataList.append(analog1.data());
+        rawDataList.append(analog2.data());
+        rawDataList.append(reinterpret_cast<uint8_t*>(digital.data()));
+    }
+    void emitDataUpdated() { emit dataUpdated(); }
+    QString getName() { return "BENCHMARK"; }
+    int getCapability() { return TWO_ANALOG_ONE_DIGITAL; }
+    QVector<uint8_t*> getRawDataList() { return rawDataList; }
+    unsigned int getRawDataLength() { return digital.count(); }
+    void lockData() {}
+    void unlockData() {}
+    void setTrigger(int, int, QVector<uint8_t>, int) {}
+    void setOffsetAndGain(QVector<uint8_t>, QVector<uint8_t>) {}
+    void setAttenuator(int, int) {}
+    void setCoupling(int, int) {}
+    void setDecimation(int, int) {}
+    void setLogicSupply(uint8_t) {}
+    uint8_t getLogicSupply() { return 0; }
+    QPair<int, QVector<uint8_t> > getTrigger(int, int) { return QPair<int, QVector<uint8_t> >(0, QVector<uint8_t>()); }
+    QPair<QVector<uint8_t>, QVector<uint8_t> > getOffsetAndGain() { return QPair<QVector<uint8_t>, QVector<uint8_t> >(); }
+    int getAttenuator(int) { return 0; }
+    int getCoupling(int) { return 0; }
+    QPair<int, int> getDecimation() { return QPair<int, int>(0, 0); }
+    void armDevice(int, CaptureController*) {}
+signals:
+    void dataUpdated();
+};
+
+#endif // BENCHMARKDEVICE_H
@@ -0,0 +1,440 @@
+//
+//   main.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <QApplication>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <QTemporaryFile>
+#include <QTextStream>
+#include <QImage>
+#include <QPainter>
+#include "BenchmarkDevice.h"
+#include "../Datamodel/PlotData.h"
+#include "../Datamodel/PlotTreeModel.h"
+#include "../Datamodel/FileSplitter.h"
+#include "../Datamodel/ChunkPool.h"
+#include "../Datamodel/Constants.h"
+#include "../Device/CaptureController.h"
+#include "../GUI/Plot.h"
+#include "../Exceptions/Exception.h"
+#include <math.h>
+
+static const int IMAGE_WIDTH = 1920;
+static const int ZOOMED_DIV_SIZE = 4;
+// keeps compiler from dropping measured reads
+static volatile uint64_t readSink;
+
+/**
+ * @brief The Result struct holds result of one benchmark.
+ */
+struct Result
+{
+    QString name;
+    uint64_t samples;
+    uint64_t bytes;
+    int iterations;
+    qint64 nsecs;
+};
+
+/**
+ * @brief The Settings struct holds command line options.
+ */
+struct Settings
+{
+    uint64_t samples;
+    int signalCount;
+    int iterations;
+    bool json;
+};
+
+/**
+ * @brief newResult creates result and fills it's counters.
+ */
+static Result newResult(QString name, uint64_t samples, uint64_t bytes, int iterations, qint64 nsecs)
+{
+    Result result;
+    result.name = name;
+    result.samples = samples;
+    result.bytes = bytes;
+    result.iterations = iterations;
+    result.nsecs = nsecs;
+    return result;
+}
+
+/**
+ * @brief benchAppend measures PlotData::appendDataAtBit sample by sample.
+ */
+static Result benchAppend(const Settings & settings)
+{
+    QElapsedTimer timer;
+    qint64 nsecs = 0;
+    for(int it = 0; it < settings.iterations; ++it)
+    {
+        PlotData data(PlotData::Logic, "append", 1000, 1, '!');
+        timer.start();
+        for(uint64_t i = 0; i < settings.samples; ++i)
+        {
+            data.appendDataAtBit(0, (i & 64) ? HIGH : LOW);
+        }
+        nsecs += timer.nsecsElapsed();
+    }
+    return newResult("append", settings.samples, settings.samples, settings.iterations, nsecs);
+}
+
+/**
+ * @brief benchNearestTime measures walking all transitions by PlotData::getNearestTime.
+ */
+static Result benchNearestTime(const Settings & settings)
+{
+    PlotData data(PlotData::Logic, "nearest", 1000, 8, '!');
+    for(int bit = 0; bit < data.getBitwidth(); ++bit)
+    {
+        for(uint64_t i = 0; i < settings.samples; ++i)
+        {
+            data.appendDataAtBit(bit, ((i >> (bit+4)) & 1) ? HIGH : LOW);
+        }
+    }
+    QElapsedTimer timer;
+    timer.start();
+    for(int it = 0; it < settings.iterations; ++it)
+    {
+        uint64_t time = 0;
+        while(time < settings.samples)
+        {
+            time = data.getNearestTime(time);
+        }
+    }
+    return newResult("nearest_time", settings.samples*data.getBitwidth(), settings.samples*data.getBitwidth(), settings.iterations, timer.nsecsElapsed());
+}
+
+/**
+ * @brief writeVcd writes synthetic VCD file with settings.signalCount wires toggling randomly.
+ */
+static void writeVcd(QFile * file, const Settings & settings)
+{
+    QTextStream out(file);
+    out << "$timescale 1ns $end" << endl;
+    out << "$scope module top $end" << endl;
+    for(int i = 0; i < settings.signalCount; ++i)
+    {
+        out << "$var wire 1 " << static_cast<char>('!'+i) << " s" << i << " $end" << endl;
+    }
+    out << "$upscope $end" << endl;
+    out << "$enddefinitions $end" << endl;
+    out << "$dumpvars" << endl;
+    for(int i = 0; i < settings.signalCount; ++i)
+    {
+        out << "0" << static_cast<char>('!'+i) << endl;
+    }
+    out << "$end" << endl;
+    uint32_t state = 1;
+    for(uint64_t time = 1; time < settings.samples; ++time)
+    {
+        out << "#" << time << endl;
+        for(int i = 0; i < settings.signalCount; ++i)
+        {
+            state = state*1103515245+12345;
+            if((state >> 16) & 3)
+                continue;
+            out << ((state >> 20) & 1) << static_cast<char>('!'+i) << endl;
+        }
+    }
+}
+
+/**
+ * @brief benchVcd measures loading synthetic VCD file by FileSplitter and PlotTreeModel
+ * and saving it back.
+ */
+static QList<Result> benchVcd(const Settings & settings)
+{
+    QTemporaryFile input;
+    if(not input.open())
+        throw Exception("Cannot create temporary file.");
+    writeVcd(&input, settings);
+    input.close();
+    qint64 inputSize = input.size();
+    qint64 outputSize = 0;
+    QElapsedTimer timer;
+    qint64 loadNsecs = 0;
+    qint64 saveNsecs = 0;
+    for(int it = 0; it < settings.iterations; ++it)
+    {
+        PlotTreeModel model;
+        QFile file(input.fileName());
+        if(not file.open(QIODevice::ReadOnly | QIODevice::Text))
+            throw Exception("Cannot open temporary file.");
+        timer.start();
+        FileSplitter splitter(&file);
+        model.loadFromFile(splitter);
+        loadNsecs += timer.nsecsElapsed();
+        file.close();
+        QTemporaryFile output;
+        if(not output.open())
+            throw Exception("Cannot create temporary file.");
+        timer.start();
+        model.saveToFile(&output);
+        output.flush();
+        saveNsecs += timer.nsecsElapsed();
+        outputSize = output.size();
+    }
+    uint64_t samples = settings.samples*settings.signalCount;
+    QList<Result> results;
+    results << newResult("vcd_load", samples, inputSize, settings.iterations, loadNsecs);
+    results << newResult("vcd_save", samples, outputSize, settings.iterations, saveNsecs);
+    return results;
+}
+
+/**
+ * @brief benchUpdateData measures conversion of raw device data to data model
+ * by CaptureController::updateData, two analog channels and 16 bit register.
+ */
+static Result benchUpdateData(const Settings & settings)
+{
+    QElapsedTimer timer;
+    qint64 nsecs = 0;
+    for(int it = 0; it < settings.iterations; ++it)
+    {
+        BenchmarkDevice device(settings.samples);
+        CaptureController controller;
+        PlotData analog1(PlotData::Linear, "a1", 8000, 1, '!');
+        PlotData analog2(PlotData::Linear, "a2", 8000, 1, '"');
+        PlotData digital(PlotData::Logic, "d", 8000, 16, '#');
+        controller.assignDevicePlotData(&analog1, &device, 0, 0, 1);
+        controller.assignDevicePlotData(&analog2, &device, 1, 0, 1);
+        controller.assignDevicePlotData(&digital, &device, 2, 0, 16);
+        QObject::connect(&device, SIGNAL(dataUpdated()), &controller, SLOT(updateData()), Qt::DirectConnection);
+        timer.start();
+        device.emitDataUpdated();
+        nsecs += timer.nsecsElapsed();
+    }
+    // raw bytes per sample: two analog bytes and two digital bytes
+    return newResult("update_data", settings.samples, settings.samples*4, settings.iterations, nsecs);
+}
+
+/**
+ * @brief benchCompressed measures appending slowly changing analog signal into
+ * compressed buffer and reading it back run by run. Bytes of append result are
+ * packed bytes plus chunks left resident, either unfilled or not worth packing,
+ * compare them with samples to get compression ratio.
+ */
+static QList<Result> benchCompressed(const Settings & settings)
+{
+    size_t residentBefore = ChunkPool::instance().getUsedBytes();
+    PlotData analog(PlotData::Linear, "packed", 8000, 1, '!');
+    analog.setCompressed(true);
+    QElapsedTimer timer;
+    timer.start();
+    for(uint64_t i = 0; i < settings.samples; ++i)
+    {
+        // slow sine with two bits of noise like from real ADC
+        analog.appendDataAtBit(0, static_cast<unsigned char>(127+100*sin(i*0.0005)+(i*7919)%4));
+    }
+    qint64 appendNsecs = timer.nsecsElapsed();
+    size_t stored = analog.getBuffer()->getPackedBytes()+ChunkPool::instance().getUsedBytes()-residentBefore;
+    timer.start();
+    uint64_t sum = 0;
+    for(int it = 0; it < settings.iterations; ++it)
+    {
+        for(size_t sample = 0; sample < settings.samples; )
+        {
+            size_t length;
+            const unsigned char * run = analog.getRun(0, sample, length);
+            for(size_t i = 0; i < length; ++i)
+            {
+                sum += run[i];
+            }
+            sample += length;
+        }
+    }
+    qint64 readNsecs = timer.nsecsElapsed();
+    readSink = sum;
+    QList<Result> results;
+    results << newResult("append_compressed", settings.samples, stored, 1, appendNsecs);
+    results << newResult("read_compressed", settings.samples, settings.samples, settings.iterations, readNsecs);
+    return results;
+}
+
+/**
+ * @brief benchPaint measures painting given data into offscreen image.
+ * @param name name of benchmark.
+ * @param data data to paint.
+ * @param interpolation interpolation of analog plot.
+ * @param divSize pixels per sample.
+ */
+static Result benchPaint(const Settings & settings, QString name, PlotData * data, int interpolation, double divSize)
+{
+    Plot plot(data, name);
+    plot.setInterpolation(interpolation);
+    QImage image(IMAGE_WIDTH, plot.getHeight()+2, QImage::Format_ARGB32_Premultiplied);
+    QElapsedTimer timer;
+    timer.start();
+    for(int it = 0; it < settings.iterations; ++it)
+    {
+        image.fill(0);
+        QPainter painter(&image);
+        painter.setPen(QColor(0, 255, 0));
+        plot.paint(&painter, 1, IMAGE_WIDTH, 0, divSize);
+        painter.end();
+    }
+    qint64 nsecs = timer.nsecsElapsed();
+    uint64_t samples = qMin<uint64_t>(settings.samples, static_cast<uint64_t>(IMAGE_WIDTH/divSize));
+    return newResult(name, samples, samples*data->getBitwidth(), settings.iterations, nsecs);
+}
+
+/**
+ * @brief benchPaintAll measures painting of analog, wire and register plots,
+ * both with whole data in view and zoomed in.
+ */
+static QList<Result> benchPaintAll(const Settings & settings)
+{
+    PlotData analog(PlotData::Linear, "analog", 8000, 1, '!');
+    PlotData wire(PlotData::Logic, "wire", 8000, 1, '"');
+    PlotData reg(PlotData::Logic, "register", 8000, 8, '#');
+    for(uint64_t i = 0; i < settings.samples; ++i)
+    {
+        analog.appendDataAtBit(0, static_cast<unsigned char>(127+120*sin(i*0.05)));
+        wire.appendDataAtBit(0, ((i >> 3) & 1) ? HIGH : LOW);
+        for(int bit = 0; bit < reg.getBitwidth(); ++bit)
+        {
+            reg.appendDataAtBit(bit, ((i >> (bit+2)) & 1) ? HIGH : LOW);
+        }
+    }
+    double fitDivSize = static_cast<double>(IMAGE_WIDTH)/settings.samples;
+    QList<Result> results;
+    results << benchPaint(settings, "paint_linear_fit", &analog, Plot::Linear, fitDivSize);
+    results << benchPaint(settings, "paint_linear_zoom", &analog, Plot::Linear, ZOOMED_DIV_SIZE);
+    results << benchPaint(settings, "paint_sinc_zoom", &analog, Plot::Sinc, ZOOMED_DIV_SIZE);
+    results << benchPaint(settings, "paint_dots_zoom", &analog, Plot::Dots, ZOOMED_DIV_SIZE);
+    results << benchPaint(settings, "paint_wire_fit", &wire, Plot::Linear, fitDivSize);
+    results << benchPaint(settings, "paint_wire_zoom", &wire, Plot::Linear, ZOOMED_DIV_SIZE);
+    results << benchPaint(settings, "paint_register_zoom", &reg, Plot::Linear, ZOOMED_DIV_SIZE);
+    return results;
+}
+
+/**
+ * @brief printResults prints results as CSV or JSON to standard output.
+ */
+static void printResults(const QList<Result> & results, const Settings & settings)
+{
+    QTextStream out(stdout);
+    if(settings.json)
+    {
+        out << "{\"samples\": " << settings.samples << ", \"signals\": " << settings.signalCount
+            << ", \"iterations\": " << settings.iterations << ", \"results\": [" << endl;
+    }
+    else
+    {
+        out << "benchmark,samples,bytes,iterations,total_ns,ns_per_sample,mb_per_s" << endl;
+    }
+    for(int i = 0; i < results.count(); ++i)
+    {
+        const Result & r = results.at(i);
+        double nsPerSample = r.samples > 0 ? static_cast<double>(r.nsecs)/r.iterations/r.samples : 0;
+        double mbPerS = r.nsecs > 0 ? (static_cast<double>(r.bytes)*r.iterations/E6)/(static_cast<double>(r.nsecs)/E9) : 0;
+        if(settings.json)
+        {
+            out << "  {\"benchmark\": \"" << r.name << "\", \"samples\": " << r.samples
+                << ", \"bytes\": " << r.bytes << ", \"iterations\": " << r.iterations
+                << ", \"total_ns\": " << r.nsecs << ", \"ns_per_sample\": " << nsPerSample
+                << ", \"mb_per_s\": " << mbPerS << "}" << (i+1 < results.count() ? "," : "") << endl;
+        }
+        else
+        {
+            out << r.name << "," << r.samples << "," << r.bytes << "," << r.iterations << ","
+                << r.nsecs << "," << nsPerSample << "," << mbPerS << endl;
+        }
+    }
+    if(settings.json)
+    {
+        out << "]}" << endl;
+    }
+}
+
+/**
+ * @brief main runs all benchmarks.
+ * Options: --samples N, --signals N (at most 90), --iterations N, --json.
+ * @param argc
+ * @param argv
+ * @return
+ */
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv, false);
+    Settings settings;
+    settings.samples = 1000000;
+    settings.signalCount = 16;
+    settings.iterations = 5;
+    settings.json = false;
+    QStringList args = app.arguments();
+    for(int i = 1; i < args.count(); ++i)
+    {
+        if(args.at(i) == "--json")
+        {
+            settings.json = true;
+        }
+        else if(i+1 < args.count() and args.at(i) == "--samples")
+        {
+            settings.samples = args.at(++i).toULongLong();
+        }
+        else if(i+1 < args.count() and args.at(i) == "--signals")
+        {
+            settings.signalCount = qBound(1, args.at(++i).toInt(), 90);
+        }
+        else if(i+1 < args.count() and args.at(i) == "--iterations")
+        {
+            settings.iterations = qMax(1, args.at(++i).toInt());
+        }
+        else
+        {
+            QTextStream(stderr) << "Usage: " << args.at(0) << " [--samples N] [--signals N] [--iterations N] [--json]" << endl;
+            return 1;
+        }
+    }
+    if(settings.samples < 2)
+        settings.samples = 2;
+    try
+    {
+        QList<Result> results;
+        results << benchAppend(settings);
+        results << benchNearestTime(settings);
+        results << benchVcd(settings);
+        results << benchUpdateData(settings);
+        results << benchCompressed(settings);
+        results << benchPaintAll(settings);
+        printResults(results, settings);
+    }
+    catch (Exception e)
+    {
+        QTextStream(stderr) << e.getMessage() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,21 @@
+#-------------------------------------------------
+#
+# Command line capture and VCD conversion tool
+#
+#-------------------------------------------------
+
+QT       += core gui
+TARGET = qwave-cli
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+DEFINES += QT_NO_DEBUG_OUTPUT
+
+include(../Core.pri)
+
+SOURCES += \
+    main.cpp \
+    CliCapture.cpp
+
+HEADERS += \
+    CliCapture.h
@@ -0,0 +1,206 @@
+//
+//   CliCapture.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "CliCapture.h"
+#include "../Device/Capabilities.h"
+#include "../Exceptions/Exception.h"
+#include <QCoreApplication>
+#include <QTextStream>
+#include <QFile>
+
+#define BASE_DIV 8000
+#define LOGIC_MAX_BITS 16
+
+CliCapture::CliCapture(const CaptureSettings & settings, QObject *parent) :
+    QObject(parent), settings(settings), controller(this), nextSign('!'), shotsDone(0), samples(0), bytesPerSample(0)
+{
+    connect(&controller, SIGNAL(captureFinished(unsigned int)), this, SLOT(shotFinished(unsigned int)));
+    connect(&controller, SIGNAL(captureTimedOut()), this, SLOT(timedOut()));
+}
+
+/**
+ * @brief CliCapture::setup connects device, creates data for every requested channel,
+ * assigns them to device and sets trigger and decimation.
+ * Channels are "analog1", "analog2", "wire" or "reg:WIDTH".
+ */
+void CliCapture::setup()
+{
+    if(settings.device == "ft245")
+    {
+        controller.addFt245Device();
+    }
+    else if(settings.device == "dummy")
+    {
+        controller.addDummyDevice();
+    }
+    else
+    {
+        throw Exception("Unknown device: "+settings.device);
+    }
+    AbstractDevice* device = controller.getDeviceController()->getDevice(0);
+    uint64_t div = static_cast<uint64_t>(BASE_DIV) << settings.ratioBase;
+    model.initHierarchy();
+    bool hasDigital = false;
+    for(int i = 0; i < settings.channels.count(); ++i)
+    {
+        QString channel = settings.channels.at(i);
+        PlotData* newData;
+        if(channel == "analog1" or channel == "analog2")
+        {
+            int dataId = channel == "analog1" ? 0 : 1;
+            if((dataId == 0 and not controller.isAnalog1Free(device)) or (dataId == 1 and not controller.isAnalog2Free(device)))
+                throw Exception("Channel assigned twice: "+channel);
+            newData = new PlotData(PlotData::Linear, channel, div, 1, nextSign++);
+            newData->setCompressed(settings.compressed);
+            controller.assignDevicePlotData(newData, device, dataId, 0, 0);
+            bytesPerSample += 1;
+        }
+        else if(channel == "wire" or channel.startsWith("reg:"))
+        {
+            int width = channel == "wire" ? 1 : channel.mid(4).toInt();
+            int wire = controller.getCurrentWireIndex(device);
+            if(width < 1 or wire+width > LOGIC_MAX_BITS)
+                throw Exception("Not enough wires for channel: "+channel);
+            newData = new PlotData(PlotData::Logic, (width == 1 ? "wire" : "reg")+QString::number(wire), div, width, nextSign++);
+            controller.assignDevicePlotData(newData, device, 2, wire, width);
+            hasDigital = true;
+        }
+        else
+        {
+            throw Exception("Unknown channel: "+channel);
+        }
+        data.append(newData);
+        model.registerData(newData);
+    }
+    if(data.isEmpty())
+        throw Exception("No channel to capture.");
+    if(hasDigital)
+        bytesPerSample += sizeof(uint16_t);
+    if(settings.hasTrigger)
+        device->setTrigger(settings.triggerKind, settings.triggerType, settings.triggerValues, settings.triggerChannel);
+    device->setDecimation(settings.ratioBase, settings.style);
+}
+
+/**
+ * @brief CliCapture::start arms device, capture keeps running until isDone.
+ */
+void CliCapture::start()
+{
+    timer.start();
+    try
+    {
+        controller.startCapture(settings.shots != 1 or settings.seconds > 0, data);
+    }
+    catch(Exception e)
+    {
+        fail(e.getMessage());
+    }
+}
+
+/**
+ * @brief CliCapture::isDone
+ * @return returns true when requested number of shots was captured or requested time elapsed.
+ */
+bool CliCapture::isDone()
+{
+    if(settings.seconds > 0)
+        return timer.elapsed() >= settings.seconds*1000;
+    return shotsDone >= settings.shots;
+}
+
+/**
+ * @brief CliCapture::shotFinished called after each captured shot, reports progress.
+ * @param samples number of samples appended by this shot.
+ */
+void CliCapture::shotFinished(unsigned int samples)
+{
+    ++shotsDone;
+    this->samples += samples;
+    double seconds = timer.nsecsElapsed()/1E9;
+    QTextStream err(stderr);
+    err << "shot " << shotsDone;
+    if(settings.seconds <= 0)
+        err << "/" << settings.shots;
+    err << ": " << this->samples << " samples, " << seconds << " s" << endl;
+    if(isDone())
+    {
+        controller.stopCapture();
+        try
+        {
+            finish();
+        }
+        catch(Exception e)
+        { // slots run in event loop, so exception would not reach main
+            fail(e.getMessage());
+        }
+    }
+}
+
+/**
+ * @brief CliCapture::timedOut called when device got no data, capture is stopped
+ * and application exits with error.
+ */
+void CliCapture::timedOut()
+{
+    controller.stopCapture();
+    fail("No data captured, device timed out.");
+}
+
+/**
+ * @brief CliCapture::fail prints message and quits event loop with error.
+ * @param message
+ */
+void CliCapture::fail(const QString & message)
+{
+    QTextStream(stderr) << message << endl;
+    QCoreApplication::exit(1);
+}
+
+/**
+ * @brief CliCapture::finish writes VCD file, prints throughput and quits event loop.
+ */
+void CliCapture::finish()
+{
+    double seconds = timer.nsecsElapsed()/1E9;
+    QTextStream err(stderr);
+    QFile file(settings.output);
+    if(not file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        fail("Could not open file: "+settings.output);
+        return;
+    }
+    model.saveToFile(&file);
+    file.close();
+    err << "captured " << shotsDone << " shots, " << samples << " samples in " << seconds << " s, "
+        << (seconds > 0 ? samples/seconds : 0) << " samples/s, "
+        << (seconds > 0 ? samples*bytesPerSample/seconds/1E6 : 0) << " MB/s" << endl;
+    QCoreApplication::exit(0);
+}
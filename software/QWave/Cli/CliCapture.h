@@ -0,0 +1,90 @@
+//
+//   CliCapture.h
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef CLICAPTURE_H
+#define CLICAPTURE_H
+
+#include <QObject>
+#include <QStringList>
+#include <QElapsedTimer>
+#include "../Device/CaptureController.h"
+#include "../Datamodel/PlotTreeModel.h"
+
+/**
+ * @brief The CaptureSettings struct holds everything needed to run capture from command line.
+ */
+struct CaptureSettings
+{
+    QString device;
+    QStringList channels;
+    bool hasTrigger;
+    int triggerKind;
+    int triggerType;
+    int triggerChannel;
+    QVector<uint8_t> triggerValues;
+    int ratioBase;
+    int style;
+    bool compressed;
+    int shots;
+    double seconds;
+    QString output;
+};
+
+/**
+ * @brief The CliCapture class drives CaptureController without any widget.
+ * It connects device, assigns channels, arms device until requested number of shots
+ * or time elapsed and then writes captured data to VCD file.
+ */
+class CliCapture : public QObject
+{
+    Q_OBJECT
+    CaptureSettings settings;
+    CaptureController controller;
+    PlotTreeModel model;
+    QVector<PlotData*> data;
+    QElapsedTimer timer;
+    char nextSign;
+    int shotsDone;
+    uint64_t samples;
+    int bytesPerSample;
+    bool isDone();
+    void finish();
+    void fail(const QString & message);
+public:
+    CliCapture(const CaptureSettings & settings, QObject *parent = 0);
+    void setup();
+public slots:
+    void start();
+    void shotFinished(unsigned int samples);
+    void timedOut();
+};
+
+#endif // CLICAPTURE_H
@@ -0,0 +1,317 @@
+//
+//   main.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <QApplication>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QFileInfo>
+#include <QTimer>
+#include "CliCapture.h"
+#include "../Datamodel/PlotTreeModel.h"
+#include "../Datamodel/FileSplitter.h"
+#include "../Device/Capabilities.h"
+#include "../Exceptions/Exception.h"
+#include "../Exceptions/IOException.h"
+
+#define USAGE \
+"Usage:\n" \
+"  qwave-cli capture --output FILE.vcd [--device dummy|ft245] [--channel analog1|analog2|wire|reg:WIDTH]...\n" \
+"                    [--trigger analog1|analog2:rising|falling|rising-slope|falling-slope:LEVEL]\n" \
+"                    [--trigger digital:HEX[,HEX...]] [--decimation 1:N] [--style simple|dithering|minmax|smoothing]\n" \
+"                    [--compress on|off] [--shots N | --seconds T]\n" \
+"  qwave-cli convert INPUT.vcd OUTPUT.vcd|OUTPUT.csv [--from TIME] [--to TIME]\n" \
+"TIME accepts ps, ns, us, ms and s suffixes, plain numbers are picoseconds.\n"
+
+/**
+ * @brief parseTime
+ * @param text time with optional unit suffix.
+ * @return returns time in picoseconds.
+ */
+static uint64_t parseTime(const QString & text)
+{
+    static const char* units[] = { "ps", "ns", "us", "ms", "s" };
+    uint64_t multiplier = 1;
+    QString number = text;
+    for(int i = 0; i < 5; ++i)
+    {
+        if(text.endsWith(units[i]))
+        {
+            number = text.left(text.length()-QString(units[i]).length());
+            break;
+        }
+        multiplier *= 1000;
+    }
+    if(number == text)
+        multiplier = 1;
+    bool ok;
+    double value = number.toDouble(&ok);
+    if(not ok or value < 0)
+        throw Exception("Wrong time: "+text);
+    return static_cast<uint64_t>(value*multiplier);
+}
+
+/**
+ * @brief parseTrigger fills trigger part of settings from "channel:type:level" or "digital:values".
+ * @param text
+ * @param settings
+ */
+static void parseTrigger(const QString & text, CaptureSettings & settings)
+{
+    QStringList parts = text.split(':');
+    settings.hasTrigger = true;
+    settings.triggerValues.clear();
+    if(parts.count() == 2 and parts.at(0) == "digital")
+    {
+        QStringList values = parts.at(1).split(',');
+        if(values.count() > FOUR_SAMPLES+1)
+            throw Exception("At most four digital trigger samples are supported.");
+        for(int i = 0; i < values.count(); ++i)
+        {
+            bool ok;
+            unsigned int value = values.at(i).toUInt(&ok, 16);
+            if(not ok or value > 0xFF)
+                throw Exception("Wrong digital trigger value: "+values.at(i));
+            settings.triggerValues.push_back(value);
+        }
+        settings.triggerKind = DIGITAL;
+        settings.triggerType = values.count()-1;
+        settings.triggerChannel = 0;
+        return;
+    }
+    if(parts.count() != 3 or (parts.at(0) != "analog1" and parts.at(0) != "analog2"))
+        throw Exception("Wrong trigger: "+text);
+    settings.triggerKind = ANALOG;
+    settings.triggerChannel = parts.at(0) == "analog1" ? 0 : 1;
+    if(parts.at(1) == "rising")
+        settings.triggerType = RISING;
+    else if(parts.at(1) == "falling")
+        settings.triggerType = FALLING;
+    else if(parts.at(1) == "rising-slope")
+        settings.triggerType = RISING_SLOPE;
+    else if(parts.at(1) == "falling-slope")
+        settings.triggerType = FALLING_SLOPE;
+    else
+        throw Exception("Wrong trigger type: "+parts.at(1));
+    bool ok;
+    unsigned int level = parts.at(2).toUInt(&ok);
+    if(not ok or level > 0xFF)
+        throw Exception("Wrong trigger level: "+parts.at(2));
+    settings.triggerValues.push_back(level);
+}
+
+/**
+ * @brief parseDecimation
+ * @param text ratio in form "1:N", where N is power of two up to 256.
+ * @return returns ratio base index used by devices.
+ */
+static int parseDecimation(const QString & text)
+{
+    int ratio = text.startsWith("1:") ? text.mid(2).toInt() : text.toInt();
+    for(int ratioBase = 0; ratioBase <= 8; ++ratioBase)
+    {
+        if(ratio == (1 << ratioBase))
+            return ratioBase;
+    }
+    throw Exception("Wrong decimation: "+text);
+}
+
+/**
+ * @brief parseStyle
+ * @param text
+ * @return returns decimation style constant.
+ */
+static int parseStyle(const QString & text)
+{
+    if(text == "simple")
+        return SIMPLE;
+    if(text == "dithering")
+        return DITHERING;
+    if(text == "minmax")
+        return MINMAX;
+    if(text == "smoothing")
+        return SMOOTHING;
+    throw Exception("Wrong decimation style: "+text);
+}
+
+/**
+ * @brief parseSwitch
+ * @param text "on" or "off".
+ * @return returns true for "on".
+ */
+static bool parseSwitch(const QString & text)
+{
+    if(text == "on")
+        return true;
+    if(text == "off")
+        return false;
+    throw Exception("Expected on or off: "+text);
+}
+
+/**
+ * @brief runCapture parses capture options and runs capture in event loop.
+ * @param app
+ * @param args
+ * @return returns exit code.
+ */
+static int runCapture(QApplication & app, const QStringList & args)
+{
+    CaptureSettings settings;
+    settings.device = "dummy";
+    settings.hasTrigger = false;
+    settings.triggerKind = ANALOG;
+    settings.triggerType = RISING;
+    settings.triggerChannel = 0;
+    settings.ratioBase = 0;
+    settings.style = SIMPLE;
+    settings.compressed = true;
+    settings.shots = 1;
+    settings.seconds = 0;
+    for(int i = 2; i < args.count(); ++i)
+    {
+        if(i+1 >= args.count())
+            throw Exception(USAGE);
+        QString option = args.at(i);
+        QString value = args.at(++i);
+        if(option == "--output")
+            settings.output = value;
+        else if(option == "--device")
+            settings.device = value;
+        else if(option == "--channel")
+            settings.channels << value;
+        else if(option == "--trigger")
+            parseTrigger(value, settings);
+        else if(option == "--decimation")
+            settings.ratioBase = parseDecimation(value);
+        else if(option == "--style")
+            settings.style = parseStyle(value);
+        else if(option == "--compress")
+            settings.compressed = parseSwitch(value);
+        else if(option == "--shots")
+            settings.shots = qMax(1, value.toInt());
+        else if(option == "--seconds")
+        {
+            bool ok;
+            settings.seconds = value.toDouble(&ok);
+            if(not ok or settings.seconds <= 0)
+                throw Exception("Wrong capture duration: "+value);
+        }
+        else
+            throw Exception(USAGE);
+    }
+    if(settings.output.isEmpty())
+        throw Exception(USAGE);
+    if(settings.channels.isEmpty())
+        settings.channels << "analog1";
+    CliCapture capture(settings);
+    capture.setup();
+    QTimer::singleShot(0, &capture, SLOT(start()));
+    return app.exec();
+}
+
+/**
+ * @brief runConvert loads VCD, optionally trims it and saves it as VCD or CSV.
+ * @param args
+ * @return returns exit code.
+ */
+static int runConvert(const QStringList & args)
+{
+    if(args.count() < 4)
+        throw Exception(USAGE);
+    uint64_t from = 0;
+    uint64_t to = UINT64_MAX;
+    bool trim = false;
+    for(int i = 4; i < args.count(); ++i)
+    {
+        if(i+1 < args.count() and args.at(i) == "--from")
+            from = parseTime(args.at(++i));
+        else if(i+1 < args.count() and args.at(i) == "--to")
+            to = parseTime(args.at(++i));
+        else
+            throw Exception(USAGE);
+        trim = true;
+    }
+    QTextStream err(stderr);
+    QElapsedTimer timer;
+    timer.start();
+    QFile input(args.at(2));
+    if(not input.open(QIODevice::ReadOnly | QIODevice::Text))
+        throw IOException("Could not open file: "+args.at(2));
+    PlotTreeModel model;
+    FileSplitter splitter(&input);
+    model.loadFromFile(splitter);
+    double loaded = timer.nsecsElapsed()/1E9;
+    err << "loaded " << args.at(2) << " in " << loaded << " s" << endl;
+    if(trim)
+    {
+        model.trim(from, to);
+        err << "trimmed to [" << from << ", " << (to == UINT64_MAX ? QString("end") : QString::number(to)) << "] ps" << endl;
+    }
+    QFile output(args.at(3));
+    if(not output.open(QIODevice::WriteOnly | QIODevice::Text))
+        throw IOException("Could not open file: "+args.at(3));
+    if(QFileInfo(args.at(3)).suffix().toLower() == "csv")
+        model.saveToCsv(&output);
+    else
+        model.saveToFile(&output);
+    output.close();
+    double seconds = timer.nsecsElapsed()/1E9;
+    double megabytes = (input.size()+output.size())/1E6;
+    err << "written " << args.at(3) << ", total " << seconds << " s, "
+        << (seconds > 0 ? megabytes/seconds : 0) << " MB/s" << endl;
+    return 0;
+}
+
+/**
+ * @brief main dispatches capture and convert commands, see USAGE.
+ * @param argc
+ * @param argv
+ * @return
+ */
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv, false);
+    QStringList args = app.arguments();
+    try
+    {
+        if(args.count() > 1 and args.at(1) == "capture")
+            return runCapture(app, args);
+        if(args.count() > 1 and args.at(1) == "convert")
+            return runConvert(args);
+        QTextStream(stderr) << USAGE;
+        return 1;
+    }
+    catch (Exception e)
+    {
+        QTextStream(stderr) << e.getMessage() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,80 @@
+#-------------------------------------------------
+#
+# Widget free sources: data model, devices and capture
+#
+#-------------------------------------------------
+
+INCLUDEPATH += $$PWD /opt/local/include
+LIBS += -L/opt/local/lib -lftdi
+
+SOURCES += \
+    $$PWD/Datamodel/PlotTreeModel.cpp \
+    $$PWD/Datamodel/PlotTreeItem.cpp \
+    $$PWD/Datamodel/PlotData.cpp \
+    $$PWD/Datamodel/ChunkPool.cpp \
+    $$PWD/Datamodel/SampleBuffer.cpp \
+    $$PWD/Datamodel/BlockCodec.cpp \
+    $$PWD/Datamodel/BlockCache.cpp \
+    $$PWD/Datamodel/MemoryManager.cpp \
+    $$PWD/Datamodel/StringPool.cpp \
+    $$PWD/Datamodel/LoadJob.cpp \
+    $$PWD/Datamodel/FileSplitter.cpp \
+    $$PWD/Datamodel/Measurements.cpp \
+    $$PWD/Datamodel/Fft.cpp \
+    $$PWD/Datamodel/SpectrumAnalyzer.cpp \
+    $$PWD/Datamodel/PatternSearch.cpp \
+    $$PWD/Datamodel/MathChannel.cpp \
+    $$PWD/Datamodel/Statistics.cpp \
+    $$PWD/Datamodel/EyeDiagram.cpp \
+    $$PWD/Datamodel/CaptureComparator.cpp \
+    $$PWD/Datamodel/MaskTest.cpp \
+    $$PWD/Decoders/Decoder.cpp \
+    $$PWD/Decoders/UartDecoder.cpp \
+    $$PWD/Decoders/SpiDecoder.cpp \
+    $$PWD/Decoders/I2cDecoder.cpp \
+    $$PWD/Device/DummyDevice.cpp \
+    $$PWD/Device/CaptureController.cpp \
+    $$PWD/Device/SoftwareTrigger.cpp \
+    $$PWD/Device/ft245sync.cpp \
+    $$PWD/Device/Ft245Device.cpp \
+    $$PWD/Instrumentation/Profiler.cpp
+
+HEADERS  += \
+    $$PWD/Exceptions/IOException.h \
+    $$PWD/Exceptions/Exception.h \
+    $$PWD/Exceptions/DeviceException.h \
+    $$PWD/Datamodel/PlotTreeModel.h \
+    $$PWD/Datamodel/PlotTreeItem.h \
+    $$PWD/Datamodel/PlotData.h \
+    $$PWD/Datamodel/ChunkPool.h \
+    $$PWD/Datamodel/SampleBuffer.h \
+    $$PWD/Datamodel/BlockCodec.h \
+    $$PWD/Datamodel/BlockCache.h \
+    $$PWD/Datamodel/MemoryManager.h \
+    $$PWD/Datamodel/StringPool.h \
+    $$PWD/Datamodel/LoadJob.h \
+    $$PWD/Datamodel/Constants.h \
+    $$PWD/Datamodel/FileSplitter.h \
+    $$PWD/Datamodel/Measurements.h \
+    $$PWD/Datamodel/SampleScan.h \
+    $$PWD/Datamodel/Fft.h \
+    $$PWD/Datamodel/SpectrumAnalyzer.h \
+    $$PWD/Datamodel/PatternSearch.h \
+    $$PWD/Datamodel/MathChannel.h \
+    $$PWD/Datamodel/Statistics.h \
+    $$PWD/Datamodel/EyeDiagram.h \
+    $$PWD/Datamodel/CaptureComparator.h \
+    $$PWD/Datamodel/MaskTest.h \
+    $$PWD/Decoders/Decoder.h \
+    $$PWD/Decoders/UartDecoder.h \
+    $$PWD/Decoders/SpiDecoder.h \
+    $$PWD/Decoders/I2cDecoder.h \
+    $$PWD/Device/DeviceController.h \
+    $$PWD/Device/AbstractDevice.h \
+    $$PWD/Device/DummyDevice.h \
+    $$PWD/Device/Ft245Device.h \
+    $$PWD/Device/Capabilities.h \
+    $$PWD/Device/CaptureController.h \
+    $$PWD/Device/SoftwareTrigger.h \
+    $$PWD/Device/ft245sync.h \
+    $$PWD/Instrumentation/Profiler.h
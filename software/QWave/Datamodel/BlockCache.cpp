@@ -0,0 +1,110 @@
+//
+//   BlockCache.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "BlockCache.h"
+#include "SampleBuffer.h"
+#include "ChunkPool.h"
+#include <QThreadStorage>
+
+BlockCache::BlockCache() : count(0), clock(0)
+{
+}
+
+BlockCache::~BlockCache()
+{
+    for(int i = 0; i < count; ++i)
+    {
+        ChunkPool::instance().release(blocks[i].samples);
+    }
+}
+
+/**
+ * @brief BlockCache::get loads chunk unless it is in cache of current thread.
+ * @param bufferId id of buffer, unique for its whole life.
+ * @param bitNumber
+ * @param chunk index of chunk in bit.
+ * @param source buffer loading chunk.
+ * @param stamp if not NULL returns stamp of block, which changes when block is reused.
+ * @return returns CHUNK_SIZE samples.
+ */
+const unsigned char * BlockCache::get(int bufferId, int bitNumber, int chunk, const SampleBuffer * source, const uint64_t ** stamp)
+{
+    static QThreadStorage<BlockCache *> caches;
+    if(not caches.hasLocalData())
+    {
+        caches.setLocalData(new BlockCache());
+    }
+    return caches.localData()->find(bufferId, bitNumber, chunk, source, stamp);
+}
+
+/**
+ * @brief BlockCache::find looks for chunk in cache,
+ * least recently used block is reused when cache is full.
+ */
+const unsigned char * BlockCache::find(int bufferId, int bitNumber, int chunk, const SampleBuffer * source, const uint64_t ** stamp)
+{
+    ++clock;
+    int oldest = 0;
+    for(int i = 0; i < count; ++i)
+    {
+        Block & block = blocks[i];
+        if(block.chunk == chunk and block.bitNumber == bitNumber and block.bufferId == bufferId)
+        {
+            block.used = clock;
+            if(stamp != NULL)
+            {
+                *stamp = &block.loaded;
+            }
+            return block.samples;
+        }
+        if(block.used < blocks[oldest].used)
+        {
+            oldest = i;
+        }
+    }
+    if(count < CACHE_BLOCKS)
+    {
+        oldest = count++;
+        blocks[oldest].samples = ChunkPool::instance().acquire();
+    }
+    Block & block = blocks[oldest];
+    block.bufferId = bufferId;
+    block.bitNumber = bitNumber;
+    block.chunk = chunk;
+    block.used = clock;
+    block.loaded = clock;
+    source->loadChunk(bitNumber, chunk, block.samples);
+    if(stamp != NULL)
+    {
+        *stamp = &block.loaded;
+    }
+    return block.samples;
+}
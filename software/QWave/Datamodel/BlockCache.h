@@ -0,0 +1,72 @@
+//
+//   BlockCache.h
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef QWave_BlockCache_h
+#define QWave_BlockCache_h
+
+#include <inttypes.h>
+
+class SampleBuffer;
+
+/**
+ * @brief The BlockCache class keeps recently loaded chunks of sample buffers, which are
+ * packed or spilled to disk.
+ * Every thread has its own cache, so threads never evict blocks other thread reads.
+ * Returned samples stay valid until the same thread loads CACHE_BLOCKS other chunks.
+ * Blocks never move, so reader holding samples can check stamp of their block
+ * to see if they were not reused, without looking up the cache again.
+ */
+class BlockCache
+{
+    struct Block
+    {
+        int bufferId;
+        int bitNumber;
+        int chunk;
+        unsigned char * samples;
+        uint64_t used;
+        uint64_t loaded;
+    };
+public:
+    static const int CACHE_BLOCKS = 8;
+private:
+    Block blocks[CACHE_BLOCKS];
+    int count;
+    uint64_t clock;
+    const unsigned char * find(int bufferId, int bitNumber, int chunk, const SampleBuffer * source, const uint64_t ** stamp);
+public:
+    BlockCache();
+    ~BlockCache();
+    static const unsigned char * get(int bufferId, int bitNumber, int chunk, const SampleBuffer * source, const uint64_t ** stamp = 0);
+};
+
+#endif
@@ -0,0 +1,211 @@
+//
+//   BlockCodec.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "BlockCodec.h"
+#include <stdint.h>
+#include <QtGlobal>
+#include <string.h>
+
+// header of group holds width of values in low bits and their kind in high bits
+static const unsigned char WIDTH_MASK = 0x0f;
+enum GroupKind { Delta = 0x00, Reference = 0x10, Slope = 0x20 };
+
+/**
+ * @brief bitsNeeded
+ * @return returns number of bits needed to store value.
+ */
+static int bitsNeeded(unsigned char value)
+{
+    int width = 0;
+    while(value >> width)
+    {
+        ++width;
+    }
+    return width;
+}
+
+/**
+ * @brief zigzag maps small signed difference to small unsigned value.
+ */
+static unsigned char zigzag(unsigned char difference)
+{
+    int value = static_cast<signed char>(difference);
+    return static_cast<unsigned char>((static_cast<unsigned>(value) << 1) ^ (value < 0 ? 0xff : 0));
+}
+
+/**
+ * @brief unzigzag reverses zigzag.
+ */
+static unsigned char unzigzag(uint32_t value)
+{
+    return static_cast<unsigned char>((value >> 1) ^ (0u-(value & 1)));
+}
+
+/**
+ * @brief packBits appends GROUP_SIZE values of given width to packed, GROUP_SIZE*width
+ * is whole number of bytes, so nothing is left in bits.
+ */
+static void packBits(QByteArray & packed, const unsigned char * values, int width)
+{
+    uint32_t bits = 0;
+    int count = 0;
+    for(int i = 0; i < BlockCodec::GROUP_SIZE; ++i)
+    {
+        bits |= static_cast<uint32_t>(values[i]) << count;
+        count += width;
+        while(count >= 8)
+        {
+            packed.append(static_cast<char>(bits & 0xff));
+            bits >>= 8;
+            count -= 8;
+        }
+    }
+}
+
+/**
+ * @brief BlockCodec::pack packs every group in kind needing least bits: deltas from
+ * previous sample suit steps and flat parts, deltas from line through two previous
+ * samples suit smooth signals and offsets from smallest sample of group suit noisy
+ * signals changing slowly.
+ * @param samples CHUNK_SIZE samples to pack.
+ * @return returns packed samples.
+ */
+QByteArray BlockCodec::pack(const unsigned char * samples)
+{
+    QByteArray packed;
+    packed.reserve(CHUNK_SIZE/2);
+    unsigned char previous = 0;
+    unsigned char beforePrevious = 0;
+    unsigned char deltas[GROUP_SIZE];
+    unsigned char slopes[GROUP_SIZE];
+    unsigned char offsets[GROUP_SIZE];
+    for(size_t group = 0; group < CHUNK_SIZE; group += GROUP_SIZE)
+    {
+        const unsigned char * values = samples+group;
+        unsigned char widestDelta = 0;
+        unsigned char widestSlope = 0;
+        unsigned char lowest = values[0];
+        unsigned char highest = values[0];
+        for(int i = 0; i < GROUP_SIZE; ++i)
+        {
+            deltas[i] = zigzag(values[i]-previous);
+            slopes[i] = zigzag(values[i]-(2*previous-beforePrevious));
+            widestDelta |= deltas[i];
+            widestSlope |= slopes[i];
+            lowest = qMin(lowest, values[i]);
+            highest = qMax(highest, values[i]);
+            beforePrevious = previous;
+            previous = values[i];
+        }
+        int deltaWidth = bitsNeeded(widestDelta);
+        int slopeWidth = bitsNeeded(widestSlope);
+        int offsetWidth = bitsNeeded(highest-lowest);
+        // offsets cost one more byte for smallest sample
+        if(offsetWidth*GROUP_SIZE/8+1 < qMin(deltaWidth, slopeWidth)*GROUP_SIZE/8)
+        {
+            for(int i = 0; i < GROUP_SIZE; ++i)
+            {
+                offsets[i] = values[i]-lowest;
+            }
+            packed.append(static_cast<char>(Reference | offsetWidth));
+            packed.append(static_cast<char>(lowest));
+            packBits(packed, offsets, offsetWidth);
+        }
+        else if(slopeWidth < deltaWidth)
+        {
+            packed.append(static_cast<char>(Slope | slopeWidth));
+            packBits(packed, slopes, slopeWidth);
+        }
+        else
+        {
+            packed.append(static_cast<char>(Delta | deltaWidth));
+            packBits(packed, deltas, deltaWidth);
+        }
+    }
+    packed.squeeze();
+    return packed;
+}
+
+/**
+ * @brief BlockCodec::unpack
+ * @param packed samples packed by pack.
+ * @param samples filled with CHUNK_SIZE samples.
+ */
+void BlockCodec::unpack(const QByteArray & packed, unsigned char * samples)
+{
+    const unsigned char * in = reinterpret_cast<const unsigned char *>(packed.constData());
+    unsigned char previous = 0;
+    unsigned char beforePrevious = 0;
+    for(size_t group = 0; group < CHUNK_SIZE; group += GROUP_SIZE)
+    {
+        unsigned char header = *in++;
+        int width = header & WIDTH_MASK;
+        int kind = header & ~WIDTH_MASK;
+        unsigned char lowest = kind == Reference ? *in++ : 0;
+        if(width == 0 and kind != Slope)
+        {
+            beforePrevious = kind == Reference ? lowest : previous;
+            previous = beforePrevious;
+            memset(samples+group, previous, GROUP_SIZE*sizeof(unsigned char));
+            continue;
+        }
+        uint32_t mask = (1u << width)-1;
+        uint32_t bits = 0;
+        int count = 0;
+        for(int i = 0; i < GROUP_SIZE; ++i)
+        {
+            while(count < width)
+            {
+                bits |= static_cast<uint32_t>(*in++) << count;
+                count += 8;
+            }
+            uint32_t value = bits & mask;
+            bits >>= width;
+            count -= width;
+            unsigned char sample;
+            if(kind == Reference)
+            {
+                sample = lowest+value;
+            }
+            else if(kind == Slope)
+            {
+                sample = 2*previous-beforePrevious+unzigzag(value);
+            }
+            else
+            {
+                sample = previous+unzigzag(value);
+            }
+            beforePrevious = previous;
+            previous = sample;
+            samples[group+i] = sample;
+        }
+    }
+}
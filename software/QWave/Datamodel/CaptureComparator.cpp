@@ -0,0 +1,287 @@
+//
+//   CaptureComparator.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#define __STDC_LIMIT_MACROS
+
+#include <stdint.h>
+#include <limits.h>
+#include "CaptureComparator.h"
+#include "PatternSearch.h"
+#include <QtConcurrentMap>
+#include <QtAlgorithms>
+#include <string.h>
+
+static const size_t COMPARE_CHUNK = 64;
+
+/**
+ * @brief CaptureComparator::clear forgets result of last comparison.
+ */
+void CaptureComparator::clear()
+{
+    comparisons.clear();
+    comparisonByData.clear();
+    unmatched.clear();
+    differences.clear();
+}
+
+/**
+ * @brief CaptureComparator::pair adds comparison of two signals if they can be compared sample by sample.
+ * @return returns false if signals differ in type, width or sample period.
+ */
+bool CaptureComparator::pair(const QString & path, PlotData * reference, PlotData * compared, int64_t offset)
+{
+    if(reference->getType() != compared->getType() or reference->getBitwidth() != compared->getBitwidth()
+       or reference->getDiv() != compared->getDiv() or compared->getDiv() == 0)
+        return false;
+    SignalComparison comparison;
+    comparison.path = path;
+    comparison.reference = reference;
+    comparison.compared = compared;
+    int64_t div = static_cast<int64_t>(compared->getDiv());
+    comparison.offset = offset >= 0 ? (offset+div/2)/div : -((div/2-offset)/div);
+    comparison.differentSamples = 0;
+    comparison.truncated = false;
+    comparisons.append(comparison);
+    return true;
+}
+
+/**
+ * @brief CaptureComparator::compare compares all signals of compared capture with their pairs in reference capture.
+ * @param reference data of reference capture by path.
+ * @param compared data of compared capture by path.
+ * @param offset in ps, sample at time t of compared capture is compared with sample at time t+offset of reference.
+ */
+void CaptureComparator::compare(const QMap<QString, PlotData*> & reference, const QMap<QString, PlotData*> & compared, int64_t offset)
+{
+    clear();
+    QMap<QString, PlotData*> unpairedReference = reference;
+    QMap<QString, PlotData*> unpairedCompared;
+    for(QMap<QString, PlotData*>::const_iterator it = compared.constBegin(); it != compared.constEnd(); ++it)
+    {
+        if(reference.contains(it.key()) and pair(it.key(), reference.value(it.key()), it.value(), offset))
+            unpairedReference.remove(it.key());
+        else
+            unpairedCompared.insert(it.key(), it.value());
+    }
+    // captures from different sources have different scopes, pair rest by name when it's unique
+    QMap<QString, int> nameCount;
+    QMap<QString, QString> pathByName;
+    for(QMap<QString, PlotData*>::const_iterator it = unpairedReference.constBegin(); it != unpairedReference.constEnd(); ++it)
+    {
+        ++nameCount[it.value()->getName()];
+        pathByName.insert(it.value()->getName(), it.key());
+    }
+    for(QMap<QString, PlotData*>::const_iterator it = unpairedCompared.constBegin(); it != unpairedCompared.constEnd(); ++it)
+    {
+        const QString & name = it.value()->getName();
+        if(nameCount.value(name) == 1 and pair(it.key(), unpairedReference.value(pathByName.value(name)), it.value(), offset))
+        {
+            unpairedReference.remove(pathByName.value(name));
+            nameCount.remove(name);
+        }
+        else
+            unmatched << it.key();
+    }
+    unmatched += unpairedReference.keys();
+    QtConcurrent::blockingMap(comparisons, &CaptureComparator::compareSignal);
+    for(int i = 0; i < comparisons.size(); ++i)
+    {
+        comparisonByData.insert(comparisons.at(i).compared, i);
+        uint64_t div = comparisons.at(i).compared->getDiv();
+        for(int j = 0; j < comparisons.at(i).ranges.size(); ++j)
+        {
+            differences.append(qMakePair(comparisons.at(i).ranges.at(j).first*div, i));
+        }
+    }
+    qSort(differences);
+}
+
+/**
+ * @brief CaptureComparator::compareSignal finds ranges where any bit of signals differs.
+ * Chunk of samples is compared as 64 bit words of all bits first, only chunk containing
+ * difference or crossing boundary of stored chunks is walked sample by sample.
+ * @param comparison
+ */
+void CaptureComparator::compareSignal(SignalComparison & comparison)
+{
+    int bits = comparison.compared->getBitwidth();
+    size_t comparedLength = SIZE_MAX;
+    size_t referenceLength = SIZE_MAX;
+    QVector<BitSamples> comparedBits;
+    QVector<BitSamples> referenceBits;
+    for(int bit = 0; bit < bits; ++bit)
+    {
+        comparedLength = qMin(comparedLength, comparison.compared->lastPositionOnBit(bit));
+        referenceLength = qMin(referenceLength, comparison.reference->lastPositionOnBit(bit));
+        comparedBits.append(comparison.compared->getSamples(bit));
+        referenceBits.append(comparison.reference->getSamples(bit));
+    }
+    int64_t offset = comparison.offset;
+    size_t from = offset < 0 ? static_cast<size_t>(-offset) : 0;
+    int64_t overlapEnd = qMin(static_cast<int64_t>(comparedLength), static_cast<int64_t>(referenceLength)-offset);
+    size_t to = overlapEnd > static_cast<int64_t>(from) ? static_cast<size_t>(overlapEnd) : from;
+    bool inRange = false;
+    size_t rangeStart = 0;
+    for(size_t i = from; i < to; i += COMPARE_CHUNK)
+    {
+        size_t end = qMin(to, i+COMPARE_CHUNK);
+        uint64_t difference = 0;
+        if(end-i == COMPARE_CHUNK)
+        {
+            for(int bit = 0; bit < bits and difference == 0; ++bit)
+            {
+                size_t lengthA;
+                size_t lengthB;
+                const unsigned char * a = comparison.compared->getRun(bit, i, lengthA);
+                const unsigned char * b = comparison.reference->getRun(bit, i+offset, lengthB);
+                if(lengthA < COMPARE_CHUNK or lengthB < COMPARE_CHUNK)
+                { // chunk spans end of stored chunk, it is walked sample by sample
+                    difference = 1;
+                    continue;
+                }
+                for(size_t j = 0; j < COMPARE_CHUNK; j += sizeof(uint64_t))
+                {
+                    uint64_t wordA;
+                    uint64_t wordB;
+                    memcpy(&wordA, a+j, sizeof(uint64_t));
+                    memcpy(&wordB, b+j, sizeof(uint64_t));
+                    difference |= wordA ^ wordB;
+                }
+            }
+        }
+        else
+            difference = 1;
+        if(difference == 0)
+        {
+            if(inRange)
+            {
+                comparison.ranges.append(qMakePair(rangeStart, i));
+                inRange = false;
+            }
+            continue;
+        }
+        for(size_t j = i; j < end; ++j)
+        {
+            int different = 0;
+            for(int bit = 0; bit < bits; ++bit)
+            {
+                different |= comparedBits.at(bit)[j] ^ referenceBits.at(bit)[j+offset];
+            }
+            if(different)
+            {
+                ++comparison.differentSamples;
+                if(not inRange)
+                {
+                    rangeStart = j;
+                    inRange = true;
+                }
+            }
+            else if(inRange)
+            {
+                comparison.ranges.append(qMakePair(rangeStart, j));
+                inRange = false;
+            }
+        }
+        if(comparison.ranges.size() >= MAX_RANGES)
+        {
+            comparison.truncated = true;
+            return;
+        }
+    }
+    if(inRange)
+        comparison.ranges.append(qMakePair(rangeStart, to));
+}
+
+/**
+ * @brief CaptureComparator::getRanges
+ * @param compared
+ * @return returns ranges of differences of compared data or NULL if they weren't compared.
+ */
+const QVector<QPair<size_t, size_t> > * CaptureComparator::getRanges(PlotData * compared)
+{
+    if(not comparisonByData.contains(compared))
+        return NULL;
+    return &comparisons.at(comparisonByData.value(compared)).ranges;
+}
+
+/**
+ * @brief CaptureComparator::findNext finds first difference starting after time.
+ * @param time in ps.
+ * @param found time of found difference.
+ * @param comparison index of comparison where difference was found.
+ * @return returns false if there is no such difference.
+ */
+bool CaptureComparator::findNext(uint64_t time, uint64_t & found, int & comparison)
+{
+    QVector<QPair<uint64_t, int> >::const_iterator it = qUpperBound(differences.constBegin(), differences.constEnd(), qMakePair(time, INT_MAX));
+    if(it == differences.constEnd())
+        return false;
+    found = it->first;
+    comparison = it->second;
+    return true;
+}
+
+/**
+ * @brief CaptureComparator::findPrevious finds last difference starting before time.
+ * @param time in ps.
+ * @param found time of found difference.
+ * @param comparison index of comparison where difference was found.
+ * @return returns false if there is no such difference.
+ */
+bool CaptureComparator::findPrevious(uint64_t time, uint64_t & found, int & comparison)
+{
+    QVector<QPair<uint64_t, int> >::const_iterator it = qLowerBound(differences.constBegin(), differences.constEnd(), qMakePair(time, 0));
+    if(it == differences.constBegin())
+        return false;
+    --it;
+    found = it->first;
+    comparison = it->second;
+    return true;
+}
+
+/**
+ * @brief CaptureComparator::findPatternTime finds first match of pattern, used to align captures.
+ * @param data logic data to search.
+ * @param pattern pattern in syntax of PatternSearch, its last character is lowest bit of data.
+ * @param time time of match in ps.
+ * @return returns false if pattern is invalid or doesn't match.
+ */
+bool CaptureComparator::findPatternTime(PlotData * data, const QString & pattern, uint64_t & time)
+{
+    PatternSearch search;
+    if(not search.setPattern(pattern))
+        return false;
+    search.search(data);
+    if(search.getHits().isEmpty())
+        return false;
+    time = search.getHits().first()*data->getDiv();
+    return true;
+}
@@ -0,0 +1,82 @@
+//
+//   CaptureComparator.h
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef QWave_CaptureComparator_h
+#define QWave_CaptureComparator_h
+
+#include <QVector>
+#include <QMap>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include "PlotData.h"
+
+/**
+ * @brief The CaptureComparator class compares signals of two captures and finds ranges
+ * where they differ. Signals are paired by path in tree of scopes, or by name when path doesn't match.
+ * Samples of every bit are compared by XOR of 64 bit words, signals are compared in parallel.
+ * Ranges are in samples of compared capture, reference capture is shifted by offset.
+ */
+class CaptureComparator
+{
+public:
+    struct SignalComparison
+    {
+        QString path;
+        PlotData * reference;
+        PlotData * compared;
+        int64_t offset;
+        QVector<QPair<size_t, size_t> > ranges;
+        uint64_t differentSamples;
+        bool truncated;
+    };
+    static const int MAX_RANGES = 1 << 16;
+    CaptureComparator() {}
+    void compare(const QMap<QString, PlotData*> & reference, const QMap<QString, PlotData*> & compared, int64_t offset);
+    void clear();
+    bool isEmpty() { return comparisons.isEmpty(); }
+    const QVector<SignalComparison> & getComparisons() { return comparisons; }
+    const QVector<QPair<size_t, size_t> > * getRanges(PlotData * compared);
+    const QStringList & getUnmatched() { return unmatched; }
+    int getDifferenceCount() { return differences.size(); }
+    bool findNext(uint64_t time, uint64_t & found, int & comparison);
+    bool findPrevious(uint64_t time, uint64_t & found, int & comparison);
+    static bool findPatternTime(PlotData * data, const QString & pattern, uint64_t & time);
+private:
+    QVector<SignalComparison> comparisons;
+    QMap<PlotData*, int> comparisonByData;
+    QStringList unmatched;
+    QVector<QPair<uint64_t, int> > differences;
+    bool pair(const QString & path, PlotData * reference, PlotData * compared, int64_t offset);
+    static void compareSignal(SignalComparison & comparison);
+};
+
+#endif
@@ -0,0 +1,175 @@
+//
+//   ChunkPool.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "ChunkPool.h"
+#include "../Exceptions/Exception.h"
+#include <QMutexLocker>
+#include <stdlib.h>
+
+static const int DEFAULT_MAX_FREE_CHUNKS = 1024;
+
+ChunkPool::ChunkPool() : maxFree(DEFAULT_MAX_FREE_CHUNKS), used(0)
+{
+}
+
+ChunkPool::~ChunkPool()
+{
+    shrink();
+}
+
+/**
+ * @brief ChunkPool::instance
+ * @return returns application wide pool of sample chunks.
+ */
+ChunkPool & ChunkPool::instance()
+{
+    static ChunkPool pool;
+    return pool;
+}
+
+/**
+ * @brief ChunkPool::acquire takes chunk of CHUNK_SIZE bytes from pool,
+ * heap is used only when pool is empty. Content of chunk is undefined.
+ * @return returns chunk.
+ */
+unsigned char * ChunkPool::acquire()
+{
+    QMutexLocker locker(&mutex);
+    unsigned char * chunk;
+    if(freeChunks.isEmpty())
+    {
+        chunk = static_cast<unsigned char*>(malloc(CHUNK_SIZE));
+        if(chunk == NULL)
+        {
+            throw Exception("Cannot allocate memory.");
+        }
+    }
+    else
+    {
+        chunk = freeChunks.last();
+        freeChunks.pop_back();
+    }
+    ++used;
+    return chunk;
+}
+
+/**
+ * @brief ChunkPool::releaseLocked returns chunk to pool or to heap when pool is full.
+ * Mutex has to be held by caller.
+ * @param chunk
+ */
+void ChunkPool::releaseLocked(unsigned char * chunk)
+{
+    --used;
+    if(freeChunks.count() < maxFree)
+    {
+        freeChunks.append(chunk);
+    }
+    else
+    {
+        free(chunk);
+    }
+}
+
+/**
+ * @brief ChunkPool::release returns chunk obtained by acquire.
+ * @param chunk
+ */
+void ChunkPool::release(unsigned char * chunk)
+{
+    QMutexLocker locker(&mutex);
+    releaseLocked(chunk);
+}
+
+/**
+ * @brief ChunkPool::release returns all chunks of buffer at once.
+ * NULL entries, like chunks of buffer stored elsewhere, are skipped.
+ * @param chunks
+ */
+void ChunkPool::release(const QVector<unsigned char *> & chunks)
+{
+    QMutexLocker locker(&mutex);
+    for(int i = 0; i < chunks.count(); ++i)
+    {
+        if(chunks.at(i) != NULL)
+        {
+            releaseLocked(chunks.at(i));
+        }
+    }
+}
+
+/**
+ * @brief ChunkPool::setMaxFree sets how many unused chunks are kept for reuse.
+ * @param count
+ */
+void ChunkPool::setMaxFree(int count)
+{
+    QMutexLocker locker(&mutex);
+    maxFree = count;
+    while(freeChunks.count() > maxFree)
+    {
+        free(freeChunks.last());
+        freeChunks.pop_back();
+    }
+}
+
+/**
+ * @brief ChunkPool::shrink gives all unused chunks back to heap.
+ */
+void ChunkPool::shrink()
+{
+    QMutexLocker locker(&mutex);
+    for(int i = 0; i < freeChunks.count(); ++i)
+    {
+        free(freeChunks.at(i));
+    }
+    freeChunks.clear();
+}
+
+/**
+ * @brief ChunkPool::getUsedBytes
+ * @return returns memory held by sample buffers.
+ */
+size_t ChunkPool::getUsedBytes()
+{
+    QMutexLocker locker(&mutex);
+    return used*CHUNK_SIZE;
+}
+
+/**
+ * @brief ChunkPool::getFreeBytes
+ * @return returns memory kept in pool for reuse.
+ */
+size_t ChunkPool::getFreeBytes()
+{
+    QMutexLocker locker(&mutex);
+    return freeChunks.count()*CHUNK_SIZE;
+}
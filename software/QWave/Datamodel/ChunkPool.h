@@ -0,0 +1,73 @@
+//
+//   ChunkPool.h
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef QWave_ChunkPool_h
+#define QWave_ChunkPool_h
+
+#include <QVector>
+#include <QMutex>
+#include <stddef.h>
+
+static const int CHUNK_BITS = 16;
+static const size_t CHUNK_SIZE = static_cast<size_t>(1) << CHUNK_BITS;
+static const size_t CHUNK_MASK = CHUNK_SIZE-1;
+
+/**
+ * @brief The ChunkPool class hands out fixed size blocks of sample memory.
+ * Sample buffers are built from these chunks, so they never move once
+ * written. Chunks of freed captures stay in the pool, up to a limit,
+ * and are reused by the next run instead of going back to the heap.
+ */
+class ChunkPool
+{
+public:
+    static ChunkPool & instance();
+    unsigned char * acquire();
+    void release(unsigned char * chunk);
+    void release(const QVector<unsigned char *> & chunks);
+    void setMaxFree(int count);
+    void shrink();
+    size_t getUsedBytes();
+    size_t getFreeBytes();
+private:
+    ChunkPool();
+    ~ChunkPool();
+    ChunkPool(const ChunkPool &);
+    ChunkPool & operator=(const ChunkPool &);
+    void releaseLocked(unsigned char * chunk);
+    QMutex mutex;
+    QVector<unsigned char *> freeChunks;
+    int maxFree;
+    size_t used;
+};
+
+#endif
@@ -0,0 +1,231 @@
+//
+//   EyeDiagram.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "EyeDiagram.h"
+#include "SampleScan.h"
+#include "Constants.h"
+#include <QtAlgorithms>
+#include <math.h>
+
+/**
+ * @brief EyeDiagram::EyeDiagram
+ * @param source
+ * @param period bit period in ps, 0 means it is recovered from data.
+ * @param parent
+ */
+EyeDiagram::EyeDiagram(PlotData * source, double period, QObject * parent) :
+    QObject(parent), source(source), period(period), version(0)
+{
+    reset();
+}
+
+/**
+ * @brief EyeDiagram::setPeriod sets bit period and refolds all data.
+ * @param period bit period in ps, 0 means it is recovered from data.
+ */
+void EyeDiagram::setPeriod(double period)
+{
+    this->period = period;
+    reset();
+    update();
+}
+
+/**
+ * @brief EyeDiagram::reset clears density, all data are folded again on next update.
+ */
+void EyeDiagram::reset()
+{
+    unitInterval = period;
+    position = 0;
+    density.fill(0, COLUMNS*ROWS);
+    maximum = 0;
+    samples = 0;
+    ++version;
+}
+
+/**
+ * @brief EyeDiagram::findCrossings finds crossings of threshold, logic data cross when they become
+ * or stop being HIGH, analog data when they leave band of hysteresis around threshold.
+ * @return returns number of found crossings.
+ */
+int EyeDiagram::findCrossings(const BitSamples & data, size_t from, size_t to, QVector<size_t> & crossings, int maxCount)
+{
+    bool analog = source->getType() == PlotData::Linear;
+    int high = analog ? ANALOG_THRESHOLD+ANALOG_HYSTERESIS : HIGH;
+    int low = analog ? ANALOG_THRESHOLD-ANALOG_HYSTERESIS : HIGH-1;
+    size_t i = findFirst(data, from, to, Outside(low+1, high-1));
+    if(i == to)
+        return 0;
+    bool state = data[i] >= high;
+    while(crossings.size() < maxCount)
+    {
+        i = state ? findFirst(data, i, to, AtMost(low)) : findFirst(data, i, to, AtLeast(high));
+        if(i == to)
+            break;
+        crossings.append(i);
+        state = not state;
+    }
+    return crossings.size();
+}
+
+/**
+ * @brief EyeDiagram::getCrossingPosition
+ * @param crossing sample where crossing was found.
+ * @return returns position of crossing with fraction of sample, analog data are interpolated
+ * between samples on both sides of threshold, logic data cross in middle between samples.
+ */
+double EyeDiagram::getCrossingPosition(const BitSamples & data, size_t from, size_t crossing)
+{
+    if(source->getType() != PlotData::Linear or crossing == 0)
+        return crossing-0.5;
+    bool rising = data[crossing] >= ANALOG_THRESHOLD;
+    size_t i = crossing;
+    while(i > from and i > 1 and (data[i-1] >= ANALOG_THRESHOLD) == rising)
+        --i;
+    int before = data[i-1];
+    int after = data[i];
+    if(before == after)
+        return i-0.5;
+    return i-1+static_cast<double>(ANALOG_THRESHOLD-before)/(after-before);
+}
+
+/**
+ * @brief EyeDiagram::recoverUnitInterval estimates bit period from crossings. Short distance
+ * which isn't glitch is taken as first estimate, then every distance is divided into whole
+ * number of bits and period is slope of line fitted through crossings over bit numbers.
+ * @return returns false if data don't contain enough crossings yet.
+ */
+bool EyeDiagram::recoverUnitInterval(const BitSamples & data, size_t from, size_t to)
+{
+    QVector<size_t> crossings;
+    if(findCrossings(data, from, to, crossings, RECOVERY_EDGES) < 3)
+        return false;
+    QVector<size_t> distances;
+    for(int i = 1; i < crossings.size(); ++i)
+    {
+        distances.append(crossings.at(i)-crossings.at(i-1));
+    }
+    qSort(distances);
+    double shortest = distances.at(distances.size()/20);
+    if(shortest < 2)
+        return false;
+    double bit = 0;
+    double sumX = 0;
+    double sumY = 0;
+    double sumXX = 0;
+    double sumXY = 0;
+    for(int i = 0; i < crossings.size(); ++i)
+    {
+        if(i > 0)
+            bit += qMax(1.0, floor((crossings.at(i)-crossings.at(i-1))/shortest+0.5));
+        double y = getCrossingPosition(data, from, crossings.at(i))-crossings.first();
+        sumX += bit;
+        sumY += y;
+        sumXX += bit*bit;
+        sumXY += bit*y;
+    }
+    double n = crossings.size();
+    double variance = sumXX-sumX*sumX/n;
+    if(variance <= 0)
+        return false;
+    unitInterval = (sumXY-sumX*sumY/n)/variance*source->getDiv();
+    return true;
+}
+
+/**
+ * @brief EyeDiagram::fold adds samples to density. Phase is 64 bit fixed point number where
+ * whole range is two unit intervals, so it wraps by itself and column is it's top byte.
+ * Inner loop over run of chunk has no branches, so it runs at one increment per sample.
+ * @param origin position in samples which falls on start of first unit interval.
+ */
+void EyeDiagram::fold(size_t from, size_t to, double origin)
+{
+    double samplesPerWindow = 2*unitInterval/source->getDiv();
+    double start = (from-origin)/samplesPerWindow;
+    start -= floor(start);
+    uint64_t phase = static_cast<uint64_t>(ldexp(start, 63))*2;
+    uint64_t phaseStep = static_cast<uint64_t>(ldexp(1/samplesPerWindow, 63))*2;
+    quint32 * cells = density.data();
+    for(size_t i = from; i < to;)
+    {
+        size_t length;
+        const unsigned char * run = source->getRun(0, i, length);
+        length = qMin(length, to-i);
+        for(size_t ii = 0; ii < length; ++ii)
+        {
+            ++cells[((ROWS-1-run[ii]) << 8) | static_cast<unsigned int>(phase >> 56)];
+            phase += phaseStep;
+        }
+        i += length;
+    }
+    samples += to-from;
+}
+
+/**
+ * @brief EyeDiagram::update folds samples appended since last update. Samples are folded in
+ * segments of RELOCK_SAMPLES, each relocked to it's first crossing, so small error of recovered
+ * period or drift of transmitter clock doesn't accumulate.
+ */
+void EyeDiagram::update()
+{
+    size_t end = source->lastPositionOnBit(0);
+    if(end < position)
+    { // data were rewritten
+        reset();
+    }
+    BitSamples data = source->getSamples(0);
+    if(unitInterval <= 0 and not recoverUnitInterval(data, position, end))
+        return;
+    if(unitInterval < 2*source->getDiv())
+        return; // less than two samples per bit can't form eye
+    double half = unitInterval/(2*source->getDiv());
+    bool folded = false;
+    while(position < end)
+    {
+        size_t segmentEnd = qMin(end, position+RELOCK_SAMPLES);
+        QVector<size_t> crossings;
+        if(findCrossings(data, position, segmentEnd, crossings, 1) == 1)
+        { // segment without any transition has nothing to show
+            fold(position, segmentEnd, getCrossingPosition(data, position, crossings.first())-half);
+            folded = true;
+        }
+        position = segmentEnd;
+    }
+    if(not folded)
+        return;
+    maximum = 0;
+    for(int i = 0; i < density.size(); ++i)
+    {
+        maximum = qMax(maximum, density.at(i));
+    }
+    ++version;
+    emit eyeUpdated();
+}
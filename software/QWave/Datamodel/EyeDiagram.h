@@ -0,0 +1,84 @@
+//
+//   EyeDiagram.h
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef QWave_EyeDiagram_h
+#define QWave_EyeDiagram_h
+
+#include <QObject>
+#include <QVector>
+#include "PlotData.h"
+
+/**
+ * @brief The EyeDiagram class folds samples of plot data on bit period into 2-D density buffer
+ * two unit intervals wide. Columns are phase within those two intervals, rows are sample levels.
+ * Bit period is given by user or recovered from edges of data. Only samples appended since
+ * last update are folded, phase is regularly relocked to crossings of data,
+ * so gaps between captured blocks and clock drift don't smear the eye.
+ */
+class EyeDiagram : public QObject
+{
+    Q_OBJECT
+    PlotData * source;
+    double period;
+    double unitInterval;
+    size_t position;
+    QVector<quint32> density;
+    quint32 maximum;
+    uint64_t samples;
+    uint64_t version;
+    int findCrossings(const BitSamples & data, size_t from, size_t to, QVector<size_t> & crossings, int maxCount);
+    double getCrossingPosition(const BitSamples & data, size_t from, size_t crossing);
+    bool recoverUnitInterval(const BitSamples & data, size_t from, size_t to);
+    void fold(size_t from, size_t to, double origin);
+public:
+    static const int COLUMNS = 256;
+    static const int ROWS = 256;
+    static const int ANALOG_THRESHOLD = 128;
+    static const int ANALOG_HYSTERESIS = 8;
+    static const int RECOVERY_EDGES = 4096;
+    static const size_t RELOCK_SAMPLES = 4096;
+    EyeDiagram(PlotData * source, double period = 0, QObject * parent = 0);
+    PlotData * getSource() { return source; }
+    void setPeriod(double period);
+    double getPeriod() { return period; }
+    double getUnitInterval() { return unitInterval; }
+    const QVector<quint32> & getDensity() { return density; }
+    quint32 getMaximum() { return maximum; }
+    uint64_t getSampleCount() { return samples; }
+    uint64_t getVersion() { return version; }
+    void reset();
+public slots:
+    void update();
+signals:
+    void eyeUpdated();
+};
+
+#endif
@@ -0,0 +1,194 @@
+//
+//   Fft.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Fft.h"
+#include "../Exceptions/Exception.h"
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/**
+ * @brief Fft::Fft prepares bit reversal and twiddle tables.
+ * @param size length of real input, power of two.
+ */
+Fft::Fft(int size) : size(size), half(size/2), windowType(-1)
+{
+    if(not isPowerOfTwo(size) or size < 4)
+    {
+        throw Exception("FFT length has to be power of two.");
+    }
+    bitReverse.resize(half);
+    int bits = 0;
+    while((1 << bits) < half)
+        ++bits;
+    for(int i = 0; i < half; ++i)
+    {
+        int reversed = 0;
+        for(int b = 0; b < bits; ++b)
+        {
+            if(i & (1 << b))
+                reversed |= 1 << (bits-1-b);
+        }
+        bitReverse[i] = reversed;
+    }
+    twiddleCos.resize(half/2);
+    twiddleSin.resize(half/2);
+    for(int k = 0; k < half/2; ++k)
+    {
+        twiddleCos[k] = cos(2*M_PI*k/half);
+        twiddleSin[k] = -sin(2*M_PI*k/half);
+    }
+    splitCos.resize(half);
+    splitSin.resize(half);
+    for(int k = 0; k < half; ++k)
+    {
+        splitCos[k] = cos(2*M_PI*k/size);
+        splitSin[k] = -sin(2*M_PI*k/size);
+    }
+    re.resize(half);
+    im.resize(half);
+}
+
+/**
+ * @brief Fft::transform in place complex FFT of re and im, input has to be in bit reversed order.
+ */
+void Fft::transform()
+{
+    float * r = re.data();
+    float * m = im.data();
+    const float * wc = twiddleCos.constData();
+    const float * ws = twiddleSin.constData();
+    for(int length = 2; length <= half; length *= 2)
+    {
+        int halfLength = length/2;
+        int step = half/length;
+        for(int start = 0; start < half; start += length)
+        {
+            float * r1 = r+start;
+            float * m1 = m+start;
+            float * r2 = r1+halfLength;
+            float * m2 = m1+halfLength;
+            for(int j = 0; j < halfLength; ++j)
+            {
+                float c = wc[j*step];
+                float s = ws[j*step];
+                float tr = r2[j]*c-m2[j]*s;
+                float ti = r2[j]*s+m2[j]*c;
+                r2[j] = r1[j]-tr;
+                m2[j] = m1[j]-ti;
+                r1[j] += tr;
+                m1[j] += ti;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Fft::powerSpectrum computes squared magnitudes of spectrum of real input.
+ * @param input size samples.
+ * @param power size/2+1 bins from DC to Nyquist frequency.
+ */
+void Fft::powerSpectrum(const float * input, float * power)
+{
+    for(int i = 0; i < half; ++i)
+    {
+        int j = bitReverse[i];
+        re[j] = input[2*i];
+        im[j] = input[2*i+1];
+    }
+    transform();
+    // Z = FFT of z[n] = x[2n] + i*x[2n+1], X[k] = E[k] + W^k*O[k]
+    for(int k = 0; k <= half; ++k)
+    {
+        int a = k == half ? 0 : k;
+        int b = k == 0 ? 0 : half-k;
+        float zr = re[a];
+        float zi = im[a];
+        float cr = re[b];
+        float ci = -im[b];
+        float er = (zr+cr)/2;
+        float ei = (zi+ci)/2;
+        float or_ = (zi-ci)/2;
+        float oi = -(zr-cr)/2;
+        float wc = k == half ? -1 : splitCos[k];
+        float ws = k == half ? 0 : splitSin[k];
+        float xr = er+or_*wc-oi*ws;
+        float xi = ei+or_*ws+oi*wc;
+        power[k] = xr*xr+xi*xi;
+    }
+}
+
+/**
+ * @brief Fft::getWindow
+ * @param type window type.
+ * @return returns coefficients of window of FFT length, kept until other window is asked for.
+ */
+const QVector<float> & Fft::getWindow(int type)
+{
+    if(type != windowType)
+    {
+        windowCoefficients = window(type, size);
+        windowType = type;
+    }
+    return windowCoefficients;
+}
+
+/**
+ * @brief Fft::window
+ * @param type window type.
+ * @param size
+ * @return returns window coefficients.
+ */
+QVector<float> Fft::window(int type, int size)
+{
+    QVector<float> w(size);
+    for(int i = 0; i < size; ++i)
+    {
+        double x = 2*M_PI*i/size;
+        switch(type)
+        {
+        case Hann:
+            w[i] = 0.5-0.5*cos(x);
+            break;
+        case BlackmanHarris:
+            w[i] = 0.35875-0.48829*cos(x)+0.14128*cos(2*x)-0.01168*cos(3*x);
+            break;
+        case FlatTop:
+            w[i] = 0.21557895-0.41663158*cos(x)+0.277263158*cos(2*x)-0.083578947*cos(3*x)+0.006947368*cos(4*x);
+            break;
+        default:
+            w[i] = 1;
+        }
+    }
+    return w;
+}
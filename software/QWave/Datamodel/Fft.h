@@ -0,0 +1,69 @@
+//
+//   Fft.h
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef QWave_Fft_h
+#define QWave_Fft_h
+
+#include <QVector>
+
+/**
+ * @brief The Fft class computes power spectrum of real signal of power of two length.
+ * Real input of length N is transformed as N/2 point complex FFT (radix-2, iterative)
+ * followed by split step separating spectra of even and odd samples.
+ * Real and imaginary parts are kept in separate arrays so butterfly loops can be vectorized.
+ * Twiddle tables are computed once in constructor, window coefficients on first use
+ * of window, one instance should not be used from two threads at once.
+ */
+class Fft
+{
+    int size;
+    int half;
+    QVector<int> bitReverse;
+    QVector<float> twiddleCos;
+    QVector<float> twiddleSin;
+    QVector<float> splitCos;
+    QVector<float> splitSin;
+    QVector<float> re;
+    QVector<float> im;
+    QVector<float> windowCoefficients;
+    int windowType;
+    void transform();
+public:
+    enum Window { Rectangular, Hann, BlackmanHarris, FlatTop };
+    Fft(int size);
+    int getSize() { return size; }
+    void powerSpectrum(const float * input, float * power);
+    const QVector<float> & getWindow(int type);
+    static QVector<float> window(int type, int size);
+    static bool isPowerOfTwo(int size) { return size > 1 and (size & (size-1)) == 0; }
+};
+
+#endif
@@ -0,0 +1,218 @@
+//
+//   LoadJob.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "LoadJob.h"
+#include "FileSplitter.h"
+#include <QtConcurrentRun>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+
+/**
+ * @brief LoadJob::LoadJob
+ * @param model model to load file into, it is not owned and must outlive job.
+ * @param fileName
+ * @param parent
+ */
+LoadJob::LoadJob(PlotTreeModel * model, const QString & fileName, QObject * parent) :
+    QObject(parent), model(model), fileName(fileName), cancelled(false), headerTaken(false),
+    fileSize(QFileInfo(fileName).size()), bytesRead(0), dumpPosition(0), seenSigns(256, false), signalsWithData(0)
+{
+    connect(this, SIGNAL(headerRead()), this, SLOT(takeHeader()), Qt::QueuedConnection);
+    connect(this, SIGNAL(batchRead()), this, SLOT(applyBatches()), Qt::QueuedConnection);
+    connect(&watcher, SIGNAL(finished()), this, SLOT(workerFinished()));
+}
+
+LoadJob::~LoadJob()
+{
+    cancel();
+    watcher.waitForFinished();
+}
+
+/**
+ * @brief LoadJob::start starts loading on worker thread.
+ */
+void LoadJob::start()
+{
+    watcher.setFuture(QtConcurrent::run(this, &LoadJob::run));
+}
+
+/**
+ * @brief LoadJob::cancel stops worker after batch it is reading.
+ */
+void LoadJob::cancel()
+{
+    QMutexLocker locker(&mutex);
+    cancelled = true;
+    drained.wakeAll();
+}
+
+bool LoadJob::isCancelled()
+{
+    QMutexLocker locker(&mutex);
+    return cancelled;
+}
+
+/**
+ * @brief LoadJob::isHeaderTaken
+ * @return returns true if model got hierarchy, so it shows signals even if loading failed later.
+ */
+bool LoadJob::isHeaderTaken()
+{
+    QMutexLocker locker(&mutex);
+    return headerTaken;
+}
+
+/**
+ * @brief LoadJob::run parses file on worker thread. Only header model and queue are touched here.
+ */
+void LoadJob::run()
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly |
+                  QIODevice::Text))
+    {
+        QMutexLocker locker(&mutex);
+        error = "Could not open file: "+QFileInfo(fileName).fileName();
+        return;
+    }
+    try
+    {
+        FileSplitter splitter = FileSplitter(&file);
+        header.loadHeader(splitter);
+        QMutexLocker locker(&mutex);
+        emit headerRead();
+        while(not headerTaken and not cancelled)
+        {
+            drained.wait(&mutex);
+        }
+        if(cancelled)
+            return;
+        locker.unlock();
+        header.setCollectEvents(true);
+        header.beginDump();
+        bool more = true;
+        while(more)
+        {
+            more = header.readDump(splitter, PlotTreeModel::DUMP_BATCH);
+            locker.relock();
+            while(batches.count() >= MAX_QUEUED_BATCHES and not cancelled)
+            {
+                drained.wait(&mutex);
+            }
+            batches.enqueue(header.takeEvents());
+            bytesRead = file.pos();
+            dumpPosition = header.getDumpPosition();
+            if(cancelled)
+                return;
+            locker.unlock();
+            emit batchRead();
+        }
+    }
+    catch(Exception e)
+    {
+        QMutexLocker locker(&mutex);
+        error = e.getMessage();
+    }
+}
+
+/**
+ * @brief LoadJob::takeHeader moves hierarchy read by worker to model and lets worker go on with dump.
+ */
+void LoadJob::takeHeader()
+{
+    model->takeHeader(header);
+    {
+        QMutexLocker locker(&mutex);
+        headerTaken = true;
+        drained.wakeAll();
+    }
+    emit hierarchyLoaded();
+}
+
+/**
+ * @brief LoadJob::applyBatches applies all queued batches to model.
+ */
+void LoadJob::applyBatches()
+{
+    QQueue<QVector<DumpEvent> > ready;
+    qint64 bytes;
+    {
+        QMutexLocker locker(&mutex);
+        ready = batches;
+        batches.clear();
+        bytes = bytesRead;
+        drained.wakeAll();
+    }
+    if(ready.isEmpty())
+        return;
+    while(not ready.isEmpty())
+    {
+        QVector<DumpEvent> events = ready.dequeue();
+        for(int i = 0; i < events.size(); ++i)
+        {
+            unsigned char sign = events.at(i).sign;
+            if(not seenSigns.at(sign))
+            {
+                seenSigns[sign] = true;
+                ++signalsWithData;
+            }
+        }
+        model->applyEvents(events);
+    }
+    emit progress(bytes, fileSize, signalsWithData, model->getSignalCount());
+}
+
+/**
+ * @brief LoadJob::workerFinished applies rest of values and seals data, also after cancel or error,
+ * so values loaded until then stay viewable.
+ */
+void LoadJob::workerFinished()
+{
+    applyBatches();
+    bool taken;
+    size_t position;
+    QString message;
+    {
+        QMutexLocker locker(&mutex);
+        taken = headerTaken;
+        position = dumpPosition;
+        message = error;
+    }
+    if(taken)
+    {
+        model->finishDump(position);
+    }
+    if(message.isEmpty())
+        emit loaded();
+    else
+        emit failed(message);
+}
@@ -0,0 +1,94 @@
+//
+//   LoadJob.h
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef QWave_LoadJob_h
+#define QWave_LoadJob_h
+
+#include <QObject>
+#include <QString>
+#include <QQueue>
+#include <QVector>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QFutureWatcher>
+#include "PlotTreeModel.h"
+
+/**
+ * @brief The LoadJob class loads VCD file into model on worker thread.
+ * Worker parses header into its own model and values into batches of events, model itself
+ * is changed only on thread of LoadJob: hierarchy is taken over once header is read
+ * and batches are applied as they arrive, so signals can be viewed while file is loading.
+ * At most MAX_QUEUED_BATCHES wait to be applied, then worker waits. Cancelled load
+ * keeps values loaded so far.
+ */
+class LoadJob : public QObject
+{
+    Q_OBJECT
+    PlotTreeModel * model;
+    QString fileName;
+    PlotTreeModel header;
+    QFutureWatcher<void> watcher;
+    QMutex mutex;
+    QWaitCondition drained;
+    QQueue<QVector<DumpEvent> > batches;
+    bool cancelled;
+    bool headerTaken;
+    QString error;
+    qint64 fileSize;
+    qint64 bytesRead;
+    size_t dumpPosition;
+    QVector<bool> seenSigns;
+    int signalsWithData;
+    void run();
+public:
+    static const int MAX_QUEUED_BATCHES = 8;
+    LoadJob(PlotTreeModel * model, const QString & fileName, QObject * parent = 0);
+    ~LoadJob();
+    void start();
+    bool isRunning() { return watcher.isRunning(); }
+    bool isCancelled();
+    bool isHeaderTaken();
+public slots:
+    void cancel();
+private slots:
+    void takeHeader();
+    void applyBatches();
+    void workerFinished();
+signals:
+    void headerRead();
+    void batchRead();
+    void hierarchyLoaded();
+    void progress(qint64 bytesRead, qint64 fileSize, int signalsWithData, int signalCount);
+    void loaded();
+    void failed(QString message);
+};
+
+#endif
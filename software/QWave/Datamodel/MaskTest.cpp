@@ -0,0 +1,248 @@
+//
+//   MaskTest.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "MaskTest.h"
+
+MaskTest::MaskTest() : data(NULL), enabled(false), stopOnFailure(false), passed(0), failed(0), blocks(0), position(0), lastViolation(0)
+{
+}
+
+/**
+ * @brief MaskTest::windowExtremes computes minimum and maximum of samples within radius around
+ * every sample in linear time (van Herk/Gil-Werman), samples beyond ends repeat end samples.
+ */
+void MaskTest::windowExtremes(const unsigned char * samples, size_t length, int radius, unsigned char * minimum, unsigned char * maximum)
+{
+    size_t window = 2*radius+1;
+    size_t padded = length+2*radius;
+    size_t blocks = (padded+window-1)/window;
+    QVector<unsigned char> values(blocks*window);
+    for(size_t i = 0; i < size_t(values.size()); ++i)
+    {
+        size_t source = i < size_t(radius) ? 0 : qMin(i-radius, length-1);
+        values[i] = samples[source];
+    }
+    QVector<unsigned char> prefixMin(values.size());
+    QVector<unsigned char> prefixMax(values.size());
+    QVector<unsigned char> suffixMin(values.size());
+    QVector<unsigned char> suffixMax(values.size());
+    for(size_t block = 0; block < blocks; ++block)
+    {
+        size_t first = block*window;
+        size_t last = first+window-1;
+        prefixMin[first] = prefixMax[first] = values[first];
+        for(size_t i = first+1; i <= last; ++i)
+        {
+            prefixMin[i] = qMin(prefixMin[i-1], values[i]);
+            prefixMax[i] = qMax(prefixMax[i-1], values[i]);
+        }
+        suffixMin[last] = suffixMax[last] = values[last];
+        for(size_t i = last; i > first; --i)
+        {
+            suffixMin[i-1] = qMin(suffixMin[i], values[i-1]);
+            suffixMax[i-1] = qMax(suffixMax[i], values[i-1]);
+        }
+    }
+    for(size_t i = 0; i < length; ++i)
+    { // window of sample i is [i, i+window) in padded values
+        minimum[i] = qMin(suffixMin[i], prefixMin[i+window-1]);
+        maximum[i] = qMax(suffixMax[i], prefixMax[i+window-1]);
+    }
+}
+
+/**
+ * @brief MaskTest::setMask creates mask from golden waveform in data, later blocks of same data are tested.
+ * Counters and saved failures are reset.
+ * @param data
+ * @param from first sample of golden waveform.
+ * @param length length of golden waveform and of tested blocks.
+ * @param tolerance allowed difference of level, not used for logic data.
+ * @param timeTolerance allowed shift in samples.
+ */
+void MaskTest::setMask(PlotData * data, size_t from, size_t length, int tolerance, int timeTolerance)
+{
+    this->data = data;
+    lower.clear();
+    upper.clear();
+    if(data->getType() == PlotData::Logic)
+        tolerance = 0;
+    for(int bit = 0; bit < data->getBitwidth(); ++bit)
+    {
+        size_t available = data->lastPositionOnBit(bit);
+        length = qMin(length, available > from ? available-from : 0);
+    }
+    for(int bit = 0; bit < data->getBitwidth(); ++bit)
+    {
+        QVector<unsigned char> minimum(length);
+        QVector<unsigned char> maximum(length);
+        if(length > 0)
+        {
+            QVector<unsigned char> golden(length);
+            data->copySamples(bit, from, length, golden.data());
+            windowExtremes(golden.constData(), length, timeTolerance, minimum.data(), maximum.data());
+        }
+        for(size_t i = 0; i < length; ++i)
+        {
+            minimum[i] = qMax(0, minimum[i]-tolerance);
+            maximum[i] = qMin(255, maximum[i]+tolerance);
+        }
+        lower.append(minimum);
+        upper.append(maximum);
+    }
+    reset();
+}
+
+/**
+ * @brief MaskTest::reset resets counters and saved failures, blocks are tested from end of current data.
+ */
+void MaskTest::reset()
+{
+    passed = 0;
+    failed = 0;
+    blocks = 0;
+    pending.clear();
+    failures.clear();
+    position = data != NULL ? data->lastPositionOnBit(0) : 0;
+}
+
+/**
+ * @brief MaskTest::addBlock queues block appended since previous call for testing, used when
+ * every capture run is one acquisition.
+ */
+void MaskTest::addBlock()
+{
+    size_t end = data->lastPositionOnBit(0);
+    if(end < position)
+        position = 0; // data were rewritten
+    if(end > position)
+        pending.append(position);
+    position = end;
+}
+
+/**
+ * @brief MaskTest::addSegment queues segment starting at sample, used for segments found by software trigger.
+ * @param start
+ */
+void MaskTest::addSegment(size_t start)
+{
+    pending.append(start);
+    position = data->lastPositionOnBit(0);
+}
+
+/**
+ * @brief MaskTest::findViolation tests block of bit starting at sample start.
+ * Block is tested in pieces of at most CHUNK samples cut at ends of stored chunks.
+ * @return returns first sample outside of mask or length of mask if there is none.
+ */
+size_t MaskTest::findViolation(int bit, size_t start)
+{
+    const unsigned char * low = lower.at(bit).constData();
+    const unsigned char * high = upper.at(bit).constData();
+    size_t length = lower.at(bit).size();
+    for(size_t i = 0; i < length;)
+    {
+        size_t run;
+        const unsigned char * samples = data->getRun(bit, start+i, run);
+        size_t count = qMin(length-i, run);
+        if(count > CHUNK)
+            count = CHUNK;
+        int outside = 0;
+        for(size_t j = 0; j < count; ++j)
+        {
+            outside |= (samples[j] < low[i+j]) | (samples[j] > high[i+j]);
+        }
+        if(outside)
+        {
+            for(size_t j = 0; j < count; ++j)
+            {
+                if(samples[j] < low[i+j] or samples[j] > high[i+j])
+                    return i+j;
+            }
+        }
+        i += count;
+    }
+    return length;
+}
+
+/**
+ * @brief MaskTest::process tests queued segments which are already captured whole.
+ * Failing segments are counted and first MAX_SAVED_FAILURES of them are copied,
+ * so they can be inspected even after data are overwritten.
+ * @return returns number of failed segments.
+ */
+int MaskTest::process()
+{
+    if(not enabled)
+        return 0;
+    size_t length = getLength();
+    size_t available = data->lastPositionOnBit(0);
+    int failedNow = 0;
+    for(int i = 0; i < pending.size(); ++i)
+    {
+        size_t start = pending.at(i);
+        if(start > available)
+        { // data were rewritten
+            pending.remove(i--);
+            continue;
+        }
+        if(start+length > available)
+            continue;
+        pending.remove(i--);
+        ++blocks;
+        size_t violation = length;
+        for(int bit = 0; bit < lower.size() and violation == length; ++bit)
+        {
+            violation = findViolation(bit, start);
+        }
+        if(violation == length)
+        {
+            ++passed;
+            continue;
+        }
+        ++failed;
+        ++failedNow;
+        lastViolation = start+violation;
+        if(failures.size() >= MAX_SAVED_FAILURES)
+            continue;
+        Failure failure;
+        failure.block = blocks;
+        failure.start = start;
+        failure.violation = start+violation;
+        for(int bit = 0; bit < lower.size(); ++bit)
+        {
+            QVector<unsigned char> samples(length);
+            data->copySamples(bit, start, length, samples.data());
+            failure.samples.append(samples);
+        }
+        failures.append(failure);
+    }
+    return failedNow;
+}
@@ -0,0 +1,92 @@
+//
+//   MaskTest.h
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef QWave_MaskTest_h
+#define QWave_MaskTest_h
+
+#include <QVector>
+#include "PlotData.h"
+
+/**
+ * @brief The MaskTest class tests captured blocks against tolerance mask made from golden waveform.
+ * Mask is precomputed into lower and upper bound of every sample of every bit, widened by
+ * amplitude tolerance and by time tolerance (extremes of golden waveform around sample). Logic data
+ * have no amplitude tolerance, so they must match exactly except near edges of golden waveform.
+ * Blocks are tested in chunks by branchless comparisons, chunk is walked only when it contains violation.
+ */
+class MaskTest
+{
+public:
+    struct Failure
+    {
+        uint64_t block;
+        size_t start;
+        size_t violation;
+        QVector<QVector<unsigned char> > samples;
+    };
+    static const size_t CHUNK = 64;
+    static const int MAX_SAVED_FAILURES = 64;
+    MaskTest();
+    void setMask(PlotData * data, size_t from, size_t length, int tolerance, int timeTolerance);
+    void setEnabled(bool enabled) { this->enabled = enabled and data != NULL; }
+    bool isEnabled() { return enabled; }
+    void setStopOnFailure(bool stop) { stopOnFailure = stop; }
+    bool getStopOnFailure() { return stopOnFailure; }
+    PlotData * getData() { return data; }
+    size_t getLength() { return lower.isEmpty() ? 0 : lower.first().size(); }
+    const QVector<unsigned char> & getLower(int bit) { return lower.at(bit); }
+    const QVector<unsigned char> & getUpper(int bit) { return upper.at(bit); }
+    void addBlock();
+    void addSegment(size_t start);
+    int process();
+    void reset();
+    uint64_t getPassed() { return passed; }
+    uint64_t getFailed() { return failed; }
+    const QVector<Failure> & getFailures() { return failures; }
+    size_t getLastViolation() { return lastViolation; }
+private:
+    PlotData * data;
+    QVector<QVector<unsigned char> > lower;
+    QVector<QVector<unsigned char> > upper;
+    bool enabled;
+    bool stopOnFailure;
+    uint64_t passed;
+    uint64_t failed;
+    uint64_t blocks;
+    size_t position;
+    size_t lastViolation;
+    QVector<size_t> pending;
+    QVector<Failure> failures;
+    size_t findViolation(int bit, size_t start);
+    static void windowExtremes(const unsigned char * samples, size_t length, int radius, unsigned char * minimum, unsigned char * maximum);
+};
+
+#endif
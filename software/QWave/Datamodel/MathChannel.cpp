@@ -0,0 +1,507 @@
+//
+//   MathChannel.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#define __STDC_LIMIT_MACROS
+
+#include <stdint.h>
+#include "MathChannel.h"
+#include "../Exceptions/Exception.h"
+
+/**
+ * @brief MathChannel::MathChannel compiles expression.
+ * @param expression
+ * @param channels analog data available as ch1..chN.
+ * @throws Exception if expression is not valid.
+ */
+MathChannel::MathChannel(const QString & expression, QVector<PlotData*> channels) :
+    expression(expression), channels(channels), stackDepth(0), maxStackDepth(0), stateCount(0),
+    cursorPosition(0), cursorValid(false), text(expression.toLower()), position(0)
+{
+    parseExpression();
+    skipSpaces();
+    if(position != text.length())
+        throw Exception("Unexpected '"+text.mid(position, 1)+"' at position "+QString::number(position+1)+".");
+    if(usedChannels.isEmpty())
+        throw Exception("Expression has to use at least one channel.");
+    stack.resize(maxStackDepth);
+    for(int i = 0; i < maxStackDepth; ++i)
+    {
+        stack[i].resize(BLOCK);
+    }
+    scratch.resize(BLOCK);
+}
+
+void MathChannel::skipSpaces()
+{
+    while(position < text.length() and text.at(position).isSpace())
+        ++position;
+}
+
+bool MathChannel::accept(char c)
+{
+    skipSpaces();
+    if(position < text.length() and text.at(position) == c)
+    {
+        ++position;
+        return true;
+    }
+    return false;
+}
+
+void MathChannel::expect(char c)
+{
+    if(not accept(c))
+        throw Exception(QString("Expected '")+c+"' at position "+QString::number(position+1)+".");
+}
+
+double MathChannel::parseNumber()
+{
+    skipSpaces();
+    int start = position;
+    while(position < text.length() and (text.at(position).isDigit() or text.at(position) == '.'))
+        ++position;
+    if(position < text.length() and text.at(position) == 'e')
+    {
+        ++position;
+        if(position < text.length() and (text.at(position) == '-' or text.at(position) == '+'))
+            ++position;
+        while(position < text.length() and text.at(position).isDigit())
+            ++position;
+    }
+    bool ok;
+    double number = text.mid(start, position-start).toDouble(&ok);
+    if(not ok)
+        throw Exception("Expected number at position "+QString::number(start+1)+".");
+    return number;
+}
+
+/**
+ * @brief MathChannel::append appends instruction to program and tracks stack depth.
+ * @param stackChange how instruction changes stack depth.
+ */
+void MathChannel::append(int operation, int channel, float value, int stackChange)
+{
+    Instruction instruction;
+    instruction.operation = operation;
+    instruction.channel = channel;
+    instruction.value = value;
+    instruction.state = -1;
+    if(operation >= Integral)
+        instruction.state = stateCount++;
+    program.append(instruction);
+    stackDepth += stackChange;
+    maxStackDepth = qMax(maxStackDepth, stackDepth);
+}
+
+void MathChannel::parseExpression()
+{
+    parseTerm();
+    while(true)
+    {
+        if(accept('+'))
+        {
+            parseTerm();
+            append(Add, 0, 0, -1);
+        }
+        else if(accept('-'))
+        {
+            parseTerm();
+            append(Subtract, 0, 0, -1);
+        }
+        else
+            return;
+    }
+}
+
+void MathChannel::parseTerm()
+{
+    parseUnary();
+    while(true)
+    {
+        if(accept('*'))
+        {
+            parseUnary();
+            append(Multiply, 0, 0, -1);
+        }
+        else if(accept('/'))
+        {
+            parseUnary();
+            append(Divide, 0, 0, -1);
+        }
+        else
+            return;
+    }
+}
+
+void MathChannel::parseUnary()
+{
+    if(accept('-'))
+    {
+        parseUnary();
+        append(Negate);
+    }
+    else
+    {
+        parsePrimary();
+    }
+}
+
+void MathChannel::parsePrimary()
+{
+    if(accept('('))
+    {
+        parseExpression();
+        expect(')');
+        return;
+    }
+    skipSpaces();
+    int start = position;
+    while(position < text.length() and text.at(position).isLetter())
+        ++position;
+    QString name = text.mid(start, position-start);
+    if(name.isEmpty())
+    {
+        append(Constant, 0, parseNumber(), 1);
+        return;
+    }
+    if(name == "ch")
+    {
+        int channel = static_cast<int>(parseNumber())-1;
+        if(channel < 0 or channel >= channels.size())
+            throw Exception("There is no channel ch"+QString::number(channel+1)+".");
+        if(not usedChannels.contains(channel))
+            usedChannels.append(channel);
+        append(Channel, channel, 0, 1);
+        return;
+    }
+    int operation;
+    if(name == "integ")
+        operation = Integral;
+    else if(name == "diff")
+        operation = Derivative;
+    else if(name == "avg")
+        operation = Average;
+    else if(name == "lowpass")
+        operation = LowPass;
+    else
+        throw Exception("Unknown function '"+name+"'.");
+    expect('(');
+    parseExpression();
+    double parameter = 0;
+    if(operation == Average or operation == LowPass)
+    {
+        expect(',');
+        parameter = parseNumber();
+        if(parameter < 1)
+            throw Exception("Length of "+name+" has to be at least 1.");
+    }
+    expect(')');
+    if(operation == Average)
+        averageLengths.append(static_cast<int>(parameter));
+    else
+        averageLengths.append(0);
+    append(operation, 0, parameter);
+}
+
+/**
+ * @brief MathChannel::initialState
+ * @return returns state of integrals and filters before first sample.
+ */
+MathChannel::State MathChannel::initialState()
+{
+    State state;
+    state.values.fill(0, stateCount);
+    state.counts.fill(0, stateCount);
+    state.history.resize(stateCount);
+    for(int i = 0; i < stateCount; ++i)
+    {
+        state.history[i].fill(0, averageLengths.at(i));
+    }
+    return state;
+}
+
+/**
+ * @brief MathChannel::run computes at most BLOCK samples starting at from.
+ * @param out
+ * @param state state before sample from, updated to state after last computed sample.
+ */
+void MathChannel::run(size_t from, size_t count, float * out, State & state)
+{
+    int top = 0;
+    for(int p = 0; p < program.size(); ++p)
+    {
+        const Instruction & instruction = program.at(p);
+        // operands of binary operations
+        float * a = top > 1 ? stack[top-2].data() : NULL;
+        float * b = top > 1 ? stack[top-1].data() : NULL;
+        switch(instruction.operation)
+        {
+        case Channel:
+        {
+            float * d = stack[top++].data();
+            for(size_t i = 0; i < count;)
+            {
+                size_t length;
+                const unsigned char * samples = channels.at(instruction.channel)->getRun(0, from+i, length);
+                length = qMin(length, count-i);
+                for(size_t ii = 0; ii < length; ++ii)
+                {
+                    d[i+ii] = samples[ii]-128.0f;
+                }
+                i += length;
+            }
+            break;
+        }
+        case Constant:
+        {
+            float * d = stack[top++].data();
+            for(size_t i = 0; i < count; ++i)
+            {
+                d[i] = instruction.value;
+            }
+            break;
+        }
+        case Add:
+            for(size_t i = 0; i < count; ++i)
+            {
+                a[i] += b[i];
+            }
+            --top;
+            break;
+        case Subtract:
+            for(size_t i = 0; i < count; ++i)
+            {
+                a[i] -= b[i];
+            }
+            --top;
+            break;
+        case Multiply:
+            for(size_t i = 0; i < count; ++i)
+            {
+                a[i] *= b[i];
+            }
+            --top;
+            break;
+        case Divide:
+            for(size_t i = 0; i < count; ++i)
+            {
+                a[i] = b[i] != 0 ? a[i]/b[i] : 0;
+            }
+            --top;
+            break;
+        default:
+        { // unary operations work on top of stack
+            float * d = stack[top-1].data();
+            int s = instruction.state;
+            switch(instruction.operation)
+            {
+            case Negate:
+                for(size_t i = 0; i < count; ++i)
+                {
+                    d[i] = -d[i];
+                }
+                break;
+            case Integral:
+            {
+                double sum = state.values[s];
+                for(size_t i = 0; i < count; ++i)
+                {
+                    sum += d[i];
+                    d[i] = sum;
+                }
+                state.values[s] = sum;
+                break;
+            }
+            case Derivative:
+            {
+                float last = state.counts[s] ? state.values[s] : d[0];
+                for(size_t i = 0; i < count; ++i)
+                {
+                    float value = d[i];
+                    d[i] = value-last;
+                    last = value;
+                }
+                state.values[s] = last;
+                state.counts[s] = 1;
+                break;
+            }
+            case Average:
+            { // running sum over ring of last n samples, average of fewer samples at the beginning
+                QVector<float> & ring = state.history[s];
+                int n = ring.size();
+                double sum = state.values[s];
+                int filled = state.counts[s];
+                for(size_t i = 0; i < count; ++i)
+                {
+                    int slot = filled%n;
+                    if(filled >= n)
+                        sum -= ring[slot];
+                    ring[slot] = d[i];
+                    sum += d[i];
+                    ++filled;
+                    if(filled >= 2*n)
+                        filled -= n;
+                    d[i] = sum/qMin(filled, n);
+                }
+                state.values[s] = sum;
+                state.counts[s] = filled;
+                break;
+            }
+            case LowPass:
+            {
+                float alpha = 1/instruction.value;
+                float y = state.counts[s] ? state.values[s] : d[0];
+                for(size_t i = 0; i < count; ++i)
+                {
+                    y += (d[i]-y)*alpha;
+                    d[i] = y;
+                }
+                state.values[s] = y;
+                state.counts[s] = 1;
+                break;
+            }
+            }
+        }
+        }
+    }
+    for(size_t i = 0; i < count; ++i)
+    {
+        out[i] = stack[0][i];
+    }
+}
+
+/**
+ * @brief MathChannel::advance computes samples from cursor to given sample,
+ * remembering state at each checkpoint passed.
+ * @param to
+ * @param out output for computed samples or NULL if they are not needed.
+ */
+void MathChannel::advance(size_t to, float * out)
+{
+    while(cursorPosition < to)
+    {
+        if(stateCount > 0 and cursorPosition%CHECKPOINT_DISTANCE == 0 and not checkpoints.contains(cursorPosition))
+            checkpoints.insert(cursorPosition, cursor);
+        size_t nextCheckpoint = (cursorPosition/CHECKPOINT_DISTANCE+1)*CHECKPOINT_DISTANCE;
+        size_t count = qMin(static_cast<size_t>(BLOCK), qMin(to, nextCheckpoint)-cursorPosition);
+        run(cursorPosition, count, out != NULL ? out : scratch.data(), cursor);
+        if(out != NULL)
+            out += count;
+        cursorPosition += count;
+    }
+}
+
+/**
+ * @brief MathChannel::getLength
+ * @return returns number of samples available in all used channels.
+ */
+size_t MathChannel::getLength()
+{
+    size_t length = channels.at(usedChannels.first())->lastPositionOnBit(0);
+    for(int i = 1; i < usedChannels.size(); ++i)
+    {
+        length = qMin(length, channels.at(usedChannels.at(i))->lastPositionOnBit(0));
+    }
+    return length;
+}
+
+/**
+ * @brief MathChannel::getUsedData
+ * @return returns data of channels used by expression.
+ */
+QVector<PlotData*> MathChannel::getUsedData()
+{
+    QVector<PlotData*> used;
+    for(int i = 0; i < usedChannels.size(); ++i)
+    {
+        used.append(channels.at(usedChannels.at(i)));
+    }
+    return used;
+}
+
+/**
+ * @brief MathChannel::update drops checkpoints computed from samples which were rewritten since last update.
+ * @return returns first sample changed since last update, samples before it computed earlier are still valid.
+ */
+size_t MathChannel::update()
+{
+    size_t firstDirty = SIZE_MAX;
+    for(int i = 0; i < usedChannels.size(); ++i)
+    {
+        PlotData * data = channels.at(usedChannels.at(i));
+        if(versions.contains(data))
+        {
+            size_t dirty = data->getDirtySince(versions.value(data)).first;
+            while(not checkpoints.isEmpty() and checkpoints.lastKey() > dirty)
+                checkpoints.remove(checkpoints.lastKey());
+            if(cursorPosition > dirty)
+                cursorValid = false;
+            firstDirty = qMin(firstDirty, dirty);
+        }
+        else
+        {
+            firstDirty = 0;
+        }
+        versions.insert(data, data->checkpointVersion());
+    }
+    return firstDirty;
+}
+
+/**
+ * @brief MathChannel::compute computes samples [from, to), to has to be at most getLength().
+ * Computation starts from nearest checkpoint before from, or continues where last compute ended.
+ * @param out
+ */
+void MathChannel::compute(size_t from, size_t to, float * out)
+{
+    if(stateCount == 0)
+    {
+        cursorPosition = from;
+    }
+    else if(not cursorValid or cursorPosition > from or from-cursorPosition >= CHECKPOINT_DISTANCE)
+    {
+        QMap<size_t, State>::iterator it = checkpoints.upperBound(from);
+        if(it == checkpoints.begin())
+        {
+            cursor = initialState();
+            cursorPosition = 0;
+        }
+        else
+        {
+            --it;
+            cursor = it.value();
+            cursorPosition = it.key();
+        }
+    }
+    cursorValid = true;
+    advance(from, NULL);
+    advance(to, out);
+}
@@ -0,0 +1,111 @@
+//
+//   MathChannel.h
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef QWave_MathChannel_h
+#define QWave_MathChannel_h
+
+#include <QString>
+#include <QVector>
+#include <QMap>
+#include "PlotData.h"
+
+/**
+ * @brief The MathChannel class computes derived analog channel defined by expression.
+ * Expression is compiled into stack program working on blocks of samples, so each
+ * operation is simple loop over block which compiler can vectorize. Nothing is stored
+ * for computed samples, only states of integrals and filters at regular checkpoints,
+ * so any range can be computed without starting from the first sample.
+ * Samples are in signed raw units, source sample 128 is 0.
+ *
+ * Expression grammar: ch1..chN, numbers, + - * / unary minus, parentheses and functions
+ * integ(x), diff(x), avg(x, n) moving average of n samples, lowpass(x, t) first order
+ * low-pass filter with time constant of t samples.
+ */
+class MathChannel
+{
+    enum Operation { Channel, Constant, Add, Subtract, Multiply, Divide, Negate, Integral, Derivative, Average, LowPass };
+    struct Instruction
+    {
+        int operation;
+        int channel;
+        float value;
+        int state;
+    };
+    struct State
+    {
+        QVector<double> values;
+        QVector<int> counts;
+        QVector<QVector<float> > history;
+    };
+    QString expression;
+    QVector<PlotData*> channels;
+    QVector<int> usedChannels;
+    QVector<Instruction> program;
+    QVector<int> averageLengths;
+    int stackDepth;
+    int maxStackDepth;
+    int stateCount;
+    QVector<QVector<float> > stack;
+    QVector<float> scratch;
+    QMap<size_t, State> checkpoints;
+    State cursor;
+    size_t cursorPosition;
+    bool cursorValid;
+    QMap<PlotData*, uint64_t> versions;
+    //parser
+    QString text;
+    int position;
+    void skipSpaces();
+    bool accept(char c);
+    void expect(char c);
+    double parseNumber();
+    void parseExpression();
+    void parseTerm();
+    void parseUnary();
+    void parsePrimary();
+    void append(int operation, int channel = 0, float value = 0, int stackChange = 0);
+    //evaluation
+    State initialState();
+    void run(size_t from, size_t count, float * out, State & state);
+    void advance(size_t to, float * out);
+public:
+    static const int BLOCK = 1024;
+    static const size_t CHECKPOINT_DISTANCE = 1 << 16;
+    MathChannel(const QString & expression, QVector<PlotData*> channels);
+    const QString & getExpression() { return expression; }
+    PlotData * getData() { return channels.at(usedChannels.first()); }
+    QVector<PlotData*> getUsedData();
+    size_t getLength();
+    size_t update();
+    void compute(size_t from, size_t to, float * out);
+};
+
+#endif
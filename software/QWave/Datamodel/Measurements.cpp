@@ -0,0 +1,308 @@
+//
+//   Measurements.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Measurements.h"
+#include "SampleScan.h"
+#include "Constants.h"
+#include <math.h>
+
+#define LEVEL_CHUNK 4096
+#define MIN_SWING 8
+#define UNKNOWN_STATE 0
+#define LOW_STATE 1
+#define HIGH_STATE 2
+
+Measurements::Accumulator::Accumulator()
+    :   samples(0),
+        sum(0),
+        sumOfSquares(0),
+        minimum(255),
+        maximum(0),
+        version(0)
+{
+    resetEdges(-1, 256);
+}
+
+/**
+ * @brief Measurements::Accumulator::resetEdges forgets edge state, used when levels change.
+ * @param low level signal has to get to (or below) to be low.
+ * @param high level signal has to get to (or above) to be high.
+ */
+void Measurements::Accumulator::resetEdges(int low, int high)
+{
+    this->low = low;
+    this->high = high;
+    state = UNKNOWN_STATE;
+    position = 0;
+    lastTransition = 0;
+    lastCrossing = 0;
+    hasCrossing = false;
+    risingEdges = 0;
+    fallingEdges = 0;
+    firstRise = 0;
+    lastRise = 0;
+    highSum = 0;
+    highSumAtLastRise = 0;
+    riseTimeSum = 0;
+    fallTimeSum = 0;
+    minHigh = SIZE_MAX;
+    maxHigh = 0;
+    minLow = SIZE_MAX;
+    maxLow = 0;
+}
+
+/**
+ * @brief Measurements::accumulateLevels adds samples [from, to) to sum, sum of squares, minimum and maximum.
+ * Samples are walked run by run of stored chunks, inner loop works on pieces small enough
+ * for 32 bit partial sums, so compiler can vectorize it.
+ * @param acc
+ * @param data
+ * @param bit
+ * @param from
+ * @param to
+ */
+void Measurements::accumulateLevels(Accumulator & acc, PlotData * data, int bit, size_t from, size_t to)
+{
+    for(size_t i = from; i < to;)
+    {
+        size_t length;
+        const unsigned char * run = data->getRun(bit, i, length);
+        size_t end = qMin<size_t>(qMin(to-i, length), LEVEL_CHUNK);
+        uint32_t sum = 0;
+        uint32_t squares = 0;
+        unsigned char minimum = 255;
+        unsigned char maximum = 0;
+        for(size_t j = 0; j < end; ++j)
+        {
+            unsigned char v = run[j];
+            sum += v;
+            squares += v*v;
+            minimum = v < minimum ? v : minimum;
+            maximum = v > maximum ? v : maximum;
+        }
+        acc.sum += sum;
+        acc.sumOfSquares += squares;
+        acc.minimum = qMin<int>(acc.minimum, minimum);
+        acc.maximum = qMax<int>(acc.maximum, maximum);
+        i += end;
+    }
+}
+
+/**
+ * @brief Measurements::analogLevels computes 10% and 90% levels between minimum and maximum.
+ * Signals with too small swing get levels which are never reached.
+ * @param acc
+ * @param low
+ * @param high
+ */
+void Measurements::analogLevels(const Accumulator & acc, int & low, int & high)
+{
+    int swing = acc.maximum-acc.minimum;
+    if(swing < MIN_SWING)
+    {
+        low = -1;
+        high = 256;
+        return;
+    }
+    low = acc.minimum+swing/10;
+    high = acc.maximum-swing/10;
+}
+
+/**
+ * @brief Measurements::accumulateEdges walks transitions between low and high levels up to sample to.
+ * Transition is searched forward, its start and middle crossing are then searched back,
+ * which never goes behind previous transition.
+ * @param acc
+ * @param data
+ * @param to
+ */
+void Measurements::accumulateEdges(Accumulator & acc, const BitSamples & data, size_t to)
+{
+    int mid = (acc.low+acc.high)/2;
+    size_t i = acc.position;
+    while(i < to)
+    {
+        if(acc.state == UNKNOWN_STATE)
+        {
+            i = findFirst(data, i, to, Outside(acc.low+1, acc.high-1));
+            if(i == to)
+                break;
+            acc.state = data[i] >= acc.high ? HIGH_STATE : LOW_STATE;
+            acc.lastTransition = i;
+            ++i;
+            continue;
+        }
+        bool rising = acc.state == LOW_STATE;
+        i = rising ? findFirst(data, i, to, AtLeast(acc.high)) : findFirst(data, i, to, AtMost(acc.low));
+        if(i == to)
+            break;
+        size_t start = rising ? findLast(data, acc.lastTransition, i, AtMost(acc.low)) : findLast(data, acc.lastTransition, i, AtLeast(acc.high));
+        size_t crossing = (rising ? findLast(data, start, i, AtMost(mid-1)) : findLast(data, start, i, AtLeast(mid+1)))+1;
+        if(acc.hasCrossing)
+        {
+            size_t width = crossing-acc.lastCrossing;
+            if(rising)
+            {
+                acc.minLow = qMin(acc.minLow, width);
+                acc.maxLow = qMax(acc.maxLow, width);
+            }
+            else
+            {
+                acc.minHigh = qMin(acc.minHigh, width);
+                acc.maxHigh = qMax(acc.maxHigh, width);
+                acc.highSum += width;
+            }
+        }
+        if(rising)
+        {
+            ++acc.risingEdges;
+            acc.riseTimeSum += i-start;
+            if(acc.risingEdges == 1)
+                acc.firstRise = crossing;
+            acc.lastRise = crossing;
+            acc.highSumAtLastRise = acc.highSum;
+        }
+        else
+        {
+            ++acc.fallingEdges;
+            acc.fallTimeSum += i-start;
+        }
+        acc.lastCrossing = crossing;
+        acc.hasCrossing = true;
+        acc.state = rising ? HIGH_STATE : LOW_STATE;
+        acc.lastTransition = i;
+        ++i;
+    }
+    acc.position = qMin(i, to);
+}
+
+/**
+ * @brief Measurements::result converts accumulated values to measurement.
+ * @param acc
+ * @param div length of one sample in ps.
+ * @param analog true if level statistics and edge times were accumulated.
+ * @return
+ */
+Measurement Measurements::result(const Accumulator & acc, uint64_t div, bool analog)
+{
+    Measurement m;
+    m.samples = acc.samples;
+    m.minimum = analog ? acc.minimum : 0;
+    m.maximum = analog ? acc.maximum : 0;
+    m.mean = analog and acc.samples > 0 ? static_cast<double>(acc.sum)/acc.samples : 0;
+    m.rms = analog and acc.samples > 0 ? sqrt(static_cast<double>(acc.sumOfSquares)/acc.samples) : 0;
+    m.risingEdges = acc.risingEdges;
+    m.fallingEdges = acc.fallingEdges;
+    m.period = 0;
+    m.dutyCycle = -1;
+    if(acc.risingEdges > 1 and acc.lastRise > acc.firstRise)
+    {
+        m.period = static_cast<double>(acc.lastRise-acc.firstRise)*div/(acc.risingEdges-1);
+        m.dutyCycle = 100.0*acc.highSumAtLastRise/(acc.lastRise-acc.firstRise);
+    }
+    m.riseTime = analog and acc.risingEdges > 0 ? static_cast<double>(acc.riseTimeSum)*div/acc.risingEdges : 0;
+    m.fallTime = analog and acc.fallingEdges > 0 ? static_cast<double>(acc.fallTimeSum)*div/acc.fallingEdges : 0;
+    m.minHighWidth = acc.minHigh == SIZE_MAX ? 0 : static_cast<double>(acc.minHigh)*div;
+    m.maxHighWidth = static_cast<double>(acc.maxHigh)*div;
+    m.minLowWidth = acc.minLow == SIZE_MAX ? 0 : static_cast<double>(acc.minLow)*div;
+    m.maxLowWidth = static_cast<double>(acc.maxLow)*div;
+    return m;
+}
+
+/**
+ * @brief Measurements::measure measures samples [from, to) of given bit.
+ * @param data
+ * @param bit bit of logic data, analog data have only bit 0.
+ * @param from
+ * @param to
+ * @return
+ */
+Measurement Measurements::measure(PlotData * data, int bit, size_t from, size_t to)
+{
+    Accumulator acc;
+    to = qMin(to, data->lastPositionOnBit(bit));
+    from = qMin(from, to);
+    bool analog = data->getType() == PlotData::Linear;
+    int low = LOW;
+    int high = HIGH;
+    if(analog)
+    {
+        accumulateLevels(acc, data, bit, from, to);
+        analogLevels(acc, low, high);
+    }
+    acc.samples = to-from;
+    acc.resetEdges(low, high);
+    acc.position = from;
+    acc.lastTransition = from;
+    accumulateEdges(acc, data->getSamples(bit), to);
+    return result(acc, data->getDiv(), analog);
+}
+
+/**
+ * @brief Measurements::measureWhole measures all samples of given bit.
+ * Only samples appended since last call are processed, unless data were rewritten
+ * or levels moved so much that edges have to be found again.
+ * @param data
+ * @param bit
+ * @return
+ */
+Measurement Measurements::measureWhole(PlotData * data, int bit)
+{
+    Cached & cached = cache[data];
+    Accumulator & acc = cached.accumulator;
+    if(cached.bit != bit or data->getDirtySince(acc.version).first < acc.samples)
+    {
+        acc = Accumulator();
+        cached.bit = bit;
+    }
+    size_t end = data->lastPositionOnBit(bit);
+    bool analog = data->getType() == PlotData::Linear;
+    if(analog)
+    {
+        accumulateLevels(acc, data, bit, acc.samples, end);
+        int low;
+        int high;
+        analogLevels(acc, low, high);
+        int tolerance = qMax(1, (high-low)/16);
+        if(qAbs(low-acc.low) > tolerance or qAbs(high-acc.high) > tolerance)
+        {
+            acc.resetEdges(low, high);
+        }
+    }
+    else if(acc.low != LOW or acc.high != HIGH)
+    {
+        acc.resetEdges(LOW, HIGH);
+    }
+    acc.samples = end;
+    accumulateEdges(acc, data->getSamples(bit), end);
+    acc.version = data->checkpointVersion();
+    return result(acc, data->getDiv(), analog);
+}
@@ -0,0 +1,121 @@
+//
+//   Measurements.h
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef QWave_Measurements_h
+#define QWave_Measurements_h
+
+#include <QMap>
+#include "PlotData.h"
+
+/**
+ * @brief The Measurement struct holds automatic measurements of one signal.
+ * Levels are in raw sample units, times in picoseconds, unknown times are 0
+ * and unknown duty cycle is negative.
+ */
+struct Measurement
+{
+    size_t samples;
+    int minimum;
+    int maximum;
+    double mean;
+    double rms;
+    uint64_t risingEdges;
+    uint64_t fallingEdges;
+    double period;
+    double riseTime;
+    double fallTime;
+    double dutyCycle;
+    double minHighWidth;
+    double maxHighWidth;
+    double minLowWidth;
+    double maxLowWidth;
+};
+
+/**
+ * @brief The Measurements class computes automatic measurements of analog plots and logic bits.
+ * Level statistics are reductions over chunks of samples, edge based measurements walk
+ * from transition to transition. Measurements of whole data are kept per data and
+ * updated only with samples appended since last call.
+ */
+class Measurements
+{
+    struct Accumulator
+    {
+        //level reductions
+        size_t samples;
+        uint64_t sum;
+        uint64_t sumOfSquares;
+        int minimum;
+        int maximum;
+        //edge state
+        int low;
+        int high;
+        int state;
+        size_t position;
+        size_t lastTransition;
+        size_t lastCrossing;
+        bool hasCrossing;
+        uint64_t risingEdges;
+        uint64_t fallingEdges;
+        size_t firstRise;
+        size_t lastRise;
+        uint64_t highSum;
+        uint64_t highSumAtLastRise;
+        uint64_t riseTimeSum;
+        uint64_t fallTimeSum;
+        size_t minHigh;
+        size_t maxHigh;
+        size_t minLow;
+        size_t maxLow;
+        //incremental update
+        uint64_t version;
+        Accumulator();
+        void resetEdges(int low, int high);
+    };
+    struct Cached
+    {
+        Accumulator accumulator;
+        int bit;
+        Cached() : bit(-1) {}
+    };
+    QMap<PlotData*, Cached> cache;
+    static void accumulateLevels(Accumulator & acc, PlotData * data, int bit, size_t from, size_t to);
+    static void accumulateEdges(Accumulator & acc, const BitSamples & data, size_t to);
+    static void analogLevels(const Accumulator & acc, int & low, int & high);
+    static Measurement result(const Accumulator & acc, uint64_t div, bool analog);
+public:
+    static Measurement measure(PlotData * data, int bit, size_t from, size_t to);
+    Measurement measureWhole(PlotData * data, int bit);
+    void forget(PlotData * data) { cache.remove(data); }
+    void clear() { cache.clear(); }
+};
+
+#endif
@@ -0,0 +1,239 @@
+//
+//   MemoryManager.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "MemoryManager.h"
+#include "ChunkPool.h"
+#include "SampleBuffer.h"
+#include "../Exceptions/Exception.h"
+#include "../Instrumentation/Profiler.h"
+#include <QMutexLocker>
+#include <QtAlgorithms>
+#include <unistd.h>
+
+/**
+ * @brief physicalMemory
+ * @return returns size of physical memory or 0 when it is not known.
+ */
+static size_t physicalMemory()
+{
+#if defined(_SC_PHYS_PAGES) && defined(_SC_PAGESIZE)
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if(pages > 0 and pageSize > 0)
+    {
+        return static_cast<size_t>(pages)*pageSize;
+    }
+#endif
+    return 0;
+}
+
+/**
+ * @brief lessRecentlyUsed orders buffers from least recently viewed.
+ */
+static bool lessRecentlyUsed(const SampleBuffer * first, const SampleBuffer * second)
+{
+    return first->getLastUse() < second->getLastUse();
+}
+
+MemoryManager::MemoryManager() : budget(physicalMemory()/2), useCounter(0), slotCount(0)
+{
+}
+
+MemoryManager::~MemoryManager()
+{
+}
+
+/**
+ * @brief MemoryManager::instance
+ * @return returns application wide memory manager.
+ */
+MemoryManager & MemoryManager::instance()
+{
+    static MemoryManager manager;
+    return manager;
+}
+
+/**
+ * @brief MemoryManager::setBudget sets memory samples can use, half of physical
+ * memory is default.
+ * @param bytes budget, 0 means no limit.
+ */
+void MemoryManager::setBudget(size_t bytes)
+{
+    QMutexLocker locker(&mutex);
+    budget = bytes;
+}
+
+size_t MemoryManager::getBudget()
+{
+    QMutexLocker locker(&mutex);
+    return budget;
+}
+
+/**
+ * @brief MemoryManager::getUsedBytes
+ * @return returns memory held by samples, both in chunks and packed.
+ */
+size_t MemoryManager::getUsedBytes()
+{
+    QMutexLocker locker(&mutex);
+    return getUsedBytesLocked();
+}
+
+size_t MemoryManager::getUsedBytesLocked()
+{
+    size_t used = ChunkPool::instance().getUsedBytes();
+    for(int i = 0; i < buffers.count(); ++i)
+    {
+        used += buffers.at(i)->getPackedBytes();
+    }
+    return used;
+}
+
+/**
+ * @brief MemoryManager::getSpilledBytes
+ * @return returns size of spill file in use.
+ */
+size_t MemoryManager::getSpilledBytes()
+{
+    QMutexLocker locker(&fileMutex);
+    return static_cast<size_t>(slotCount-freeSlots.count())*CHUNK_SIZE;
+}
+
+/**
+ * @brief MemoryManager::enforce spills chunks of least recently viewed buffers
+ * until used memory fits in budget. Nothing is spilled while other thread reads samples.
+ */
+void MemoryManager::enforce()
+{
+    if(not access.tryLockForWrite())
+    {
+        return;
+    }
+    QMutexLocker locker(&mutex);
+    size_t used = getUsedBytesLocked();
+    if(budget == 0 or used <= budget)
+    {
+        access.unlock();
+        return;
+    }
+    ScopedTimer timer(Profiler::Spill);
+    QList<SampleBuffer *> candidates = buffers;
+    qSort(candidates.begin(), candidates.end(), lessRecentlyUsed);
+    try
+    {
+        for(int i = 0; i < candidates.count() and used > budget; ++i)
+        {
+            if(candidates.at(i)->isSpillable())
+            {
+                size_t freed = candidates.at(i)->spill(used-budget);
+                used -= qMin(used, freed);
+            }
+        }
+    }
+    catch(Exception e)
+    {
+        // disk is full, samples stay in memory
+        qDebug() << e.getMessage();
+    }
+    ChunkPool::instance().shrink();
+    access.unlock();
+}
+
+/**
+ * @brief MemoryManager::addBuffer registers buffer, so its chunks can be spilled.
+ */
+void MemoryManager::addBuffer(SampleBuffer * buffer)
+{
+    QMutexLocker locker(&mutex);
+    buffers.append(buffer);
+}
+
+void MemoryManager::removeBuffer(SampleBuffer * buffer)
+{
+    QMutexLocker locker(&mutex);
+    buffers.removeOne(buffer);
+}
+
+/**
+ * @brief MemoryManager::spill writes data to free slot of spill file.
+ * @param data
+ * @param size at most CHUNK_SIZE bytes.
+ * @return returns slot holding data.
+ */
+int MemoryManager::spill(const char * data, int size)
+{
+    QMutexLocker locker(&fileMutex);
+    if(not spillFile.isOpen() and not spillFile.open())
+    {
+        throw Exception("Cannot open spill file.");
+    }
+    int slot;
+    if(freeSlots.isEmpty())
+    {
+        slot = slotCount++;
+    }
+    else
+    {
+        slot = freeSlots.last();
+        freeSlots.pop_back();
+    }
+    if(not spillFile.seek(static_cast<qint64>(slot)*CHUNK_SIZE) or spillFile.write(data, size) != size)
+    {
+        freeSlots.append(slot);
+        throw Exception("Cannot write spill file: "+spillFile.errorString());
+    }
+    return slot;
+}
+
+/**
+ * @brief MemoryManager::load reads spilled data back.
+ * @param slot slot returned by spill.
+ * @param data
+ * @param size size of spilled data.
+ */
+void MemoryManager::load(int slot, char * data, int size)
+{
+    QMutexLocker locker(&fileMutex);
+    if(not spillFile.seek(static_cast<qint64>(slot)*CHUNK_SIZE) or spillFile.read(data, size) != size)
+    {
+        throw Exception("Cannot read spill file: "+spillFile.errorString());
+    }
+}
+
+/**
+ * @brief MemoryManager::freeSlot makes slot available for other data.
+ */
+void MemoryManager::freeSlot(int slot)
+{
+    QMutexLocker locker(&fileMutex);
+    freeSlots.append(slot);
+}
@@ -0,0 +1,89 @@
+//
+//   MemoryManager.h
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef QWave_MemoryManager_h
+#define QWave_MemoryManager_h
+
+#include <QVector>
+#include <QList>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QTemporaryFile>
+#include <inttypes.h>
+#include <stddef.h>
+
+class SampleBuffer;
+
+/**
+ * @brief The MemoryManager class keeps samples of all sample buffers within budget.
+ * When more memory is used, full chunks of least recently viewed buffers are written
+ * to temporary spill file and their memory is freed. Spilled chunks are read back
+ * into BlockCache when they are viewed again, so readers do not notice.
+ *
+ * Chunks are spilled only by enforce, which has to be called from thread of event loop,
+ * where samples are painted. Buffer still written by other thread is never spilled and
+ * other threads reading samples have to hold read lock of getAccessLock meanwhile.
+ */
+class MemoryManager
+{
+public:
+    static MemoryManager & instance();
+    void setBudget(size_t bytes);
+    size_t getBudget();
+    size_t getUsedBytes();
+    size_t getSpilledBytes();
+    void enforce();
+    QReadWriteLock * getAccessLock() { return &access; }
+    uint64_t nextUse() { return ++useCounter; }
+    void addBuffer(SampleBuffer * buffer);
+    void removeBuffer(SampleBuffer * buffer);
+    int spill(const char * data, int size);
+    void load(int slot, char * data, int size);
+    void freeSlot(int slot);
+private:
+    MemoryManager();
+    ~MemoryManager();
+    MemoryManager(const MemoryManager &);
+    MemoryManager & operator=(const MemoryManager &);
+    size_t getUsedBytesLocked();
+    QMutex mutex;
+    QMutex fileMutex;
+    QReadWriteLock access;
+    QList<SampleBuffer *> buffers;
+    size_t budget;
+    uint64_t useCounter;
+    QTemporaryFile spillFile;
+    QVector<int> freeSlots;
+    int slotCount;
+};
+
+#endif
@@ -0,0 +1,273 @@
+//
+//   PatternSearch.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "PatternSearch.h"
+#include "Constants.h"
+#include <QtConcurrentRun>
+#include <QFuture>
+#include <QThread>
+#include <QtAlgorithms>
+#include <string.h>
+
+static const size_t WORD_SAMPLES = 64;
+static const size_t PARALLEL_THRESHOLD = 1 << 20;
+
+/**
+ * @brief lowestBit
+ * @param word non zero word.
+ * @return returns index of lowest set bit.
+ */
+static inline int lowestBit(uint64_t word)
+{
+#ifdef __GNUC__
+    return __builtin_ctzll(word);
+#else
+    int bit = 0;
+    while(not (word & 1))
+    {
+        word >>= 1;
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+/**
+ * @brief packHigh packs samples into word, bit j is set if sample j is HIGH.
+ * On little endian machines eight samples are tested at once: byte of inverted samples
+ * is non zero unless sample is HIGH, this is moved into most significant bit of each byte
+ * and those bits are gathered into one byte by multiplication.
+ * @param samples
+ * @param count at most 64 samples.
+ * @return
+ */
+static inline uint64_t packHigh(const unsigned char * samples, size_t count)
+{
+    uint64_t word = 0;
+    size_t j = 0;
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    const uint64_t low7 = 0x7F7F7F7F7F7F7F7FULL;
+    const uint64_t msb = 0x8080808080808080ULL;
+    for(; j+8 <= count; j += 8)
+    {
+        uint64_t x;
+        memcpy(&x, samples+j, sizeof(x));
+        uint64_t y = ~x;
+        uint64_t notHigh = ((y & low7)+low7) | y;
+        uint64_t high = ~notHigh & msb;
+        word |= ((high*0x0002040810204081ULL) >> 56) << j;
+    }
+#endif
+    for(; j < count; ++j)
+    {
+        word |= static_cast<uint64_t>(samples[j] == HIGH) << j;
+    }
+    return word;
+}
+
+PatternSearch::PatternSearch() : levelMask(0), levelValue(0), risingMask(0), fallingMask(0), edgeMask(0), data(NULL)
+{
+}
+
+/**
+ * @brief PatternSearch::clear forgets searched data and its matches, call before data is deleted or rewritten.
+ */
+void PatternSearch::clear()
+{
+    data = NULL;
+    hits.clear();
+}
+
+/**
+ * @brief PatternSearch::setPattern parses pattern written from highest bit. Each bit is one of
+ * '0', '1', 'X' (don't care), 'R' (rising edge), 'F' (falling edge) or 'E' (any edge).
+ * Missing high bits are don't care, spaces and underscores are ignored.
+ * E.g. "11010XXR" matches bits 7..3 equal 0x1A while bit 0 rises.
+ * @param text
+ * @return returns false if text is not valid pattern, previous pattern is kept then.
+ */
+bool PatternSearch::setPattern(const QString & text)
+{
+    QString compact = text.toUpper();
+    compact.remove(' ');
+    compact.remove('_');
+    if(compact.isEmpty() or compact.length() > PATTERN_BITS)
+        return false;
+    uint32_t masks[5] = { 0, 0, 0, 0, 0 };
+    for(int i = 0; i < compact.length(); ++i)
+    {
+        uint32_t bit = 1u << (compact.length()-1-i);
+        switch(compact.at(i).toLatin1())
+        {
+        case '1':
+            masks[1] |= bit;
+            // level bit, falls through
+        case '0':
+            masks[0] |= bit;
+            break;
+        case 'R':
+            masks[2] |= bit;
+            break;
+        case 'F':
+            masks[3] |= bit;
+            break;
+        case 'E':
+            masks[4] |= bit;
+            break;
+        case 'X':
+            break;
+        default:
+            return false;
+        }
+    }
+    levelMask = masks[0];
+    levelValue = masks[1];
+    risingMask = masks[2];
+    fallingMask = masks[3];
+    edgeMask = masks[4];
+    pattern = compact;
+    return true;
+}
+
+/**
+ * @brief PatternSearch::searchRange searches samples [from, to), from has to be multiple of word size.
+ * @return returns sorted indexes of matching samples, at most MAX_HITS.
+ */
+QVector<size_t> PatternSearch::searchRange(size_t from, size_t to)
+{
+    QVector<size_t> found;
+    uint32_t used = levelMask | risingMask | fallingMask | edgeMask;
+    int width = data->getBitwidth();
+    QVector<int> bits;
+    for(int bit = 0; bit < width and bit < PATTERN_BITS; ++bit)
+    {
+        if(used & (1u << bit))
+            bits.append(bit);
+    }
+    for(size_t i = from; i < to; i += WORD_SAMPLES)
+    {
+        size_t count = qMin(WORD_SAMPLES, to-i);
+        uint64_t match = count == WORD_SAMPLES ? ~0ULL : (1ULL << count)-1;
+        for(int b = 0; b < bits.size() and match != 0; ++b)
+        {
+            uint32_t bit = 1u << bits.at(b);
+            // pattern counts bits from lowest, data store highest bit first
+            int dataBit = width-1-bits.at(b);
+            // words are aligned and chunk size is multiple of word, so word never spans two chunks
+            size_t length;
+            uint64_t word = packHigh(data->getRun(dataBit, i, length), count);
+            // previous sample of first sample in data is sample itself, so there is no edge
+            uint64_t first = i > 0 ? data->at(dataBit, i-1) == HIGH : word & 1;
+            uint64_t previous = (word << 1) | first;
+            if(levelMask & bit)
+                match &= (levelValue & bit) ? word : ~word;
+            if(risingMask & bit)
+                match &= word & ~previous;
+            if(fallingMask & bit)
+                match &= ~word & previous;
+            if(edgeMask & bit)
+                match &= word ^ previous;
+        }
+        while(match != 0)
+        {
+            if(found.size() >= MAX_HITS)
+                return found;
+            found.append(i+lowestBit(match));
+            match &= match-1;
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief PatternSearch::search finds all samples of data matching current pattern.
+ * @param data logic data, only bits present in data are tested.
+ */
+void PatternSearch::search(PlotData * data)
+{
+    this->data = data;
+    hits.clear();
+    if(data == NULL or data->getType() != PlotData::Logic)
+        return;
+    uint32_t used = levelMask | risingMask | fallingMask | edgeMask;
+    if(data->getBitwidth() < PATTERN_BITS and (used >> data->getBitwidth()) != 0)
+        return; // pattern uses bits above highest bit of data
+    size_t length = data->lastPositionOnBit(0);
+    for(int bit = 1; bit < data->getBitwidth(); ++bit)
+    {
+        length = qMin(length, data->lastPositionOnBit(bit));
+    }
+    int threads = length < PARALLEL_THRESHOLD ? 1 : qMax(1, QThread::idealThreadCount());
+    size_t rangeLength = ((length/threads+WORD_SAMPLES-1)/WORD_SAMPLES)*WORD_SAMPLES;
+    QVector<QFuture<QVector<size_t> > > futures;
+    for(size_t from = 0; from < length; from += rangeLength)
+    {
+        futures.append(QtConcurrent::run(this, &PatternSearch::searchRange, from, qMin(length, from+rangeLength)));
+    }
+    for(int i = 0; i < futures.size(); ++i)
+    {
+        QVector<size_t> found = futures[i].result();
+        for(int j = 0; j < found.size() and hits.size() < MAX_HITS; ++j)
+        {
+            hits.append(found.at(j));
+        }
+    }
+}
+
+/**
+ * @brief PatternSearch::findNext
+ * @param sample
+ * @param hit found sample.
+ * @return returns false if there is no hit after sample.
+ */
+bool PatternSearch::findNext(size_t sample, size_t & hit)
+{
+    QVector<size_t>::const_iterator it = qUpperBound(hits.constBegin(), hits.constEnd(), sample);
+    if(it == hits.constEnd())
+        return false;
+    hit = *it;
+    return true;
+}
+
+/**
+ * @brief PatternSearch::findPrevious
+ * @param sample
+ * @param hit found sample.
+ * @return returns false if there is no hit before sample.
+ */
+bool PatternSearch::findPrevious(size_t sample, size_t & hit)
+{
+    QVector<size_t>::const_iterator it = qLowerBound(hits.constBegin(), hits.constEnd(), sample);
+    if(it == hits.constBegin())
+        return false;
+    hit = *(it-1);
+    return true;
+}
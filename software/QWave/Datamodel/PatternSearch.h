@@ -0,0 +1,70 @@
+//
+//   PatternSearch.h
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef QWave_PatternSearch_h
+#define QWave_PatternSearch_h
+
+#include <QVector>
+#include <QString>
+#include "PlotData.h"
+
+/**
+ * @brief The PatternSearch class finds samples of logic data matching pattern of levels and edges.
+ * Pattern is compiled into bit masks, samples of each used bit are packed into 64 bit words
+ * on the fly and whole word of samples is tested by few bitwise operations.
+ * Long data are split into ranges searched in parallel.
+ */
+class PatternSearch
+{
+    uint32_t levelMask;
+    uint32_t levelValue;
+    uint32_t risingMask;
+    uint32_t fallingMask;
+    uint32_t edgeMask;
+    QString pattern;
+    PlotData * data;
+    QVector<size_t> hits;
+    QVector<size_t> searchRange(size_t from, size_t to);
+public:
+    static const int PATTERN_BITS = 32;
+    static const int MAX_HITS = 1 << 22;
+    PatternSearch();
+    bool setPattern(const QString & text);
+    const QString & getPattern() { return pattern; }
+    void search(PlotData * data);
+    void clear();
+    PlotData * getData() { return data; }
+    const QVector<size_t> & getHits() { return hits; }
+    bool findNext(size_t sample, size_t & hit);
+    bool findPrevious(size_t sample, size_t & hit);
+};
+
+#endif
@@ -36,58 +36,296 @@
 
 #include "PlotData.h"
 #include "../Exceptions/Exception.h"
+#include "../Instrumentation/Profiler.h"
 #include <QDebug>
+#include <QStringList>
+#include <string.h>
 
-static const size_t PREALLOCATE = 100;
+static const int MAX_CHECKPOINTS = 16;
 
-PlotData::PlotData(int type, QString name, uint64_t divInPs, int width, char sign) : type(type), name(name), divInPs(divInPs), bitwidth(width), sign(sign), isShadow(false)
+/**
+ * @brief PlotData::PlotData creates data with new buffer.
+ * @param type
+ * @param name
+ * @param divInPs
+ * @param width
+ * @param sign
+ * @param timestamped if true samples are appended as events, which is cheaper
+ * for sparse changes like in VCD files.
+ */
+PlotData::PlotData(int type, QString name, uint64_t divInPs, int width, char sign, bool timestamped) : type(type), nameId(StringPool::instance().intern(name)), divInPs(divInPs), bitwidth(width), sign(sign), offset(0), end(SIZE_MAX)
 {
-    data = new QVector<unsigned char *>;
-    dataPosition = new QVector<size_t>;
-    dataAllocated = new QVector<size_t>;
-    for (int i = 0; i < bitwidth; ++i)
+    buffer = new SampleBuffer(bitwidth, timestamped);
+    buffer->ref();
+    for(int i = 0; i < bitwidth; ++i)
     {
-        unsigned char * newData = static_cast<unsigned char*>(malloc(PREALLOCATE*sizeof(unsigned char)));
-        if(newData == NULL)
+        bits.append(i);
+    }
+}
+
+/**
+ * @brief PlotData::PlotData creates another view of samples in buffer, no samples are copied.
+ * @param type
+ * @param name
+ * @param divInPs
+ * @param sign
+ * @param buffer buffer of existing data.
+ */
+PlotData::PlotData(int type, QString name, uint64_t divInPs, char sign, SampleBuffer * buffer) : type(type), nameId(StringPool::instance().intern(name)), divInPs(divInPs), bitwidth(buffer->getBitwidth()), sign(sign), buffer(buffer), offset(0), end(SIZE_MAX)
+{
+    buffer->ref();
+    for(int i = 0; i < bitwidth; ++i)
+    {
+        bits.append(i);
+    }
+}
+
+/**
+ * @brief PlotData::PlotData creates view of some bits and samples of source, computed on read
+ * from samples of source, so it costs no memory for samples. View of data which are still
+ * captured grows with them unless its end is given.
+ * @param source
+ * @param name
+ * @param sign
+ * @param sourceBits bits of source shown by view, first of them is most significant bit of view.
+ * @param from first sample of source shown by view.
+ * @param to first sample of source not shown by view.
+ */
+PlotData::PlotData(PlotData * source, QString name, char sign, const QVector<int> & sourceBits, size_t from, size_t to) : type(source->type), nameId(StringPool::instance().intern(name)), divInPs(source->divInPs), bitwidth(sourceBits.size()), sign(sign), buffer(source->buffer)
+{
+    if(sourceBits.isEmpty())
+    {
+        throw Exception("View has to show at least one bit.");
+    }
+    for(int i = 0; i < sourceBits.size(); ++i)
+    {
+        if(sourceBits.at(i) < 0 or sourceBits.at(i) >= source->bitwidth)
         {
-            throw Exception("Cannot allocate memory.");
+            throw Exception("Bit "+QString::number(sourceBits.at(i))+" is not in "+source->getName()+".");
         }
-        data->append(newData);
-        dataPosition->append(0);
-        dataAllocated->append(PREALLOCATE);
+        bits.append(source->bits.at(sourceBits.at(i)));
+    }
+    end = to > source->end-source->offset ? source->end : source->offset+to;
+    offset = from > end-source->offset ? end : source->offset+from;
+    buffer->ref();
+}
+
+PlotData::~PlotData()
+{
+    if(not buffer->deref())
+    {
+        delete(buffer);
     }
+    qDebug() << "deleted PlotData: " << getName() << "sign: " << sign;
+}
+
+/**
+ * @brief PlotData::lastPositionOnBit
+ * @param bitNumber
+ * @return returns number of samples of bit visible in this view.
+ */
+size_t PlotData::lastPositionOnBit(int bitNumber) const
+{
+    size_t length = qMin(buffer->getLength(bits.at(bitNumber)), end);
+    return length > offset ? length-offset : 0;
 }
 
-PlotData::PlotData(int type, QString name, uint64_t divInPs, int width, char sign, QVector<unsigned char *> * shadowData, QVector<size_t> * shadowDataPosition, QVector<size_t> * shadowDataAllocated) : type(type), name(name), divInPs(divInPs), bitwidth(width), sign(sign), isShadow(true)
+/**
+ * @brief PlotData::getRun gives direct access to stored samples, data are
+ * contiguous only inside of chunk, so longer ranges are walked run by run.
+ * @param bitNumber
+ * @param sample first sample of run, has to be less than lastPositionOnBit.
+ * @param length returns number of samples readable from returned pointer.
+ * @return returns pointer to sample.
+ */
+const unsigned char * PlotData::getRun(int bitNumber, size_t sample, size_t & length) const
 {
-    data = shadowData;
-    dataPosition = shadowDataPosition;
-    dataAllocated = shadowDataAllocated;
+    const unsigned char * run = buffer->getRun(bits.at(bitNumber), offset+sample, length);
+    length = qMin(length, lastPositionOnBit(bitNumber)-sample);
+    return run;
+}
+
+/**
+ * @brief PlotData::copySamples copies samples [from, from+count) of bit into out.
+ * @param bitNumber
+ * @param from
+ * @param count
+ * @param out
+ */
+void PlotData::copySamples(int bitNumber, size_t from, size_t count, unsigned char * out) const
+{
+    while(count > 0)
+    {
+        size_t length;
+        const unsigned char * run = getRun(bitNumber, from, length);
+        length = qMin(length, count);
+        memcpy(out, run, length*sizeof(unsigned char));
+        out += length;
+        from += length;
+        count -= length;
+    }
 }
 
 /**
- * @brief PlotData::appendDataAtBit appends new data newData at bitNumber bit.
- * @param bitNumber bit number to append data on.
- * @param newData new data to append.
+ * @brief PlotData::parseBits parses list of bits like "7..4" or "0, 2, 5..6". Bits are numbered
+ * from least significant bit, 0 is last bit of data. Bits are returned in given order,
+ * first is most significant, as indexes of bits of data.
+ * @param bitList
+ * @param bitwidth width of data.
+ * @return returns indexes of bits usable as sourceBits of view.
  */
-void PlotData::appendDataAtBit(int bitNumber, unsigned char newData)
+QVector<int> PlotData::parseBits(const QString & bitList, int bitwidth)
 {
-    if(dataPosition->at(bitNumber) >= dataAllocated->at(bitNumber))
+    QVector<int> result;
+    QStringList parts = bitList.split(',', QString::SkipEmptyParts);
+    for(int i = 0; i < parts.size(); ++i)
     {
-        (*dataAllocated)[bitNumber] = dataAllocated->at(bitNumber)*2;
-        unsigned char * newData = data->at(bitNumber);
-        (*data)[bitNumber] = static_cast<unsigned char*>(realloc(newData, dataAllocated->at(bitNumber)*sizeof(unsigned char)));
-        if(data->at(bitNumber) == NULL)
+        QStringList range = parts.at(i).split("..");
+        bool ok;
+        int first = range.first().trimmed().toInt(&ok);
+        int last = first;
+        if(ok and range.size() == 2)
         {
-            throw Exception("Cannot reallocate memory.");
+            last = range.last().trimmed().toInt(&ok);
+        }
+        if(not ok or range.size() > 2)
+        {
+            throw Exception("Cannot parse bits: "+parts.at(i));
+        }
+        int step = first <= last ? 1 : -1;
+        for(int bit = first; bit != last+step; bit += step)
+        {
+            if(bit < 0 or bit >= bitwidth)
+            {
+                throw Exception("Bit "+QString::number(bit)+" is out of range 0.."+QString::number(bitwidth-1)+".");
+            }
+            result.append(bitwidth-1-bit);
         }
     }
-    //qDebug() << "Adding: " << newData << " to " << dataPosition[bitNumber];
-    if(dataPosition->at(bitNumber) > 9990 and dataPosition->at(bitNumber) < 10020)
+    if(result.isEmpty())
     {
-        qDebug() << "Adding: " << newData << " to bit: " << bitNumber << " to pos: " << (*dataPosition)[bitNumber];
+        throw Exception("No bits given.");
     }
-    data->at(bitNumber)[(*dataPosition)[bitNumber]++] = newData;
+    return result;
+}
+
+/**
+ * @brief PlotData::trim keeps only samples in range [from, to) on every bit.
+ * Sealed samples are only hidden by moving window of this view. Samples which are
+ * still being appended are trimmed in buffer, so buffer shared with other views
+ * has to be trimmed once and other views rebased, see PlotTreeModel::trim.
+ * @param from first sample to keep.
+ * @param to first sample not to keep.
+ */
+void PlotData::trim(size_t from, size_t to)
+{
+    size_t last = to > end-offset ? end : offset+to;
+    size_t first = from > last-offset ? last : offset+from;
+    if(buffer->isSealed())
+    {
+        offset = first;
+        end = last;
+        buffer->markRewritten();
+    }
+    else
+    {
+        buffer->trim(first, last);
+        rebase(first, last);
+    }
+    checkpoints.clear();
+}
+
+/**
+ * @brief PlotData::rebase moves window of this view after its buffer was trimmed
+ * to samples [from, to), window is cut to kept samples.
+ * @param from
+ * @param to
+ */
+void PlotData::rebase(size_t from, size_t to)
+{
+    offset = qMin(qMax(offset, from), to)-from;
+    if(end != SIZE_MAX)
+    {
+        end = qMin(qMax(end, from), to)-from;
+    }
+    checkpoints.clear();
+}
+
+/**
+ * @brief PlotData::shortestLength
+ * @return returns number of samples on bit with least samples.
+ */
+size_t PlotData::shortestLength()
+{
+    if(bitwidth == 0)
+        return 0;
+    size_t length = lastPositionOnBit(0);
+    for(int i = 1; i < bitwidth; ++i)
+    {
+        if(lastPositionOnBit(i) < length)
+        {
+            length = lastPositionOnBit(i);
+        }
+    }
+    return length;
+}
+
+/**
+ * @brief PlotData::longestLength
+ * @return returns number of samples on bit with most samples.
+ */
+size_t PlotData::longestLength()
+{
+    size_t length = 0;
+    for(int i = 0; i < bitwidth; ++i)
+    {
+        if(lastPositionOnBit(i) > length)
+        {
+            length = lastPositionOnBit(i);
+        }
+    }
+    return length;
+}
+
+/**
+ * @brief PlotData::checkpointVersion returns current version of data and remembers
+ * how much data was there at that version, so later getDirtySince can tell
+ * which samples were appended since.
+ * @return current version.
+ */
+uint64_t PlotData::checkpointVersion()
+{
+    uint64_t version = buffer->getVersion();
+    if(not checkpoints.contains(version))
+    {
+        if(checkpoints.count() >= MAX_CHECKPOINTS)
+        {
+            checkpoints.erase(checkpoints.begin());
+        }
+        checkpoints.insert(version, shortestLength());
+    }
+    return version;
+}
+
+/**
+ * @brief PlotData::getDirtySince
+ * @param sinceVersion version obtained earlier by checkpointVersion.
+ * @return returns range of samples [first, second) changed since given version.
+ * Empty range means no change, whole data are returned if data was rewritten
+ * or version is unknown.
+ */
+QPair<size_t, size_t> PlotData::getDirtySince(uint64_t sinceVersion)
+{
+    size_t length = longestLength();
+    if(sinceVersion == buffer->getVersion())
+    {
+        return QPair<size_t, size_t>(length, length);
+    }
+    if(sinceVersion < buffer->getRewriteVersion() or not checkpoints.contains(sinceVersion))
+    {
+        return QPair<size_t, size_t>(0, length);
+    }
+    return QPair<size_t, size_t>(checkpoints.value(sinceVersion), length);
 }
 
 /**
@@ -98,14 +336,32 @@ void PlotData::appendDataAtBit(int bitNumber, unsigned char newData)
  */
 uint64_t  PlotData::getNearestTimeOnBit(uint64_t from, int bit)
 {
-    if(dataPosition->at(bit) == from)
+    size_t length = lastPositionOnBit(bit);
+    if(length == from)
     {
         return UINT64_MAX;
     }
-    uint8_t valueOrigin = data->at(bit)[from];
-    for(; from < dataPosition->at(bit); ++from)
+    uint8_t valueOrigin = at(bit, from);
+    if(buffer->isTimestamped())
+    {
+        // only events can change value, so samples between them are skipped
+        for(size_t event = buffer->findEvent(offset+from)+1; event < buffer->getEventCount(); ++event)
+        {
+            size_t time = buffer->getEventTime(event)-offset;
+            if(time >= length)
+            {
+                break;
+            }
+            if(buffer->getEventValue(bits.at(bit), event) != valueOrigin)
+            {
+                return time;
+            }
+        }
+        return length;
+    }
+    for(; from < length; ++from)
     {
-        if(data->at(bit)[from] != valueOrigin)
+        if(at(bit, from) != valueOrigin)
         {
             return from;
         }
@@ -121,7 +377,7 @@ uint64_t  PlotData::getNearestTimeOnBit(uint64_t from, int bit)
 uint64_t PlotData::getNearestTime(uint64_t from)
 {
     uint64_t time = UINT64_MAX;
-    for(int i = 0; i < data->count(); ++i)
+    for(int i = 0; i < bitwidth; ++i)
     {
         uint64_t tm = getNearestTimeOnBit(from, i);
         if(tm < time)
@@ -139,10 +395,10 @@ uint64_t PlotData::getNearestTime(uint64_t from)
  */
 bool PlotData::comparePrevious(uint64_t from)
 {
-    for(int i = 0; i < data->count(); ++i)
+    for(int i = 0; i < bitwidth; ++i)
     {
-        qDebug() << data->at(i)[from] << " vs " << data->at(i)[from-1];
-        if(data->at(i)[from] != data->at(i)[from-1])
+        qHotDebug() << at(i, from) << " vs " << at(i, from-1);
+        if(at(i, from) != at(i, from-1))
         {
             return true;
         }
@@ -36,69 +36,74 @@
 #include <QObject>
 #include <QPair>
 #include <QVector>
+#include <QMap>
 #include <QDebug>
 #include <inttypes.h>
+#include "SampleBuffer.h"
+#include "StringPool.h"
 
 static const int DEFAULT_DIV = 1;
+static const size_t ALL_SAMPLES = ~static_cast<size_t>(0);
+
 /**
  * Represents DATAMODEL of plot.
- * holds pointer to vector of data
+ * PlotData is view of samples in shared SampleBuffer, so signal appearing in several
+ * scopes or plots is stored once. View shows window of buffer samples starting at
+ * offset, which moves when sealed samples are trimmed, and maps its bits to bits
+ * of buffer, so any subset or order of bits can be shown as new signal.
+ * Sample number is always time in divs, whether buffer stores uniform samples
+ * or timestamped events.
  */
 class PlotData
 {
-    bool isShadow;
-    QString name;
+    int nameId;
     char sign;
     int type;
     int bitwidth;
-    QVector<unsigned char *> * data;
-    QVector<size_t> * dataPosition;
-    QVector<size_t> * dataAllocated;
+    SampleBuffer * buffer;
+    QVector<int> bits;
+    size_t offset;
+    size_t end;
     uint64_t divInPs;
+    QMap<uint64_t, size_t> checkpoints;
     uint64_t getNearestTimeOnBit(uint64_t from, int bit);
+    size_t shortestLength();
+    size_t longestLength();
+    PlotData(const PlotData &);
+    PlotData & operator=(const PlotData &);
 public:
     enum PlotType { Logic, Linear };
-    PlotData(int type, QString name, uint64_t divInPs, int width, char sign);
-    PlotData(int type, QString name, uint64_t divInPs, int width, char sign, QVector<unsigned char *> * shadowData, QVector<size_t> * shadowDataPosition, QVector<size_t> * shadowDataAllocated);
-    ~PlotData()
-    {
-        if(isShadow)
-            return;
-        for(int i = 0; i < data->size(); ++i)
-        {
-            free(data->at(i));
-        }
-        delete(data);
-        delete(dataPosition);
-        delete(dataAllocated);
-        qDebug() << "deleted PlotData: " << name << "sign: " << sign;
-    }
-    
-    void setDataAtBit(int bitNumber, unsigned char * newData)
-    {
-        delete(data->at(bitNumber));
-        (*data)[bitNumber] = newData;
-    }
-    QVector<unsigned char *> * getShadowData() { return data; }
-    QVector<size_t> * getShadowDataPosition() { return dataPosition; }
-    QVector<size_t> * getShadowDataAllocated() { return dataAllocated; }
-    bool getIsShadow() { return isShadow; }
-    unsigned char * getDataAtBit(int bitNumber)
-    {
-        if(bitNumber <= data->count())
-            return data->at(bitNumber);
-        else
-            return NULL;
-    }
+    PlotData(int type, QString name, uint64_t divInPs, int width, char sign, bool timestamped = false);
+    PlotData(int type, QString name, uint64_t divInPs, char sign, SampleBuffer * buffer);
+    PlotData(PlotData * source, QString name, char sign, const QVector<int> & sourceBits, size_t from = 0, size_t to = ALL_SAMPLES);
+    ~PlotData();
+    static QVector<int> parseBits(const QString & bitList, int bitwidth);
+    SampleBuffer * getBuffer() { return buffer; }
+    bool isTimestamped() const { return buffer->isTimestamped(); }
+    void setCompressed(bool compressed) { buffer->setCompressed(compressed); }
+    unsigned char at(int bitNumber, size_t sample) const { return buffer->at(bits.at(bitNumber), offset+sample); }
+    BitSamples getSamples(int bitNumber) const { return buffer->getSamples(bits.at(bitNumber), offset); }
+    const unsigned char * getRun(int bitNumber, size_t sample, size_t & length) const;
+    void copySamples(int bitNumber, size_t from, size_t count, unsigned char * out) const;
     int getType() { return type; }
     char getSign() { return sign; }
     int getBitwidth() { return bitwidth; }
-    const QString & getName() const { return name; }
+    QString getName() const { return StringPool::instance().at(nameId); }
+    int getNameId() const { return nameId; }
     uint64_t getDiv() { return divInPs; }
-    void setDiv(uint64_t div) { this->divInPs = div; }
-    void appendDataAtBit(int bitNumber, unsigned char newData);
-    size_t lastPositionOnBit(int bitNumber) { return dataPosition->at(bitNumber); }
+    void setDiv(uint64_t div) { this->divInPs = div; buffer->markRewritten(); }
+    void appendDataAtBit(int bitNumber, unsigned char newData) { buffer->append(bits.at(bitNumber), newData); }
+    void appendDataAtBit(int bitNumber, const unsigned char * newData, size_t count) { buffer->append(bits.at(bitNumber), newData, count); }
+    void appendEvent(size_t sample) { buffer->appendEvent(offset+sample); }
+    void setEventValue(int bitNumber, unsigned char value) { buffer->setEventValue(bits.at(bitNumber), value); }
+    void extend(size_t length) { buffer->extend(offset+length); }
+    size_t lastPositionOnBit(int bitNumber) const;
+    void trim(size_t from, size_t to);
+    void rebase(size_t from, size_t to);
     uint64_t getNearestTime(uint64_t from);
+    uint64_t getVersion() const { return buffer->getVersion(); }
+    uint64_t checkpointVersion();
+    QPair<size_t, size_t> getDirtySince(uint64_t sinceVersion);
     bool comparePrevious(uint64_t from);
 };
 
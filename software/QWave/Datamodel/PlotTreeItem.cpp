@@ -48,7 +48,6 @@
 
 PlotTreeItem::~PlotTreeItem()
 {
-    qDebug() << "Deleting item ";
     for(int i = 0; i < data.size(); ++i)
     {
         delete(data.at(i));
@@ -178,13 +177,12 @@ void PlotTreeItem::loadFromFile(FileSplitter & splitter, uint64_t divInNs, QHash
             PlotData * newPlotData;
             if(signToData.contains(datasign))
             {
-                newPlotData = new PlotData(plotType, dataname, divInNs, bitwidth, datasign,
-                                                      signToData[datasign]->getShadowData(), signToData[datasign]->getShadowDataPosition(),
-                                                      signToData[datasign]->getShadowDataAllocated());
+                newPlotData = new PlotData(plotType, dataname, divInNs, datasign, signToData[datasign]->getBuffer());
             }
             else
             {
-                newPlotData = new PlotData(plotType, dataname, divInNs, bitwidth, datasign);
+                // VCD gives only changes of values, so only they are stored
+                newPlotData = new PlotData(plotType, dataname, divInNs, bitwidth, datasign, true);
                 signToData[datasign] = newPlotData;
             }
             data.append(newPlotData);
@@ -37,24 +37,43 @@
 #include "FileSplitter.h"
 #include "../Exceptions/IOException.h"
 #include <QVector>
-#include <QStandardItem>
+#include <QTextStream>
+#include <QHash>
 
 /**
- * @brief The PlotTreeItem class represents item in node hierarchy of plots.
+ * @brief The PlotTreeItem class represents scope in node hierarchy of plots.
+ * Scopes are kept in flat table of PlotTreeModel and refer to their parent and
+ * children by index in that table, name of scope is interned by model.
  */
-class PlotTreeItem : public QStandardItem
+class PlotTreeItem
 {
 private:
+    int id;
+    int nameId;
+    int parentId;
+    int row;
+    int fetchedRows;
+    QVector<int> children;
     QVector<PlotData *> data;
 public:
     void setPlotData(QVector<PlotData *> newData);
     void appendPlotData(PlotData* data) { this->data.push_back(data); }
     QVector<PlotData *> plotData();
+    bool containsPlotData(PlotData * data) const { return this->data.contains(data); }
+    int getId() const { return id; }
+    int getNameId() const { return nameId; }
+    int getParentId() const { return parentId; }
+    int getRow() const { return row; }
+    int childCount() const { return children.count(); }
+    int childAt(int row) const { return children.at(row); }
+    void appendChild(int childId) { children.push_back(childId); }
+    int getFetchedRows() const { return fetchedRows; }
+    void setFetchedRows(int rows) { fetchedRows = rows; }
     void printSignals(QTextStream& out);
     void loadFromFile(FileSplitter & splitter, uint64_t divInNs, QHash<char, PlotData*> & signToData);
     uint64_t getNearestTime(uint64_t from);
     QVector<char> getChangedForTime(uint64_t time);
-    PlotTreeItem(const QString & text) : QStandardItem(text) {}
+    PlotTreeItem(int id, int nameId, int parentId, int row) : id(id), nameId(nameId), parentId(parentId), row(row), fetchedRows(0) {}
     ~PlotTreeItem();
 };
 
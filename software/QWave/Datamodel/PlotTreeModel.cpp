@@ -40,6 +40,8 @@
 #include <QSet>
 #include "PlotData.h"
 #include <QDateTime>
+#include <QtAlgorithms>
+#include <QThread>
 
 
 #define TOK_DATE "$date"
@@ -56,12 +58,130 @@
 
 #define TOP "top"
 
+PlotTreeModel::PlotTreeModel() : QAbstractItemModel(), date(QDateTime::currentDateTime().toString(Qt::ISODate)), comment(""), version("QWave"), currentScope(0),
+    dumpState(DumpStart), dumpPosition(0), readValues(0), collecting(false)
+{
+    scopes.push_back(new PlotTreeItem(0, StringPool::instance().intern(""), -1, 0));
+}
+
 /**
   * Destructor
   */
 PlotTreeModel::~PlotTreeModel()
 {
-    //QStandardItemModel::~QStandardItemModel();
+    qDeleteAll(scopes);
+}
+
+/**
+ * @brief PlotTreeModel::addScope appends new scope to table. Views see it after
+ * they fetch children of parent.
+ * @param parentId
+ * @param name
+ * @return returns id of new scope.
+ */
+int PlotTreeModel::addScope(int parentId, const QString & name)
+{
+    int id = scopes.count();
+    PlotTreeItem * parentScope = scopes.at(parentId);
+    scopes.push_back(new PlotTreeItem(id, StringPool::instance().intern(name), parentId, parentScope->childCount()));
+    parentScope->appendChild(id);
+    return id;
+}
+
+/**
+ * @brief PlotTreeModel::scopeFromIndex
+ * @return returns scope of index, root for invalid index.
+ */
+PlotTreeItem * PlotTreeModel::scopeFromIndex(const QModelIndex & index) const
+{
+    if(not index.isValid())
+        return scopes.first();
+    return scopes.at(static_cast<int>(index.internalId()));
+}
+
+/**
+ * @brief PlotTreeModel::itemFromIndex
+ * @return returns scope shown at index or NULL.
+ */
+PlotTreeItem * PlotTreeModel::itemFromIndex(const QModelIndex & index) const
+{
+    if(not index.isValid())
+        return NULL;
+    return scopeFromIndex(index);
+}
+
+QModelIndex PlotTreeModel::index(int row, int column, const QModelIndex & parent) const
+{
+    PlotTreeItem * parentScope = scopeFromIndex(parent);
+    if(column != 0 or row < 0 or row >= parentScope->getFetchedRows())
+        return QModelIndex();
+    return createIndex(row, column, parentScope->childAt(row));
+}
+
+QModelIndex PlotTreeModel::parent(const QModelIndex & index) const
+{
+    if(not index.isValid())
+        return QModelIndex();
+    int parentId = scopeFromIndex(index)->getParentId();
+    if(parentId <= 0)
+        return QModelIndex();
+    return createIndex(scopes.at(parentId)->getRow(), 0, parentId);
+}
+
+int PlotTreeModel::rowCount(const QModelIndex & parent) const
+{
+    if(parent.column() > 0)
+        return 0;
+    return scopeFromIndex(parent)->getFetchedRows();
+}
+
+int PlotTreeModel::columnCount(const QModelIndex & parent) const
+{
+    Q_UNUSED(parent);
+    return 1;
+}
+
+bool PlotTreeModel::hasChildren(const QModelIndex & parent) const
+{
+    return parent.column() <= 0 and scopeFromIndex(parent)->childCount() > 0;
+}
+
+bool PlotTreeModel::canFetchMore(const QModelIndex & parent) const
+{
+    PlotTreeItem * scope = scopeFromIndex(parent);
+    return scope->getFetchedRows() < scope->childCount();
+}
+
+/**
+ * @brief PlotTreeModel::fetchMore shows next FETCH_ROWS children of parent to views.
+ * @param parent
+ */
+void PlotTreeModel::fetchMore(const QModelIndex & parent)
+{
+    PlotTreeItem * scope = scopeFromIndex(parent);
+    int fetched = scope->getFetchedRows();
+    int count = scope->childCount()-fetched;
+    if(count <= 0)
+        return;
+    if(count > FETCH_ROWS)
+        count = FETCH_ROWS;
+    beginInsertRows(parent, fetched, fetched+count-1);
+    scope->setFetchedRows(fetched+count);
+    endInsertRows();
+}
+
+QVariant PlotTreeModel::data(const QModelIndex & index, int role) const
+{
+    if(not index.isValid() or (role != Qt::DisplayRole and role != Qt::ToolTipRole))
+        return QVariant();
+    return getScopeName(scopeFromIndex(index));
+}
+
+QVariant PlotTreeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if(section == 0 and orientation == Qt::Horizontal and role == Qt::DisplayRole)
+        return QString("Scope");
+    return QVariant();
 }
 
 /**
@@ -69,11 +189,10 @@ PlotTreeModel::~PlotTreeModel()
  */
 void PlotTreeModel::initHierarchy()
 {
-    currentTopLevelItem = this->invisibleRootItem();
-    PlotTreeItem * newItem = new PlotTreeItem(TOP);
-    currentTopLevelItem->appendRow(newItem);
-    lastTopLevelItem.push(currentTopLevelItem);
-    currentTopLevelItem = newItem;
+    beginResetModel();
+    lastScopes.push(0);
+    currentScope = addScope(0, TOP);
+    endResetModel();
 }
 
 /**
@@ -82,7 +201,8 @@ void PlotTreeModel::initHierarchy()
  */
 void PlotTreeModel::saveToFile(QFile* file)
 {
-    timescaleInPs = static_cast<PlotTreeItem*>(this->invisibleRootItem()->child(0))->plotData()[0]->getDiv();
+    PlotTreeItem * top = scopes.at(scopes.first()->childAt(0));
+    timescaleInPs = top->plotData()[0]->getDiv();
     QTextStream out(file);
     if(date != "")
         out << TOK_DATE << endl << SPACE << this->date << endl << TOK_END << endl;
@@ -91,12 +211,102 @@ void PlotTreeModel::saveToFile(QFile* file)
     if(comment != "")
         out << TOK_COMMENT<< endl <<SPACE << this->comment << endl << TOK_END << endl;
     out << TOK_TIMESCALE << SPACE << this->timescaleInPs << "ps" << SPACE << TOK_END << endl;
-    printScopes(out, static_cast<PlotTreeItem*>(this->invisibleRootItem()->child(0)));
+    printScopes(out, top);
     out << TOK_ENDDEFINITIONS << SPACE << TOK_END << endl;
     out << TOK_DUMPVARS << endl;
     printDumps(out);
 }
 
+/**
+ * @brief PlotTreeModel::saveToCsv save model to CSV file, one row per sample
+ * and one column per signal. Registers are written as binary strings.
+ * Rows are spaced by smallest div of all signals, signals with longer div
+ * repeat their sample until their next sample.
+ * @param file
+ */
+void PlotTreeModel::saveToCsv(QFile* file)
+{
+    QTextStream out(file);
+    QList<PlotData*> dataList = signToData.values()+signToView.values();
+    uint64_t endPs = 0;
+    uint64_t div = 0;
+    out << "time_ps";
+    for(int i = 0; i < dataList.count(); ++i)
+    {
+        uint64_t dataDiv = qMax(dataList[i]->getDiv(), static_cast<uint64_t>(1));
+        out << "," << dataList[i]->getName();
+        endPs = qMax(endPs, dataList[i]->lastPositionOnBit(0)*dataDiv);
+        div = div == 0 ? dataDiv : qMin(div, dataDiv);
+    }
+    out << endl;
+    if(div == 0)
+        div = DEFAULT_DIV;
+    for(uint64_t time = 0; time < endPs; time += div)
+    {
+        out << time;
+        for(int i = 0; i < dataList.count(); ++i)
+        {
+            PlotData* data = dataList[i];
+            size_t sample = time/qMax(data->getDiv(), static_cast<uint64_t>(1));
+            out << ",";
+            if(sample >= data->lastPositionOnBit(0))
+                continue;
+            if(data->getType() == PlotData::Linear)
+            {
+                out << static_cast<int>(data->at(0, sample));
+            }
+            else
+            {
+                for(int bit = 0; bit < data->getBitwidth(); ++bit)
+                {
+                    out << getBitChar(bit, data, sample);
+                }
+            }
+        }
+        out << endl;
+    }
+}
+
+/**
+ * @brief PlotTreeModel::trim keeps only samples between given times in all signals.
+ * @param fromPs start of kept range in picoseconds.
+ * @param toPs end of kept range in picoseconds.
+ */
+void PlotTreeModel::trim(uint64_t fromPs, uint64_t toPs)
+{
+    if(toPs < fromPs)
+    {
+        throw Exception("End of trimmed range is before its start.");
+    }
+    // views share buffer with their source, buffer which is still appended is trimmed once
+    QHash<SampleBuffer*, QVector<PlotData*> > shared;
+    for(int id = 0; id < scopes.count(); ++id)
+    {
+        QVector<PlotData*> data = scopes.at(id)->plotData();
+        for(int i = 0; i < data.size(); ++i)
+        {
+            if(data.at(i)->getBuffer()->isSealed())
+                data.at(i)->trim(fromPs/data.at(i)->getDiv(), toPs/data.at(i)->getDiv());
+            else
+                shared[data.at(i)->getBuffer()].append(data.at(i));
+        }
+    }
+    QHash<SampleBuffer*, QVector<PlotData*> >::iterator i;
+    for(i = shared.begin(); i != shared.end(); ++i)
+    {
+        uint64_t div = i.value().first()->getDiv();
+        size_t from = fromPs/div;
+        size_t to = toPs/div;
+        if(to < from)
+            to = from;
+        i.key()->trim(from, to);
+        for(int view = 0; view < i.value().size(); ++view)
+        {
+            i.value().at(view)->rebase(from, to);
+        }
+    }
+}
+
 /**
  * @brief PlotTreeModel::printScopes print scopes to VCD file
  * @param out
@@ -105,11 +315,11 @@ void PlotTreeModel::saveToFile(QFile* file)
 void PlotTreeModel::printScopes(QTextStream& out, PlotTreeItem* topScope)
 {
     itemsToDump.push_back(topScope);
-    out << TOK_SCOPE << SPACE << TOK_MODULE << SPACE<< topScope->text() << SPACE << TOK_END << endl;
+    out << TOK_SCOPE << SPACE << TOK_MODULE << SPACE<< getScopeName(topScope) << SPACE << TOK_END << endl;
     topScope->printSignals(out);
-    for(int row; row < topScope->rowCount(); ++row)
+    for(int row = 0; row < topScope->childCount(); ++row)
     {
-        this->printScopes(out, static_cast<PlotTreeItem*>(topScope->child(row)));
+        this->printScopes(out, scopes.at(topScope->childAt(row)));
     }
     out << TOK_UPSCOPE << SPACE << TOK_END << endl;
 }
@@ -124,7 +334,7 @@ uint64_t PlotTreeModel::getNearestTime(uint64_t from)
     uint64_t time = UINT64_MAX;
     for(int i = 0; i < itemsToDump.count(); ++i)
     {
-        uint64_t tm = static_cast<PlotTreeItem*>(itemsToDump[i])->getNearestTime(from);
+        uint64_t tm = itemsToDump[i]->getNearestTime(from);
         if(time > tm)
         {
             time = tm;
@@ -143,19 +353,20 @@ uint64_t PlotTreeModel::getNearestTime(uint64_t from)
 char PlotTreeModel::getBitChar(int bit, PlotData* data, uint64_t time)
 {
     char value = 'x';
-    if(data->getDataAtBit(bit)[time] == HIGH)
+    unsigned char sample = data->at(bit, time);
+    if(sample == HIGH)
     {
         value = '1';
     }
-    else if(data->getDataAtBit(bit)[time]  == LOW)
+    else if(sample == LOW)
     {
         value = '0';
     }
-    else if(data->getDataAtBit(bit)[time]  == NO_INFORMATION)
+    else if(sample == NO_INFORMATION)
     {
         value = 'x';
     }
-    else if(data->getDataAtBit(bit)[time]  == HIGH_IMPEDANCE)
+    else if(sample == HIGH_IMPEDANCE)
     {
         value = 'u';
     }
@@ -172,7 +383,7 @@ QVector<char> PlotTreeModel::getChangedForTime(uint64_t time)
     QVector<char> vector;
     for(int i = 0; i < itemsToDump.count(); ++i)
     {
-        QVector<char> newVec = static_cast<PlotTreeItem*>(itemsToDump[i])->getChangedForTime(time);
+        QVector<char> newVec = itemsToDump[i]->getChangedForTime(time);
         vector += newVec;
     }
     return vector;
@@ -194,10 +405,10 @@ void PlotTreeModel::printDumps(QTextStream& out)
         signs = QSet<char>::fromList(signs).toList();
         for(int i = 0; i < signs.count(); ++i)
         {
-            PlotData* data = signToData[signs[i]];
+            PlotData* data = dataOfSign(signs[i]);
             if(data->getType() ==  PlotData::Linear)
             {
-                out << "r" << data->getDataAtBit(0)[currentTime] << " " << signs[i] << endl;
+                out << "r" << data->at(0, currentTime) << " " << signs[i] << endl;
             }
             else
             {
@@ -223,57 +434,63 @@ void PlotTreeModel::printDumps(QTextStream& out)
 }
 
 /**
- * This method loads header of VCD file and constructs corresponding data model.
+ * This method loads VCD file and constructs corresponding data model, views are reset
+ * once whole file is loaded.
  */
 void PlotTreeModel::loadFromFile(FileSplitter & splitter)
 {
-    currentTopLevelItem = this->invisibleRootItem();
+    beginResetModel();
+    for(int id = 0; id < scopes.count(); ++id)
+    {
+        scopes.at(id)->setFetchedRows(0);
+    }
+    currentScope = 0;
+    try
+    {
+        loadHeader(splitter);
+        beginDump();
+        while(readDump(splitter, DUMP_BATCH))
+            ;
+        finishDump(dumpPosition);
+    }
+    catch(Exception e)
+    {
+        endResetModel();
+        throw;
+    }
+    endResetModel();
+}
+
+/**
+ * This method loads header of VCD file into scope table, splitter is left at start of dump section.
+ */
+void PlotTreeModel::loadHeader(FileSplitter & splitter)
+{
     splitter.getToken();
     while(splitter.currentToken() != TOK_ENDDEFINITIONS)
     {
         //qDebug() << token;
         if(splitter.currentToken()== TOK_COMMENT)
         {
-            splitter.getToken();
-            while(splitter.currentToken() != TOK_END)
-            {
-                comment = comment + " " + splitter.currentToken();
-                splitter.getToken();
-            }
+            comment += readText(splitter);
         }
         else
         {
             if(splitter.currentToken() == TOK_DATE)
             {
-                splitter.getToken();
-                while(splitter.currentToken() != TOK_END)
-                {
-                    date = date + " " + splitter.currentToken();
-                    splitter.getToken();
-                }
+                date += readText(splitter);
             }
             else
             {
                 if(splitter.currentToken() == TOK_VERSION)
                 {
-                    splitter.getToken();
-                    while(splitter.currentToken() != TOK_END)
-                    {
-                        version = version + " " + splitter.currentToken();
-                        splitter.getToken();
-                    }
+                    version += readText(splitter);
                 }
                 else
                 {
                     if(splitter.currentToken()  == TOK_TIMESCALE)
                     {
-                        QString timescale;
-                        splitter.getToken();
-                        while(splitter.currentToken() != TOK_END)
-                        {
-                            timescale = timescale + " " + splitter.currentToken();
-                            splitter.getToken();
-                        }
+                        QString timescale = readText(splitter);
                         qDebug() << timescale;
                         QRegExp regExp(tr("(\\s*)(\\d+)(ps|ns|ms|us|s)(\\s*)"));
                         if(regExp.exactMatch(timescale))
@@ -312,7 +529,7 @@ void PlotTreeModel::loadFromFile(FileSplitter & splitter)
                         if(splitter.currentToken() == TOK_SCOPE)
                         {
                             loadScope(splitter);
-                            static_cast<PlotTreeItem*>(currentTopLevelItem)->loadFromFile(splitter, timescaleInPs, signToData); //load what is under scope
+                            scopes.at(currentScope)->loadFromFile(splitter, timescaleInPs, signToData); //load what is under scope
                             continue;
                         }
                         else
@@ -326,9 +543,9 @@ void PlotTreeModel::loadFromFile(FileSplitter & splitter)
                             {
                                 if(splitter.currentToken() == TOK_UPSCOPE)
                                 {
-                                    if(lastTopLevelItem.isEmpty())
+                                    if(lastScopes.isEmpty())
                                         throw IOException("Unexpected '$upscope' on line: "+QString::number(splitter.getLineNumber()));
-                                    currentTopLevelItem = lastTopLevelItem.pop();
+                                    currentScope = lastScopes.pop();
                                 }
                                 else
                                 {
@@ -347,40 +564,63 @@ void PlotTreeModel::loadFromFile(FileSplitter & splitter)
     {
         throw IOException("Expected '$end' tag of $enddefinitions on line: "+QString::number(splitter.getLineNumber()));
     }
-    else
+}
+
+/**
+ * @brief PlotTreeModel::readText reads text of header section up to its $end.
+ * @param splitter
+ * @return returns tokens of section, each preceded by space.
+ */
+QString PlotTreeModel::readText(FileSplitter & splitter)
+{
+    QStringList tokens;
+    splitter.getToken();
+    while(splitter.currentToken() != TOK_END)
     {
-        loadDump(splitter);
+        tokens.append(splitter.currentToken());
+        splitter.getToken();
     }
-   /* for(int i = 0; i < signToData['$']->lastPositionOnBit(0); ++i)
-    {
-        qDebug() << "At pos: " << i << " value: " << signToData['$']->getDataAtBit(0)[i];
-    } */
+    if(tokens.isEmpty())
+        return "";
+    return " "+tokens.join(" ");
 }
 
 /**
- * This method loads dump section of VCD files into datamodel.
+ * @brief PlotTreeModel::beginDump prepares reading of dump section, call after loadHeader.
  */
-void PlotTreeModel::loadDump(FileSplitter & splitter)
+void PlotTreeModel::beginDump()
 {
-    size_t position = 0;
-    enum dumpParseState { start, dumpvars, dump };
-    int state = start;
-    splitter.getToken();
-    while(splitter.currentToken() != "!$EOF$!")
+    dumpState = DumpStart;
+    dumpPosition = 0;
+    events.clear();
+}
+
+/**
+ * This method loads dump section of VCD files into datamodel. It returns after
+ * maxValues values were read, so it can be called repeatedly until whole dump is read.
+ * @brief PlotTreeModel::readDump
+ * @param splitter
+ * @param maxValues
+ * @return returns false once end of file is reached.
+ */
+bool PlotTreeModel::readDump(FileSplitter & splitter, int maxValues)
+{
+    readValues = 0;
+    while(readValues < maxValues)
     { // iterating to end of file
+        splitter.getToken();
+        if(splitter.currentToken() == "!$EOF$!")
+            return false;
         if(splitter.currentToken() == "")
-        {
-            splitter.getToken();
             continue;
-        }
         //qDebug() << token;
-        switch (state) 
+        switch (dumpState) 
         {
-            case start:
+            case DumpStart:
             {
                 if(splitter.currentToken() == TOK_DUMPVARS)
                 {
-                    state = dumpvars;
+                    dumpState = DumpVars;
                 }
                 else
                 {
@@ -388,32 +628,36 @@ void PlotTreeModel::loadDump(FileSplitter & splitter)
                 }
                 break;
             }
-            case dumpvars:
+            case DumpVars:
             {
                 if(splitter.currentToken() == TOK_END)
                 {
-                    state = dump;
+                    dumpState = DumpValues;
                 }
                 else
                 {
                     QString currTok(splitter.currentToken());
-                    parseDump(splitter, position, currTok);
+                    parseDump(splitter, dumpPosition, currTok);
                 }
                 break;
             }
-            case dump:
+            case DumpValues:
             {
-            QString token(splitter.currentToken());
+                QString token(splitter.currentToken());
                 if('#' == token.at(0).toAscii())
                 {
                     token.remove(0, 1);
-                    position = token.toULong();
+                    size_t time = token.toULong();
+                    if(time < dumpPosition)
+                    {
+                        throw IOException("Time goes back on line: "+QString::number(splitter.getLineNumber()));
+                    }
+                    dumpPosition = time;
                 }
                 else
                 {
-                    parseDump(splitter, position, token);
+                    parseDump(splitter, dumpPosition, token);
                 }
-                state = dump;
                 break;
             }
             default:
@@ -421,23 +665,82 @@ void PlotTreeModel::loadDump(FileSplitter & splitter)
                 break;
             }
         }
-        splitter.getToken();
     }
-    // finally filling up to last read position
-    //qDebug() << "Pos: " << position;
+    return true;
+}
+
+/**
+ * @brief PlotTreeModel::finishDump extends every signal with its last value up to position
+ * and seals it.
+ * @param position last time read from dump.
+ */
+void PlotTreeModel::finishDump(size_t position)
+{
     QHash<char, PlotData*>::iterator i;
     for (i = signToData.begin(); i != signToData.end(); ++i)
     {
-        if(i.value()->getIsShadow())
-            return;
-        for (int bitNumber = 0; bitNumber < i.value()->getBitwidth(); ++bitNumber) 
-        {
-            for(size_t currentSample = i.value()->lastPositionOnBit(bitNumber); currentSample <= position; ++currentSample)
-            {
-                i.value()->appendDataAtBit(bitNumber, i.value()->getDataAtBit(bitNumber)[currentSample-1]);
-            }
-        }
+        i.value()->extend(position+1);
+        // loaded samples never change, so all views of them can share them safely
+        i.value()->getBuffer()->seal();
+    }
+}
+
+/**
+ * @brief PlotTreeModel::takeEvents
+ * @return returns events collected since last call.
+ */
+QVector<DumpEvent> PlotTreeModel::takeEvents()
+{
+    QVector<DumpEvent> taken = events;
+    events.clear();
+    return taken;
+}
+
+/**
+ * @brief PlotTreeModel::applyEvents appends events collected by other model to data of this model.
+ * @param newEvents
+ */
+void PlotTreeModel::applyEvents(const QVector<DumpEvent> & newEvents)
+{
+    for(int i = 0; i < newEvents.size(); ++i)
+    {
+        const DumpEvent & event = newEvents.at(i);
+        PlotData * currentData = signToData.value(event.sign);
+        currentData->appendEvent(event.time);
+        currentData->setEventValue(event.bitNumber, event.value);
+    }
+}
+
+/**
+ * @brief PlotTreeModel::takeHeader takes over scopes and signals read by loadHeader of other model,
+ * which keeps only signs of signals, so it can go on collecting dump events for this model.
+ * @param header
+ */
+void PlotTreeModel::takeHeader(PlotTreeModel & header)
+{
+    beginResetModel();
+    qDeleteAll(scopes);
+    scopes = header.scopes;
+    header.scopes.clear();
+    header.scopes.push_back(new PlotTreeItem(0, StringPool::instance().intern(""), -1, 0));
+    for(int id = 0; id < scopes.count(); ++id)
+    {
+        scopes.at(id)->setFetchedRows(0);
+    }
+    currentScope = 0;
+    lastScopes.clear();
+    signToData = header.signToData;
+    signToView.clear();
+    QHash<char, PlotData*>::iterator i;
+    for (i = signToData.begin(); i != signToData.end(); ++i)
+    { // events are applied here, so chunks can be spilled from this thread
+        i.value()->getBuffer()->setWriter(QThread::currentThread());
     }
+    date = header.date;
+    version = header.version;
+    comment = header.comment;
+    timescaleInPs = header.timescaleInPs;
+    endResetModel();
 }
 
 /**
@@ -534,25 +837,25 @@ void PlotTreeModel::parseBit(char sourceValue, char sign, int bitNumber, size_t
 }
 
 /**
- * Inserts value to corresponding bit and sample. Fills up empty space with last values.
+ * Inserts value to corresponding bit at event starting at sampleNumber.
+ * Other bits keep their last values.
  */
 void PlotTreeModel::insertValue(char sign, int bitNumber, unsigned char value, size_t sampleNumber)
 {
-    PlotData * currentData = signToData[sign];
+    PlotData * currentData = signToData.value(sign);
     if(currentData == NULL)
     {
-        throw IOException("Dump data sign not in declaration: "+sign);
+        throw IOException(QString("Dump data sign not in declaration: ")+sign);
     }
-    unsigned char fill;
-    if(currentData->lastPositionOnBit(bitNumber) == 0)
-        fill = currentData->getDataAtBit(bitNumber)[currentData->lastPositionOnBit(bitNumber)];
-    else
-        fill = currentData->getDataAtBit(bitNumber)[currentData->lastPositionOnBit(bitNumber)-1];
-    for(size_t currentSample = currentData->lastPositionOnBit(bitNumber); currentSample < sampleNumber; ++currentSample)
-    {
-        currentData->appendDataAtBit(bitNumber, fill);
+    ++readValues;
+    if(collecting)
+    { // data belong to model which took header, it applies event on its thread
+        DumpEvent event = { sampleNumber, sign, bitNumber, value };
+        events.append(event);
+        return;
     }
-    currentData->appendDataAtBit(bitNumber, value);
+    currentData->appendEvent(sampleNumber);
+    currentData->setEventValue(bitNumber, value);
 }
 
 /**
@@ -566,10 +869,8 @@ void PlotTreeModel::loadScope(FileSplitter & splitter)
     {
         if(gotModule)
         {
-            PlotTreeItem * newItem = new PlotTreeItem(splitter.currentToken());
-            currentTopLevelItem->appendRow(newItem);
-            lastTopLevelItem.push(currentTopLevelItem);
-            currentTopLevelItem = newItem;
+            lastScopes.push(currentScope);
+            currentScope = addScope(currentScope, splitter.currentToken());
         }
         else
             if(splitter.currentToken() == TOK_MODULE)
@@ -588,5 +889,73 @@ void PlotTreeModel::loadScope(FileSplitter & splitter)
 void PlotTreeModel::registerData(PlotData* data)
 {
     signToData[data->getSign()] = data;
-    static_cast<PlotTreeItem*>(currentTopLevelItem)->appendPlotData(data);
+    scopes.at(currentScope)->appendPlotData(data);
+}
+
+/**
+ * @brief PlotTreeModel::registerView registers view of data into scope of its source,
+ * so it is saved with other signals of scope. Views are kept apart from signals,
+ * so loaded values are never routed to them.
+ * @param source
+ * @param view view with sign from getFreeSign.
+ */
+void PlotTreeModel::registerView(PlotData* source, PlotData* view)
+{
+    if(dataOfSign(view->getSign()) != NULL)
+    {
+        throw Exception("Sign of view "+view->getName()+" is already used.");
+    }
+    PlotTreeItem * scope = NULL;
+    for(int id = 0; id < scopes.count() and scope == NULL; ++id)
+    {
+        if(scopes.at(id)->containsPlotData(source))
+            scope = scopes.at(id);
+    }
+    if(scope == NULL)
+    {
+        throw Exception("Source of view "+view->getName()+" is not in any scope.");
+    }
+    signToView[view->getSign()] = view;
+    scope->appendPlotData(view);
+}
+
+/**
+ * @brief PlotTreeModel::getFreeSign
+ * @return returns first printable VCD identifier not used by any signal or view.
+ */
+char PlotTreeModel::getFreeSign()
+{
+    for(char sign = '!'; sign <= '~'; ++sign)
+    {
+        if(dataOfSign(sign) == NULL)
+            return sign;
+    }
+    throw Exception("All identifiers of signals are used.");
+}
+
+/**
+ * @brief PlotTreeModel::collectData collects data of all scopes.
+ * @param dataByPath filled with data under their path of scope names joined by dots.
+ */
+void PlotTreeModel::collectData(QMap<QString, PlotData*> & dataByPath)
+{
+    PlotTreeItem * root = scopes.first();
+    for(int row = 0; row < root->childCount(); ++row)
+    {
+        collectData(scopes.at(root->childAt(row)), "", dataByPath);
+    }
+}
+
+void PlotTreeModel::collectData(PlotTreeItem * scope, QString path, QMap<QString, PlotData*> & dataByPath)
+{
+    path += getScopeName(scope)+".";
+    QVector<PlotData*> data = scope->plotData();
+    for(int i = 0; i < data.size(); ++i)
+    {
+        dataByPath.insert(path+data.at(i)->getName(), data.at(i));
+    }
+    for(int row = 0; row < scope->childCount(); ++row)
+    {
+        collectData(scopes.at(scope->childAt(row)), path, dataByPath);
+    }
 }
@@ -33,18 +33,40 @@
 #ifndef QWave_PlotTreeModel_h
 #define QWave_PlotTreeModel_h
 
-#include <QStandardItemModel>
+#include <QAbstractItemModel>
 #include <QStack>
 #include <QDateTime>
+#include <QMap>
+#include <QHash>
+#include <QStringList>
 #include "PlotTreeItem.h"
+#include "StringPool.h"
 #include "FileSplitter.h"
 #include "../Exceptions/IOException.h"
 #include <QFile>
 
+/**
+ * @brief The DumpEvent struct holds one value change read from dump section of VCD file,
+ * so it can be parsed on one thread and applied to data on another.
+ */
+struct DumpEvent
+{
+    size_t time;
+    char sign;
+    int bitNumber;
+    unsigned char value;
+};
+
 /**
  * @brief The PlotTreeModel class represents tree model of plots.
+ * Scopes are stored in flat table indexed by their id, where scope 0 is invisible root.
+ * Every scope refers to its parent and interned name, so paths of huge hierarchies
+ * stay compact. Children of scope are shown to views lazily in batches of FETCH_ROWS
+ * as views ask for them.
+ * Dump section is read in resumable steps, either applied directly or collected as events
+ * for model which owns the data (see LoadJob).
  */
-class PlotTreeModel : public QStandardItemModel
+class PlotTreeModel : public QAbstractItemModel
 {
     Q_OBJECT
     QString date;
@@ -52,13 +74,23 @@ class PlotTreeModel : public QStandardItemModel
     QString comment;
     uint64_t timescaleInPs;
     
-    QStandardItem * currentTopLevelItem;
-    QStack<QStandardItem*> lastTopLevelItem;
+    QVector<PlotTreeItem*> scopes;
+    int currentScope;
+    QStack<int> lastScopes;
     QHash<char, PlotData*> signToData;
-    QVector<QStandardItem*> itemsToDump;
+    QHash<char, PlotData*> signToView;
+    QVector<PlotTreeItem*> itemsToDump;
+    enum DumpState { DumpStart, DumpVars, DumpValues };
+    int dumpState;
+    size_t dumpPosition;
+    int readValues;
+    bool collecting;
+    QVector<DumpEvent> events;
+    QString readText(FileSplitter & splitter);
+    int addScope(int parentId, const QString & name);
+    PlotTreeItem * scopeFromIndex(const QModelIndex & index) const;
     void parseDump(FileSplitter & splitter, size_t sampleNumber, QString & token);
     void loadScope(FileSplitter & splitter);
-    void loadDump(FileSplitter & splitter);
     void parseBit(char sourceValue, char sign, int bitNumber, size_t sampleNumber, FileSplitter & splitter);
     void insertValue(char sign, int bitNumber, unsigned char value, size_t sampleNumber);
     void printScopes(QTextStream& out, PlotTreeItem* topScope);
@@ -66,14 +98,44 @@ class PlotTreeModel : public QStandardItemModel
     QVector<char> getChangedForTime(uint64_t time);
     char getBitChar(int bit, PlotData* data, uint64_t time);
     void printDumps(QTextStream& out);
+    PlotData * dataOfSign(char sign) { return signToData.contains(sign) ? signToData.value(sign) : signToView.value(sign); }
+    void collectData(PlotTreeItem * scope, QString path, QMap<QString, PlotData*> & dataByPath);
 public:
-    PlotTreeModel() : QStandardItemModel(), date(QDateTime::currentDateTime().toString(Qt::ISODate)), comment(""), version("QWave") {}
+    static const int FETCH_ROWS = 256;
+    static const int DUMP_BATCH = 65536;
+    PlotTreeModel();
     ~PlotTreeModel();
+    QModelIndex index(int row, int column, const QModelIndex & parent = QModelIndex()) const;
+    QModelIndex parent(const QModelIndex & index) const;
+    int rowCount(const QModelIndex & parent = QModelIndex()) const;
+    int columnCount(const QModelIndex & parent = QModelIndex()) const;
+    bool hasChildren(const QModelIndex & parent = QModelIndex()) const;
+    bool canFetchMore(const QModelIndex & parent) const;
+    void fetchMore(const QModelIndex & parent);
+    QVariant data(const QModelIndex & index, int role = Qt::DisplayRole) const;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+    PlotTreeItem * itemFromIndex(const QModelIndex & index) const;
+    QString getScopeName(const PlotTreeItem * scope) const { return StringPool::instance().at(scope->getNameId()); }
     void loadFromFile(FileSplitter & splitter);
+    void loadHeader(FileSplitter & splitter);
+    void beginDump();
+    bool readDump(FileSplitter & splitter, int maxValues);
+    void finishDump(size_t position);
+    size_t getDumpPosition() { return dumpPosition; }
+    void setCollectEvents(bool collect) { collecting = collect; }
+    QVector<DumpEvent> takeEvents();
+    void applyEvents(const QVector<DumpEvent> & newEvents);
+    void takeHeader(PlotTreeModel & header);
+    int getSignalCount() { return signToData.count(); }
     void saveToFile(QFile* file);
+    void saveToCsv(QFile* file);
+    void trim(uint64_t fromPs, uint64_t toPs);
     void initHierarchy();
     void registerData(PlotData* data);
-    void setCurrentTop(QStandardItem * currentTopLevelItem) { this->currentTopLevelItem = currentTopLevelItem; }
+    void registerView(PlotData* source, PlotData* view);
+    char getFreeSign();
+    void collectData(QMap<QString, PlotData*> & dataByPath);
+    void setCurrentTop(PlotTreeItem * currentTopLevelItem) { currentScope = currentTopLevelItem->getId(); }
     void setTimeScale(uint64_t timescale) { timescaleInPs = timescale;  }
     void setComment(QString comment) { this->comment = comment; }
 };
@@ -0,0 +1,687 @@
+//
+//   SampleBuffer.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "SampleBuffer.h"
+#include "Constants.h"
+#include "BlockCodec.h"
+#include "BlockCache.h"
+#include "MemoryManager.h"
+#include <QThread>
+#include "../Exceptions/Exception.h"
+#include "../Instrumentation/Profiler.h"
+#include <QAtomicPointer>
+#include <QtAlgorithms>
+#include <string.h>
+
+// packed chunk has to save at least quarter of chunk to be kept
+static const int MAX_PACKED_SIZE = CHUNK_SIZE*3/4;
+
+static QAtomicPointer<unsigned char> constantRuns[256];
+static QAtomicInt nextId;
+
+SampleBuffer::SampleBuffer(int bitwidth, bool timestamped) : chunks(bitwidth), packed(bitwidth), spilled(bitwidth), lengths(bitwidth, 0), id(nextId.fetchAndAddRelaxed(1)), compressed(false), packedBytes(0), lastUse(0), writer(QThread::currentThread()), refCount(0), sealed(false), timestamped(timestamped), timedLength(0), version(0), rewriteVersion(0)
+{
+    MemoryManager::instance().addBuffer(this);
+}
+
+SampleBuffer::~SampleBuffer()
+{
+    MemoryManager::instance().removeBuffer(this);
+    for(int i = 0; i < chunks.count(); ++i)
+    {
+        ChunkPool::instance().release(chunks.at(i));
+        for(int chunk = 0; chunk < spilled.at(i).count(); ++chunk)
+        {
+            if(spilled.at(i).at(chunk).slot >= 0)
+            {
+                MemoryManager::instance().freeSlot(spilled.at(i).at(chunk).slot);
+            }
+        }
+    }
+}
+
+/**
+ * @brief SampleBuffer::setCompressed turns packing of full chunks on or off,
+ * chunks already stored are packed or unpacked. Samples are not changed, so
+ * sealed buffer can be compressed too. Timestamped buffers are never compressed,
+ * they store only changes already.
+ * @param compressed
+ */
+void SampleBuffer::setCompressed(bool compressed)
+{
+    if(timestamped or compressed == this->compressed)
+    {
+        return;
+    }
+    this->compressed = compressed;
+    if(compressed)
+    {
+        packFull();
+    }
+    else
+    {
+        loadAll();
+    }
+}
+
+/**
+ * @brief SampleBuffer::touch marks buffer as viewed now, so it is spilled last.
+ */
+void SampleBuffer::touch() const
+{
+    lastUse = MemoryManager::instance().nextUse();
+}
+
+/**
+ * @brief SampleBuffer::getCachedChunk
+ * @param bitNumber
+ * @param chunk index of packed or spilled chunk.
+ * @return returns samples of chunk from BlockCache.
+ */
+const unsigned char * SampleBuffer::getCachedChunk(int bitNumber, int chunk) const
+{
+    return BlockCache::get(id, bitNumber, chunk, this);
+}
+
+/**
+ * @brief SampleBuffer::loadChunk unpacks or reads from spill file chunk which is not resident.
+ * @param bitNumber
+ * @param chunk
+ * @param samples filled with CHUNK_SIZE samples.
+ */
+void SampleBuffer::loadChunk(int bitNumber, int chunk, unsigned char * samples) const
+{
+    if(chunk < packed.at(bitNumber).count() and not packed.at(bitNumber).at(chunk).isEmpty())
+    {
+        BlockCodec::unpack(packed.at(bitNumber).at(chunk), samples);
+        return;
+    }
+    const SpilledChunk & spilledChunk = spilled.at(bitNumber).at(chunk);
+    if(spilledChunk.size == static_cast<int>(CHUNK_SIZE))
+    {
+        MemoryManager::instance().load(spilledChunk.slot, reinterpret_cast<char *>(samples), spilledChunk.size);
+    }
+    else
+    {
+        QByteArray packedSamples(spilledChunk.size, 0);
+        MemoryManager::instance().load(spilledChunk.slot, packedSamples.data(), spilledChunk.size);
+        BlockCodec::unpack(packedSamples, samples);
+    }
+}
+
+/**
+ * @brief SampleBuffer::isSpillable
+ * @return returns true if chunks can be spilled from current thread, which is
+ * when no other thread appends to buffer.
+ */
+bool SampleBuffer::isSpillable() const
+{
+    return sealed or writer == QThread::currentThread();
+}
+
+/**
+ * @brief SampleBuffer::spill writes full chunks to spill file, from oldest samples,
+ * chunk with last sample of bit stays in memory for appending.
+ * @param bytes memory to free.
+ * @return returns memory freed, less than bytes when there is nothing more to spill.
+ */
+size_t SampleBuffer::spill(size_t bytes)
+{
+    size_t freed = 0;
+    bool found = true;
+    for(int chunk = 0; found and freed < bytes; ++chunk)
+    {
+        found = false;
+        for(int bit = 0; bit < chunks.count(); ++bit)
+        {
+            int full = lengths.at(bit) == 0 ? 0 : (lengths.at(bit)-1) >> CHUNK_BITS;
+            if(chunk < full)
+            {
+                found = true;
+                freed += spillChunk(bit, chunk);
+            }
+        }
+    }
+    return freed;
+}
+
+/**
+ * @brief SampleBuffer::spillChunk writes chunk to spill file and frees its memory.
+ * @return returns memory freed.
+ */
+size_t SampleBuffer::spillChunk(int bitNumber, int chunk)
+{
+    SpilledChunk spilledChunk;
+    unsigned char * samples = chunks.at(bitNumber).at(chunk);
+    if(samples != NULL)
+    {
+        spilledChunk.size = CHUNK_SIZE;
+        spilledChunk.slot = MemoryManager::instance().spill(reinterpret_cast<const char *>(samples), spilledChunk.size);
+        chunks[bitNumber][chunk] = NULL;
+        ChunkPool::instance().release(samples);
+    }
+    else if(chunk < packed.at(bitNumber).count() and not packed.at(bitNumber).at(chunk).isEmpty())
+    {
+        spilledChunk.size = packed.at(bitNumber).at(chunk).size();
+        spilledChunk.slot = MemoryManager::instance().spill(packed.at(bitNumber).at(chunk).constData(), spilledChunk.size);
+        packed[bitNumber][chunk] = QByteArray();
+        packedBytes -= spilledChunk.size;
+    }
+    else
+    {
+        return 0;
+    }
+    if(spilled.at(bitNumber).count() <= chunk)
+    {
+        spilled[bitNumber].resize(chunk+1);
+    }
+    spilled[bitNumber][chunk] = spilledChunk;
+    return spilledChunk.size;
+}
+
+/**
+ * @brief SampleBuffer::packChunk packs full chunk and returns it to pool
+ * unless packing would not save enough memory.
+ * @param bitNumber
+ * @param chunk
+ */
+void SampleBuffer::packChunk(int bitNumber, int chunk)
+{
+    unsigned char * samples = chunks.at(bitNumber).at(chunk);
+    if(samples == NULL)
+    {
+        return;
+    }
+    QByteArray packedSamples = BlockCodec::pack(samples);
+    if(packedSamples.size() > MAX_PACKED_SIZE)
+    {
+        return;
+    }
+    if(packed.at(bitNumber).count() <= chunk)
+    {
+        packed[bitNumber].resize(chunk+1);
+    }
+    packed[bitNumber][chunk] = packedSamples;
+    packedBytes += packedSamples.size();
+    chunks[bitNumber][chunk] = NULL;
+    ChunkPool::instance().release(samples);
+}
+
+/**
+ * @brief SampleBuffer::packFull packs all full chunks of all bits.
+ */
+void SampleBuffer::packFull()
+{
+    for(int bit = 0; bit < chunks.count(); ++bit)
+    {
+        int full = lengths.at(bit) >> CHUNK_BITS;
+        for(int chunk = 0; chunk < full; ++chunk)
+        {
+            packChunk(bit, chunk);
+        }
+    }
+}
+
+/**
+ * @brief SampleBuffer::loadAll makes all packed and spilled chunks resident again.
+ */
+void SampleBuffer::loadAll()
+{
+    for(int bit = 0; bit < chunks.count(); ++bit)
+    {
+        for(int chunk = 0; chunk < chunks.at(bit).count(); ++chunk)
+        {
+            if(chunks.at(bit).at(chunk) == NULL)
+            {
+                unsigned char * samples = ChunkPool::instance().acquire();
+                loadChunk(bit, chunk, samples);
+                chunks[bit][chunk] = samples;
+            }
+        }
+        for(int chunk = 0; chunk < spilled.at(bit).count(); ++chunk)
+        {
+            if(spilled.at(bit).at(chunk).slot >= 0)
+            {
+                MemoryManager::instance().freeSlot(spilled.at(bit).at(chunk).slot);
+            }
+        }
+        packed[bit].clear();
+        spilled[bit].clear();
+    }
+    packedBytes = 0;
+}
+
+/**
+ * @brief SampleBuffer::checkOpen throws when sealed samples would be modified.
+ */
+void SampleBuffer::checkOpen()
+{
+    if(sealed)
+    {
+        throw Exception("Cannot modify sealed samples.");
+    }
+}
+
+/**
+ * @brief SampleBuffer::append appends new data newData at bitNumber bit.
+ * New chunk is taken from pool when last one is full, old samples are not copied.
+ * @param bitNumber bit number to append data on.
+ * @param newData new data to append.
+ */
+void SampleBuffer::append(int bitNumber, unsigned char newData)
+{
+    checkOpen();
+    if(timestamped)
+    {
+        throw Exception("Timestamped samples have to be appended as events.");
+    }
+    appendStored(bitNumber, newData);
+}
+
+/**
+ * @brief SampleBuffer::appendStored stores newData after last stored sample of bit.
+ * @param bitNumber
+ * @param newData
+ */
+void SampleBuffer::appendStored(int bitNumber, unsigned char newData)
+{
+    size_t position = lengths.at(bitNumber);
+    QVector<unsigned char *> & bitChunks = chunks[bitNumber];
+    if(static_cast<int>(position >> CHUNK_BITS) >= bitChunks.count())
+    {
+        bitChunks.append(ChunkPool::instance().acquire());
+    }
+    qHotDebug() << "Adding: " << newData << " to bit: " << bitNumber << " to pos: " << position;
+    bitChunks.at(position >> CHUNK_BITS)[position & CHUNK_MASK] = newData;
+    lengths[bitNumber] = position+1;
+    ++version;
+    if(compressed and ((position+1) & CHUNK_MASK) == 0)
+    {
+        packChunk(bitNumber, position >> CHUNK_BITS);
+    }
+}
+
+/**
+ * @brief SampleBuffer::append appends count samples from newData at bitNumber bit.
+ * Block is copied chunk by chunk.
+ * @param bitNumber bit number to append data on.
+ * @param newData new data to append.
+ * @param count number of samples in newData.
+ */
+void SampleBuffer::append(int bitNumber, const unsigned char * newData, size_t count)
+{
+    checkOpen();
+    if(timestamped)
+    {
+        throw Exception("Timestamped samples have to be appended as events.");
+    }
+    size_t position = lengths.at(bitNumber);
+    QVector<unsigned char *> & bitChunks = chunks[bitNumber];
+    size_t copied = 0;
+    while(copied < count)
+    {
+        if(static_cast<int>(position >> CHUNK_BITS) >= bitChunks.count())
+        {
+            bitChunks.append(ChunkPool::instance().acquire());
+        }
+        size_t offset = position & CHUNK_MASK;
+        size_t length = qMin(CHUNK_SIZE-offset, count-copied);
+        memcpy(bitChunks.at(position >> CHUNK_BITS)+offset, newData+copied, length*sizeof(unsigned char));
+        copied += length;
+        position += length;
+        if(compressed and (position & CHUNK_MASK) == 0)
+        {
+            packChunk(bitNumber, (position-1) >> CHUNK_BITS);
+        }
+    }
+    lengths[bitNumber] = position;
+    version += count;
+}
+
+/**
+ * @brief SampleBuffer::appendEvent starts new event at time, all bits keep value
+ * of previous event until it is changed by setEventValue. Samples before first
+ * event are unknown. Event at time of last event is not started again.
+ * @param time time of event in samples, must not be before last event.
+ */
+void SampleBuffer::appendEvent(size_t time)
+{
+    checkOpen();
+    if(not timestamped)
+    {
+        throw Exception("Uniform samples cannot be appended as events.");
+    }
+    if(not times.isEmpty() and time <= times.last())
+    {
+        if(time < times.last())
+        {
+            throw Exception("Events have to be appended in order of time.");
+        }
+        return;
+    }
+    if(times.isEmpty() and time > 0)
+    {
+        appendEvent(0);
+    }
+    for(int bit = 0; bit < chunks.count(); ++bit)
+    {
+        appendStored(bit, times.isEmpty() ? NO_INFORMATION : storedAt(bit, times.count()-1));
+    }
+    times.append(time);
+    timedLength = qMax(timedLength, time+1);
+}
+
+/**
+ * @brief SampleBuffer::setEventValue sets value of bit in last event.
+ * @param bitNumber
+ * @param value
+ */
+void SampleBuffer::setEventValue(int bitNumber, unsigned char value)
+{
+    checkOpen();
+    if(times.isEmpty())
+    {
+        throw Exception("No event to set value in.");
+    }
+    size_t index = times.count()-1;
+    chunks[bitNumber].at(index >> CHUNK_BITS)[index & CHUNK_MASK] = value;
+    ++version;
+}
+
+/**
+ * @brief SampleBuffer::extend makes timestamped samples known up to length,
+ * last event holds its value until then.
+ * @param length
+ */
+void SampleBuffer::extend(size_t length)
+{
+    checkOpen();
+    if(not timestamped)
+    {
+        throw Exception("Uniform samples cannot be extended without data.");
+    }
+    if(times.isEmpty())
+    {
+        appendEvent(0);
+    }
+    if(length > timedLength)
+    {
+        version += length-timedLength;
+        timedLength = length;
+    }
+}
+
+/**
+ * @brief SampleBuffer::findEvent
+ * @param sample has to be less than getLength.
+ * @return returns index of event holding value of sample.
+ */
+size_t SampleBuffer::findEvent(size_t sample) const
+{
+    return qUpperBound(times.constBegin(), times.constEnd(), sample)-times.constBegin()-1;
+}
+
+/**
+ * @brief SampleBuffer::getSamples
+ * @param bitNumber
+ * @param offset sample shown as first by returned view.
+ * @return returns indexable view of samples of bit.
+ */
+BitSamples SampleBuffer::getSamples(int bitNumber, size_t offset) const
+{
+    touch();
+    if(timestamped or compressed or not spilled.at(bitNumber).isEmpty())
+    {
+        return BitSamples(this, bitNumber, offset);
+    }
+    return BitSamples(chunks.at(bitNumber).constData(), offset);
+}
+
+/**
+ * @brief SampleBuffer::getConstantRun
+ * @param value
+ * @return returns chunk filled with value, shared by all timestamped buffers.
+ * Chunk is filled once on first use, without locking, so readers of existing chunk never wait.
+ */
+const unsigned char * SampleBuffer::getConstantRun(unsigned char value)
+{
+    unsigned char * run = constantRuns[value];
+    if(run != NULL)
+    {
+        return run;
+    }
+    run = ChunkPool::instance().acquire();
+    memset(run, value, CHUNK_SIZE*sizeof(unsigned char));
+    if(not constantRuns[value].testAndSetOrdered(NULL, run))
+    { // other thread filled it first
+        ChunkPool::instance().release(run);
+        run = constantRuns[value];
+    }
+    return run;
+}
+
+/**
+ * @brief SampleBuffer::getRun gives direct access to stored samples, data are
+ * contiguous only inside of chunk, so longer ranges are walked run by run.
+ * Run of timestamped samples ends with event, it points to chunk filled with
+ * value of event, so it is never longer than chunk. Run of packed chunk
+ * points into BlockCache and stays valid as long as cached chunk.
+ * @param bitNumber
+ * @param sample first sample of run, has to be less than getLength.
+ * @param length returns number of samples readable from returned pointer.
+ * @return returns pointer to sample.
+ */
+const unsigned char * SampleBuffer::getRun(int bitNumber, size_t sample, size_t & length) const
+{
+    touch();
+    if(timestamped)
+    {
+        size_t event = findEvent(sample);
+        size_t next = static_cast<int>(event+1) < times.count() ? times.at(event+1) : timedLength;
+        length = qMin(CHUNK_SIZE, next-sample);
+        return getConstantRun(storedAt(bitNumber, event));
+    }
+    return getStoredRun(bitNumber, sample, length);
+}
+
+/**
+ * @brief SampleBuffer::readRun reads run containing sample into view. Run of
+ * timestamped samples ends with event, run of stored samples is rest of chunk,
+ * samples appended to resident chunk later are read through it too.
+ * @param samples view of bit.
+ * @param sample
+ */
+void SampleBuffer::readRun(const BitSamples & samples, size_t sample) const
+{
+    int bitNumber = samples.bitNumber;
+    samples.stamp = NULL;
+    size_t length;
+    if(timestamped)
+    {
+        size_t event = findEvent(sample);
+        size_t next = static_cast<int>(event+1) < times.count() ? times.at(event+1) : qMax(timedLength, sample+1);
+        length = qMin(CHUNK_SIZE, next-sample);
+        samples.run = getConstantRun(storedAt(bitNumber, event));
+    }
+    else
+    {
+        int chunk = sample >> CHUNK_BITS;
+        size_t offset = sample & CHUNK_MASK;
+        const unsigned char * chunkSamples = chunks.at(bitNumber).at(chunk);
+        if(chunkSamples == NULL)
+        {
+            chunkSamples = BlockCache::get(id, bitNumber, chunk, this, &samples.stamp);
+            samples.runStamp = *samples.stamp;
+        }
+        length = CHUNK_SIZE-offset;
+        samples.run = chunkSamples+offset;
+    }
+    samples.runFrom = sample;
+    samples.runTo = sample+length;
+}
+
+const unsigned char * SampleBuffer::getStoredRun(int bitNumber, size_t index, size_t & length) const
+{
+    size_t offset = index & CHUNK_MASK;
+    length = qMin(CHUNK_SIZE-offset, lengths.at(bitNumber)-index);
+    return getChunk(bitNumber, index >> CHUNK_BITS)+offset;
+}
+
+/**
+ * @brief SampleBuffer::trim keeps only samples in range [from, to) on every bit.
+ * Whole chunks before from are returned to pool, the rest is moved to the front.
+ * Timestamped samples keep events covering the range, first of them is moved to start.
+ * @param from first sample to keep.
+ * @param to first sample not to keep.
+ */
+void SampleBuffer::trim(size_t from, size_t to)
+{
+    checkOpen();
+    size_t first = from;
+    size_t last = to;
+    size_t begin = 0;
+    size_t end = 0;
+    if(timestamped)
+    {
+        end = qMin(to, timedLength);
+        begin = qMin(from, end);
+        first = begin == end ? 0 : findEvent(begin);
+        last = begin == end ? 0 : findEvent(end-1)+1;
+    }
+    // chunks before kept samples are dropped without loading them
+    int dropped = first >> CHUNK_BITS;
+    dropChunks(dropped);
+    first -= dropped*CHUNK_SIZE;
+    last = last > dropped*CHUNK_SIZE ? last-dropped*CHUNK_SIZE : 0;
+    loadAll();
+    trimStored(first, last);
+    if(timestamped)
+    {
+        if(begin == end)
+        {
+            times.clear();
+        }
+        else
+        {
+            times = times.mid(first+dropped*CHUNK_SIZE, last-first);
+            times[0] = begin;
+            for(int i = 0; i < times.count(); ++i)
+            {
+                times[i] -= begin;
+            }
+        }
+        timedLength = end-begin;
+    }
+    // samples moved between chunks, so cached chunks of old id are stale
+    id = nextId.fetchAndAddRelaxed(1);
+    if(compressed)
+    {
+        packFull();
+    }
+    markRewritten();
+}
+
+/**
+ * @brief SampleBuffer::dropChunks drops first count chunks of every bit,
+ * whether they are resident, packed or spilled.
+ * @param count
+ */
+void SampleBuffer::dropChunks(int count)
+{
+    if(count <= 0)
+    {
+        return;
+    }
+    for(int bit = 0; bit < chunks.count(); ++bit)
+    {
+        int dropped = qMin(count, chunks.at(bit).count());
+        ChunkPool::instance().release(chunks.at(bit).mid(0, dropped));
+        chunks[bit].remove(0, dropped);
+        int droppedPacked = qMin(dropped, packed.at(bit).count());
+        for(int chunk = 0; chunk < droppedPacked; ++chunk)
+        {
+            packedBytes -= packed.at(bit).at(chunk).size();
+        }
+        packed[bit].remove(0, droppedPacked);
+        int droppedSpilled = qMin(dropped, spilled.at(bit).count());
+        for(int chunk = 0; chunk < droppedSpilled; ++chunk)
+        {
+            if(spilled.at(bit).at(chunk).slot >= 0)
+            {
+                MemoryManager::instance().freeSlot(spilled.at(bit).at(chunk).slot);
+            }
+        }
+        spilled[bit].remove(0, droppedSpilled);
+        size_t droppedSamples = static_cast<size_t>(count)*CHUNK_SIZE;
+        lengths[bit] = lengths.at(bit) > droppedSamples ? lengths.at(bit)-droppedSamples : 0;
+    }
+}
+
+/**
+ * @brief SampleBuffer::trimStored keeps only stored samples with index in range [from, to).
+ * @param from
+ * @param to
+ */
+void SampleBuffer::trimStored(size_t from, size_t to)
+{
+    for(int bit = 0; bit < chunks.count(); ++bit)
+    {
+        QVector<unsigned char *> & bitChunks = chunks[bit];
+        size_t end = qMin(to, lengths.at(bit));
+        size_t begin = qMin(from, end);
+        int dropped = begin >> CHUNK_BITS;
+        if(dropped > 0)
+        {
+            ChunkPool::instance().release(bitChunks.mid(0, dropped));
+            bitChunks.remove(0, dropped);
+            begin -= dropped*CHUNK_SIZE;
+            end -= dropped*CHUNK_SIZE;
+        }
+        lengths[bit] = end;
+        size_t target = 0;
+        while(begin < end)
+        {
+            size_t length;
+            const unsigned char * source = getStoredRun(bit, begin, length);
+            length = qMin(qMin(length, end-begin), CHUNK_SIZE-(target & CHUNK_MASK));
+            memmove(bitChunks.at(target >> CHUNK_BITS)+(target & CHUNK_MASK), source, length*sizeof(unsigned char));
+            begin += length;
+            target += length;
+        }
+        int needed = (target+CHUNK_MASK) >> CHUNK_BITS;
+        if(needed < bitChunks.count())
+        {
+            ChunkPool::instance().release(bitChunks.mid(needed));
+            bitChunks.resize(needed);
+        }
+        lengths[bit] = target;
+    }
+}
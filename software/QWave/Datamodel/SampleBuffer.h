@@ -0,0 +1,189 @@
+//
+//   SampleBuffer.h
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef QWave_SampleBuffer_h
+#define QWave_SampleBuffer_h
+
+#include <QVector>
+#include <QByteArray>
+#include <QAtomicInt>
+#include <inttypes.h>
+#include "ChunkPool.h"
+
+class SampleBuffer;
+class QThread;
+
+/**
+ * @brief The BitSamples class is indexable view of samples of one bit.
+ * It can be passed wherever plain sample pointer was used, for example to
+ * templates in SampleScan.h. View is valid until next append to the bit.
+ * View of timestamped, packed or spilled samples keeps run it read last,
+ * so samples are looked up only once per run. Run from BlockCache is checked
+ * by stamp of its block, so view has to be read by thread which created it.
+ */
+class BitSamples
+{
+    unsigned char * const * chunks;
+    size_t offset;
+    const SampleBuffer * source;
+    int bitNumber;
+    mutable const unsigned char * run;
+    mutable size_t runFrom;
+    mutable size_t runTo;
+    mutable const uint64_t * stamp;
+    mutable uint64_t runStamp;
+    friend class SampleBuffer;
+public:
+    BitSamples() : chunks(0), offset(0), source(0), bitNumber(0), run(0), runFrom(0), runTo(0), stamp(0), runStamp(0) {}
+    BitSamples(unsigned char * const * chunks, size_t offset) : chunks(chunks), offset(offset), source(0), bitNumber(0), run(0), runFrom(0), runTo(0), stamp(0), runStamp(0) {}
+    BitSamples(const SampleBuffer * source, int bitNumber, size_t offset) : chunks(0), offset(offset), source(source), bitNumber(bitNumber), run(0), runFrom(0), runTo(0), stamp(0), runStamp(0) {}
+    inline unsigned char operator[](size_t sample) const;
+};
+
+/**
+ * @brief The SampleBuffer class stores samples of all bits of one signal in chunks from ChunkPool.
+ * Buffer is shared by reference counting between all PlotData showing the signal,
+ * data source appends to it until it is sealed, sealed samples never change.
+ * Version counts appended samples, so views can tell what changed since last look.
+ *
+ * Timestamped buffer stores events instead of uniform samples, every event holds
+ * value of all bits from its time until time of next event. Samples are still
+ * addressed by time in divs, so readers need not care how they are stored, but
+ * memory is proportional to number of events, not to length of signal.
+ *
+ * Compressed buffer packs every full chunk by BlockCodec when packing saves
+ * enough memory. Packed chunks are unpacked on read into BlockCache.
+ *
+ * MemoryManager can spill full chunks to disk, they are read back into
+ * BlockCache too, so only resident chunks are accessed directly.
+ */
+class SampleBuffer
+{
+    struct SpilledChunk
+    {
+        int slot;
+        int size;
+        SpilledChunk() : slot(-1), size(0) {}
+    };
+    QVector<QVector<unsigned char *> > chunks;
+    QVector<QVector<QByteArray> > packed;
+    QVector<QVector<SpilledChunk> > spilled;
+    QVector<size_t> lengths;
+    int id;
+    bool compressed;
+    size_t packedBytes;
+    mutable uint64_t lastUse;
+    QThread * writer;
+    QAtomicInt refCount;
+    bool sealed;
+    bool timestamped;
+    QVector<size_t> times;
+    size_t timedLength;
+    uint64_t version;
+    uint64_t rewriteVersion;
+    void checkOpen();
+    const unsigned char * getChunk(int bitNumber, int chunk) const;
+    unsigned char storedAt(int bitNumber, size_t index) const { return getChunk(bitNumber, index >> CHUNK_BITS)[index & CHUNK_MASK]; }
+    const unsigned char * getCachedChunk(int bitNumber, int chunk) const;
+    void packChunk(int bitNumber, int chunk);
+    void packFull();
+    void loadAll();
+    void dropChunks(int count);
+    size_t spillChunk(int bitNumber, int chunk);
+    void touch() const;
+    const unsigned char * getStoredRun(int bitNumber, size_t index, size_t & length) const;
+    void appendStored(int bitNumber, unsigned char newData);
+    void trimStored(size_t from, size_t to);
+    static const unsigned char * getConstantRun(unsigned char value);
+    void readRun(const BitSamples & samples, size_t sample) const;
+    friend class BitSamples;
+public:
+    SampleBuffer(int bitwidth, bool timestamped = false);
+    ~SampleBuffer();
+    void ref() { refCount.ref(); }
+    bool deref() { return refCount.deref(); }
+    int getBitwidth() const { return chunks.count(); }
+    void seal() { sealed = true; }
+    bool isSealed() const { return sealed; }
+    void setWriter(QThread * thread) { writer = thread; }
+    bool isTimestamped() const { return timestamped; }
+    void setCompressed(bool compressed);
+    bool isCompressed() const { return compressed; }
+    size_t getPackedBytes() const { return packedBytes; }
+    uint64_t getLastUse() const { return lastUse; }
+    bool isSpillable() const;
+    size_t spill(size_t bytes);
+    void loadChunk(int bitNumber, int chunk, unsigned char * samples) const;
+    size_t getLength(int bitNumber) const { return timestamped ? timedLength : lengths.at(bitNumber); }
+    unsigned char at(int bitNumber, size_t sample) const { return storedAt(bitNumber, timestamped ? findEvent(sample) : sample); }
+    BitSamples getSamples(int bitNumber, size_t offset) const;
+    const unsigned char * getRun(int bitNumber, size_t sample, size_t & length) const;
+    void append(int bitNumber, unsigned char newData);
+    void append(int bitNumber, const unsigned char * newData, size_t count);
+    size_t getEventCount() const { return times.count(); }
+    size_t getEventTime(size_t event) const { return times.at(event); }
+    unsigned char getEventValue(int bitNumber, size_t event) const { return storedAt(bitNumber, event); }
+    size_t findEvent(size_t sample) const;
+    void appendEvent(size_t time);
+    void setEventValue(int bitNumber, unsigned char value);
+    void extend(size_t length);
+    void trim(size_t from, size_t to);
+    uint64_t getVersion() const { return version; }
+    uint64_t getRewriteVersion() const { return rewriteVersion; }
+    void markRewritten() { rewriteVersion = ++version; }
+};
+
+inline const unsigned char * SampleBuffer::getChunk(int bitNumber, int chunk) const
+{
+    const unsigned char * samples = chunks.at(bitNumber).at(chunk);
+    if(samples == NULL)
+    {
+        samples = getCachedChunk(bitNumber, chunk);
+    }
+    return samples;
+}
+
+unsigned char BitSamples::operator[](size_t sample) const
+{
+    sample += offset;
+    if(source != 0)
+    {
+        if(sample-runFrom >= runTo-runFrom or (stamp != 0 and *stamp != runStamp))
+        {
+            source->readRun(*this, sample);
+        }
+        return run[sample-runFrom];
+    }
+    return chunks[sample >> CHUNK_BITS][sample & CHUNK_MASK];
+}
+
+#endif
@@ -0,0 +1,154 @@
+//
+//   SampleScan.h
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef QWave_SampleScan_h
+#define QWave_SampleScan_h
+
+#include <QtGlobal>
+#include <stddef.h>
+
+/**
+ * This file defines helpers for fast scanning of 8 bit samples. Sample is anything
+ * indexable returning sample level, plain unsigned char pointer, BitSamples of PlotData
+ * or accessor of raw device data.
+ */
+
+static const size_t SCAN_CHUNK = 64;
+
+/**
+ * Sample tests, written without branches so chunk loops in findFirst can be vectorized.
+ */
+struct AtLeast
+{
+    int threshold;
+    AtLeast(int threshold) : threshold(threshold) {}
+    int operator()(int v) const { return v >= threshold; }
+};
+
+struct AtMost
+{
+    int threshold;
+    AtMost(int threshold) : threshold(threshold) {}
+    int operator()(int v) const { return v <= threshold; }
+};
+
+struct Inside
+{
+    int low;
+    int high;
+    Inside(int low, int high) : low(low), high(high) {}
+    int operator()(int v) const { return (v >= low) & (v <= high); }
+};
+
+struct Outside
+{
+    int low;
+    int high;
+    Outside(int low, int high) : low(low), high(high) {}
+    int operator()(int v) const { return (v < low) | (v > high); }
+};
+
+/**
+ * @brief findFirst finds first sample in [from, to) passing test.
+ * Whole chunk is tested first without early exit, chunk is walked sample by sample only if something matched.
+ * @return returns index of found sample or to if there is none.
+ */
+template<class Sample, class Test>
+inline size_t findFirst(const Sample & sample, size_t from, size_t to, const Test & test)
+{
+    size_t i = from;
+    while(i < to)
+    {
+        size_t end = qMin(to, i+SCAN_CHUNK);
+        int hits = 0;
+        for(size_t j = i; j < end; ++j)
+        {
+            hits |= test(sample[j]);
+        }
+        if(hits)
+        {
+            for(; i < end; ++i)
+            {
+                if(test(sample[i]))
+                    return i;
+            }
+        }
+        i = end;
+    }
+    return to;
+}
+
+/**
+ * @brief findEdges appends indexes of samples in [from, to) which differ from previous sample.
+ * Chunk is compared whole without branches first and walked only if it contains some change,
+ * so long runs of unchanged samples cost one vectorized pass.
+ * @param edges anything with append(size_t).
+ */
+template<class Sample, class Edges>
+inline void findEdges(const Sample & sample, size_t from, size_t to, Edges & edges)
+{
+    size_t i = qMax(from, static_cast<size_t>(1));
+    while(i < to)
+    {
+        size_t end = qMin(to, i+SCAN_CHUNK);
+        int changes = 0;
+        for(size_t j = i; j < end; ++j)
+        {
+            changes |= sample[j] != sample[j-1];
+        }
+        if(changes)
+        {
+            for(size_t j = i; j < end; ++j)
+            {
+                if(sample[j] != sample[j-1])
+                    edges.append(j);
+            }
+        }
+        i = end;
+    }
+}
+
+/**
+ * @brief findLast finds last sample in [from, to) passing test, used for short searches back from found sample.
+ * @return returns index of found sample or to if there is none.
+ */
+template<class Sample, class Test>
+inline size_t findLast(const Sample & sample, size_t from, size_t to, const Test & test)
+{
+    for(size_t i = to; i > from; --i)
+    {
+        if(test(sample[i-1]))
+            return i-1;
+    }
+    return to;
+}
+
+#endif
@@ -0,0 +1,221 @@
+//
+//   SpectrumAnalyzer.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "SpectrumAnalyzer.h"
+#include <QtConcurrentRun>
+#include <math.h>
+
+/**
+ * @brief SpectrumAnalyzer::SpectrumAnalyzer
+ * @param source analog data, data are not owned.
+ * @param parent
+ */
+SpectrumAnalyzer::SpectrumAnalyzer(PlotData * source, QObject * parent) :
+    QObject(parent), source(source), length(1 << 16), window(Fft::Hann),
+    averaging(NoAveraging), averages(8), fft(NULL), pending(false),
+    settingsVersion(0), computedSettings(0), sourceVersion(0), accumulatedCount(0), version(0), computedLength(0)
+{
+    connect(&watcher, SIGNAL(finished()), this, SLOT(computed()));
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer()
+{
+    watcher.waitForFinished();
+    delete(fft);
+}
+
+/**
+ * @brief SpectrumAnalyzer::reset drops averaged spectrum and forces new computation,
+ * computation already running is done with old settings, so its result is dropped too.
+ */
+void SpectrumAnalyzer::reset()
+{
+    ++settingsVersion;
+    accumulated.clear();
+    accumulatedCount = 0;
+    sourceVersion = 0;
+    update();
+}
+
+/**
+ * @brief SpectrumAnalyzer::setLength
+ * @param length FFT length, power of two up to MAX_LENGTH.
+ */
+void SpectrumAnalyzer::setLength(int length)
+{
+    if(not Fft::isPowerOfTwo(length) or length > MAX_LENGTH)
+        return;
+    this->length = length;
+    reset();
+}
+
+void SpectrumAnalyzer::setWindow(int window)
+{
+    this->window = window;
+    reset();
+}
+
+/**
+ * @brief SpectrumAnalyzer::setAveraging
+ * @param averaging mode from Averaging enum.
+ * @param averages number of blocks in linear average, older blocks decay exponentially.
+ */
+void SpectrumAnalyzer::setAveraging(int averaging, int averages)
+{
+    this->averaging = averaging;
+    this->averages = qMax(1, averages);
+    reset();
+}
+
+/**
+ * @brief SpectrumAnalyzer::getBinWidth
+ * @return returns frequency step between bins in Hz.
+ */
+double SpectrumAnalyzer::getBinWidth()
+{
+    if(computedLength == 0 or source->getDiv() == 0)
+        return 0;
+    return 1e12/source->getDiv()/computedLength;
+}
+
+/**
+ * @brief SpectrumAnalyzer::update starts computation on newest samples if they changed.
+ * When computation is already running it is repeated once after it finishes.
+ */
+void SpectrumAnalyzer::update()
+{
+    if(source->getVersion() == sourceVersion)
+        return;
+    if(watcher.isRunning())
+    {
+        pending = true;
+        return;
+    }
+    size_t available = source->lastPositionOnBit(0);
+    int n = length;
+    while(n > 4 and size_t(n) > available)
+        n /= 2;
+    if(size_t(n) > available)
+        return;
+    sourceVersion = source->getVersion();
+    BitSamples data = source->getSamples(0);
+    size_t first = available-n;
+    QVector<float> samples(n);
+    for(int i = 0; i < n; ++i)
+    {
+        samples[i] = (data[first+i]-128)/128.0f;
+    }
+    if(fft == NULL or fft->getSize() != n)
+    {
+        delete(fft);
+        fft = new Fft(n);
+    }
+    computedSettings = settingsVersion;
+    watcher.setFuture(QtConcurrent::run(this, &SpectrumAnalyzer::compute, samples, window));
+}
+
+/**
+ * @brief SpectrumAnalyzer::compute runs on worker thread.
+ * @param samples
+ * @param window
+ * @return returns power spectrum normalized so that full scale sine has 0 dB.
+ */
+QVector<float> SpectrumAnalyzer::compute(QVector<float> samples, int window)
+{
+    int n = samples.size();
+    const QVector<float> & coefficients = fft->getWindow(window);
+    double sum = 0;
+    for(int i = 0; i < n; ++i)
+    {
+        samples[i] *= coefficients[i];
+        sum += coefficients[i];
+    }
+    QVector<float> power(n/2+1);
+    fft->powerSpectrum(samples.data(), power.data());
+    float scale = 4/(sum*sum);
+    for(int i = 0; i <= n/2; ++i)
+    {
+        power[i] *= scale;
+    }
+    return power;
+}
+
+/**
+ * @brief SpectrumAnalyzer::computed averages finished spectrum and converts it to dB.
+ */
+void SpectrumAnalyzer::computed()
+{
+    if(computedSettings != settingsVersion)
+    { // settings changed while computing
+        pending = false;
+        update();
+        return;
+    }
+    QVector<float> power = watcher.result();
+    if(accumulated.size() != power.size())
+    {
+        accumulated.clear();
+        accumulatedCount = 0;
+    }
+    if(averaging == NoAveraging or accumulatedCount == 0)
+    {
+        accumulated = power;
+    }
+    else if(averaging == LinearAveraging)
+    {
+        float weight = 1.0f/qMin(accumulatedCount+1, averages);
+        for(int i = 0; i < power.size(); ++i)
+        {
+            accumulated[i] += (power[i]-accumulated[i])*weight;
+        }
+    }
+    else
+    {
+        for(int i = 0; i < power.size(); ++i)
+        {
+            accumulated[i] = qMax(accumulated[i], power[i]);
+        }
+    }
+    ++accumulatedCount;
+    computedLength = (power.size()-1)*2;
+    spectrum.resize(accumulated.size());
+    for(int i = 0; i < accumulated.size(); ++i)
+    {
+        spectrum[i] = 10*log10(qMax(accumulated[i], 1e-20f));
+    }
+    ++version;
+    emit spectrumUpdated();
+    if(pending)
+    {
+        pending = false;
+        update();
+    }
+}
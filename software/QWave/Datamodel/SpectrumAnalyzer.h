@@ -0,0 +1,91 @@
+//
+//   SpectrumAnalyzer.h
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef QWave_SpectrumAnalyzer_h
+#define QWave_SpectrumAnalyzer_h
+
+#include <QObject>
+#include <QVector>
+#include <QFutureWatcher>
+#include "PlotData.h"
+#include "Fft.h"
+
+/**
+ * @brief The SpectrumAnalyzer class computes spectrum of newest samples of analog data.
+ * FFT runs on worker thread, while it runs further update requests are merged into one.
+ * Result of computation started before settings changed is dropped.
+ * Spectra of consecutive blocks can be averaged or peak held.
+ */
+class SpectrumAnalyzer : public QObject
+{
+    Q_OBJECT
+    PlotData * source;
+    int length;
+    int window;
+    int averaging;
+    int averages;
+    Fft * fft;
+    QFutureWatcher<QVector<float> > watcher;
+    bool pending;
+    int settingsVersion;
+    int computedSettings;
+    uint64_t sourceVersion;
+    QVector<float> accumulated;
+    int accumulatedCount;
+    QVector<float> spectrum;
+    uint64_t version;
+    int computedLength;
+    QVector<float> compute(QVector<float> samples, int window);
+    void reset();
+public:
+    enum Averaging { NoAveraging, LinearAveraging, PeakHold };
+    static const int MAX_LENGTH = 1 << 22;
+    SpectrumAnalyzer(PlotData * source, QObject * parent = 0);
+    ~SpectrumAnalyzer();
+    PlotData * getSource() { return source; }
+    void setLength(int length);
+    int getLength() { return length; }
+    void setWindow(int window);
+    int getWindow() { return window; }
+    void setAveraging(int averaging, int averages = 8);
+    int getAveraging() { return averaging; }
+    const QVector<float> & getSpectrum() { return spectrum; }
+    double getBinWidth();
+    uint64_t getVersion() { return version; }
+public slots:
+    void update();
+private slots:
+    void computed();
+signals:
+    void spectrumUpdated();
+};
+
+#endif
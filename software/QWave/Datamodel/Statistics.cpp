@@ -0,0 +1,301 @@
+//
+//   Statistics.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Statistics.h"
+#include "SampleScan.h"
+#include "Constants.h"
+#include <math.h>
+
+void RunningStatistics::add(double value)
+{
+    if(count == 0)
+    {
+        minimum = value;
+        maximum = value;
+    }
+    ++count;
+    double delta = value-mean;
+    mean += delta/count;
+    m2 += delta*(value-mean);
+    minimum = qMin(minimum, value);
+    maximum = qMax(maximum, value);
+}
+
+/**
+ * @brief RunningStatistics::merge adds values of other statistics (Chan's parallel variant of Welford's algorithm).
+ * @param other
+ */
+void RunningStatistics::merge(const RunningStatistics & other)
+{
+    if(other.count == 0)
+        return;
+    if(count == 0)
+    {
+        *this = other;
+        return;
+    }
+    uint64_t total = count+other.count;
+    double delta = other.mean-mean;
+    mean += delta*other.count/total;
+    m2 += other.m2+delta*delta*(static_cast<double>(count)*other.count/total);
+    count = total;
+    minimum = qMin(minimum, other.minimum);
+    maximum = qMax(maximum, other.maximum);
+}
+
+double RunningStatistics::getStdDev() const
+{
+    return sqrt(getVariance());
+}
+
+Histogram::Histogram(int binCount, double low, double binWidth) : bins(binCount, 0), low(low), binWidth(binWidth)
+{
+}
+
+/**
+ * @brief Histogram::grow merges pairs of bins, doubling range of histogram.
+ */
+void Histogram::grow()
+{
+    int half = bins.size()/2;
+    for(int i = 0; i < half; ++i)
+    {
+        bins[i] = bins[2*i]+bins[2*i+1];
+    }
+    for(int i = half; i < bins.size(); ++i)
+    {
+        bins[i] = 0;
+    }
+    binWidth *= 2;
+}
+
+/**
+ * @brief Histogram::add
+ * @param value values lower than low are counted in first bin.
+ * @param count
+ */
+void Histogram::add(double value, uint64_t count)
+{
+    while(value >= low+binWidth*bins.size())
+        grow();
+    int bin = static_cast<int>((value-low)/binWidth);
+    bins[qMax(0, bin)] += count;
+}
+
+uint64_t Histogram::getMaximum() const
+{
+    uint64_t maximum = 0;
+    for(int i = 0; i < bins.size(); ++i)
+    {
+        maximum = qMax(maximum, bins.at(i));
+    }
+    return maximum;
+}
+
+/**
+ * @brief StatisticsCollector::addChannel starts collecting statistics of quantity of given bit.
+ * Samples already present in data are counted too.
+ * @return returns id of channel.
+ */
+int StatisticsCollector::addChannel(PlotData * data, int bit, int quantity)
+{
+    Channel channel;
+    channel.data = data;
+    channel.bit = bit;
+    channel.quantity = quantity;
+    channels.insert(nextId, channel);
+    reset(nextId);
+    channels[nextId].position = 0;
+    return nextId++;
+}
+
+/**
+ * @brief StatisticsCollector::reset drops collected statistics, only samples appended later are counted.
+ * @param id
+ */
+void StatisticsCollector::reset(int id)
+{
+    if(not channels.contains(id))
+        return;
+    Channel & channel = channels[id];
+    channel.position = channel.data->lastPositionOnBit(channel.bit);
+    channel.state = -1;
+    channel.hasRise = false;
+    channel.hasFall = false;
+    channel.statistics = RunningStatistics();
+    if(channel.quantity == Level)
+        channel.histogram = Histogram(256, 0, 1);
+    else
+        channel.histogram = Histogram(256, 0, channel.data->getDiv());
+}
+
+QString StatisticsCollector::getQuantityName(int quantity)
+{
+    switch(quantity)
+    {
+    case Level:
+        return "Level";
+    case HighWidth:
+        return "High width";
+    case LowWidth:
+        return "Low width";
+    case Period:
+        return "Period";
+    default:
+        return "Unknown";
+    }
+}
+
+/**
+ * @brief StatisticsCollector::accumulate adds samples appended since last call to all channels.
+ */
+void StatisticsCollector::accumulate()
+{
+    for(QMap<int, Channel>::iterator it = channels.begin(); it != channels.end(); ++it)
+    {
+        Channel & channel = it.value();
+        size_t end = channel.data->lastPositionOnBit(channel.bit);
+        if(end < channel.position)
+        { // data were rewritten, continue with new data
+            channel.position = 0;
+            channel.state = -1;
+            channel.hasRise = false;
+            channel.hasFall = false;
+        }
+        if(channel.quantity == Level)
+            accumulateLevels(channel, end);
+        else
+            accumulateEdges(channel, channel.data->getSamples(channel.bit), end);
+        channel.position = end;
+    }
+}
+
+/**
+ * @brief StatisticsCollector::accumulateLevels counts new samples into table of 256 levels,
+ * statistics and histogram are then updated once per level instead of once per sample.
+ */
+void StatisticsCollector::accumulateLevels(Channel & channel, size_t to)
+{
+    if(to <= channel.position)
+        return;
+    uint64_t counts[256] = { 0 };
+    for(size_t i = channel.position; i < to;)
+    {
+        size_t length;
+        const unsigned char * samples = channel.data->getRun(channel.bit, i, length);
+        length = qMin(length, to-i);
+        for(size_t ii = 0; ii < length; ++ii)
+        {
+            ++counts[samples[ii]];
+        }
+        i += length;
+    }
+    RunningStatistics block;
+    double sum = 0;
+    double sumOfSquares = 0;
+    for(int level = 0; level < 256; ++level)
+    {
+        if(counts[level] == 0)
+            continue;
+        if(block.count == 0)
+            block.minimum = level;
+        block.maximum = level;
+        block.count += counts[level];
+        sum += static_cast<double>(level)*counts[level];
+        sumOfSquares += static_cast<double>(level)*level*counts[level];
+        channel.histogram.add(level, counts[level]);
+    }
+    block.mean = sum/block.count;
+    block.m2 = qMax(0.0, sumOfSquares-sum*block.mean);
+    channel.statistics.merge(block);
+}
+
+/**
+ * @brief StatisticsCollector::accumulateEdges finds transitions in new samples and adds widths
+ * of pulses and periods between rising edges. Logic samples are high when HIGH, analog
+ * samples use threshold with hysteresis.
+ */
+void StatisticsCollector::accumulateEdges(Channel & channel, const BitSamples & samples, size_t to)
+{
+    bool analog = channel.data->getType() == PlotData::Linear;
+    int high = analog ? ANALOG_THRESHOLD+ANALOG_HYSTERESIS : HIGH;
+    int low = analog ? ANALOG_THRESHOLD-ANALOG_HYSTERESIS : HIGH-1;
+    double div = channel.data->getDiv();
+    size_t position = channel.position;
+    while(position < to)
+    {
+        if(channel.state == -1)
+        {
+            channel.state = samples[position] >= high ? 1 : 0;
+            if(not analog or channel.state == 1 or samples[position] <= low)
+                ++position;
+            else
+            { // between thresholds, wait for first defined level
+                size_t next = findFirst(samples, position, to, Outside(low+1, high-1));
+                if(next == to)
+                    break;
+                channel.state = samples[next] >= high ? 1 : 0;
+                position = next+1;
+            }
+            continue;
+        }
+        size_t edge = channel.state ? findFirst(samples, position, to, AtMost(low)) : findFirst(samples, position, to, AtLeast(high));
+        if(edge == to)
+            break;
+        if(channel.state)
+        { // falling
+            if(channel.quantity == HighWidth and channel.hasRise)
+            {
+                channel.statistics.add((edge-channel.lastRise)*div);
+                channel.histogram.add((edge-channel.lastRise)*div);
+            }
+            channel.lastFall = edge;
+            channel.hasFall = true;
+        }
+        else
+        { // rising
+            if(channel.quantity == LowWidth and channel.hasFall)
+            {
+                channel.statistics.add((edge-channel.lastFall)*div);
+                channel.histogram.add((edge-channel.lastFall)*div);
+            }
+            if(channel.quantity == Period and channel.hasRise)
+            {
+                channel.statistics.add((edge-channel.lastRise)*div);
+                channel.histogram.add((edge-channel.lastRise)*div);
+            }
+            channel.lastRise = edge;
+            channel.hasRise = true;
+        }
+        channel.state = not channel.state;
+        position = edge+1;
+    }
+}
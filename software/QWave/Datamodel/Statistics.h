@@ -0,0 +1,120 @@
+//
+//   Statistics.h
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef QWave_Statistics_h
+#define QWave_Statistics_h
+
+#include <QVector>
+#include <QMap>
+#include <QString>
+#include "PlotData.h"
+
+/**
+ * @brief The RunningStatistics struct keeps count, mean, variance, minimum and maximum
+ * of values without storing them (Welford's algorithm). Statistics of block can be
+ * computed separately and merged, which is cheaper than adding values one by one.
+ */
+struct RunningStatistics
+{
+    uint64_t count;
+    double mean;
+    double m2;
+    double minimum;
+    double maximum;
+    RunningStatistics() : count(0), mean(0), m2(0), minimum(0), maximum(0) {}
+    void add(double value);
+    void merge(const RunningStatistics & other);
+    double getVariance() const { return count > 1 ? m2/(count-1) : 0; }
+    double getStdDev() const;
+};
+
+/**
+ * @brief The Histogram class counts values in equally wide bins starting at low.
+ * When value doesn't fit, neighbouring bins are merged and bin width doubles,
+ * so histogram adapts to range of values without knowing it in advance.
+ */
+class Histogram
+{
+    QVector<uint64_t> bins;
+    double low;
+    double binWidth;
+    void grow();
+public:
+    Histogram(int binCount = 256, double low = 0, double binWidth = 1);
+    void add(double value, uint64_t count = 1);
+    int getBinCount() const { return bins.size(); }
+    uint64_t getBin(int bin) const { return bins.at(bin); }
+    double getLow() const { return low; }
+    double getBinWidth() const { return binWidth; }
+    uint64_t getMaximum() const;
+};
+
+/**
+ * @brief The StatisticsCollector class accumulates statistics of selected quantities
+ * of captured data. It is fed with samples appended by each captured block, blocks
+ * themselves are not kept. Widths and periods are in picoseconds, levels in raw sample units.
+ */
+class StatisticsCollector
+{
+public:
+    enum Quantity { Level, HighWidth, LowWidth, Period };
+    struct Channel
+    {
+        PlotData * data;
+        int bit;
+        int quantity;
+        size_t position;
+        int state;
+        size_t lastRise;
+        size_t lastFall;
+        bool hasRise;
+        bool hasFall;
+        RunningStatistics statistics;
+        Histogram histogram;
+    };
+    static const int ANALOG_THRESHOLD = 128;
+    static const int ANALOG_HYSTERESIS = 8;
+    StatisticsCollector() : nextId(0) {}
+    int addChannel(PlotData * data, int bit, int quantity);
+    void removeChannel(int id) { channels.remove(id); }
+    bool hasChannel(int id) { return channels.contains(id); }
+    const Channel & getChannel(int id) { return channels[id]; }
+    void reset(int id);
+    void accumulate();
+    static QString getQuantityName(int quantity);
+private:
+    QMap<int, Channel> channels;
+    int nextId;
+    static void accumulateLevels(Channel & channel, size_t to);
+    static void accumulateEdges(Channel & channel, const BitSamples & samples, size_t to);
+};
+
+#endif
@@ -0,0 +1,177 @@
+//
+//   StringPool.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "StringPool.h"
+#include "../Exceptions/Exception.h"
+#include <QMutexLocker>
+#include <QHash>
+#include <string.h>
+
+static const int INITIAL_TABLE_SIZE = 1024;
+
+StringPool::StringPool() : current(NULL), blockUsed(BLOCK_SIZE), entryCount(0), table(INITIAL_TABLE_SIZE, -1)
+{
+    intern("");
+}
+
+StringPool::~StringPool()
+{
+    for(int i = 0; i < blocks.count(); ++i)
+    {
+        delete[] blocks.at(i);
+    }
+    for(int i = 0; i*PAGE_SIZE < entryCount; ++i)
+    {
+        delete[] pages[i];
+    }
+}
+
+/**
+ * @brief StringPool::instance
+ * @return returns application wide pool of names.
+ */
+StringPool & StringPool::instance()
+{
+    static StringPool pool;
+    return pool;
+}
+
+/**
+ * @brief StringPool::intern finds name in pool or adds it.
+ * @param text
+ * @return returns id of name, equal names have equal ids.
+ */
+int StringPool::intern(const QString & text)
+{
+    QByteArray utf8 = text.toUtf8();
+    uint hash = qHash(utf8);
+    QMutexLocker locker(&mutex);
+    int mask = table.size()-1;
+    int slot = hash & mask;
+    while(table.at(slot) >= 0)
+    {
+        const Entry & found = entry(table.at(slot));
+        if(found.hash == hash and found.length == utf8.size()
+           and memcmp(found.data, utf8.constData(), found.length) == 0)
+        {
+            return table.at(slot);
+        }
+        slot = (slot+1) & mask;
+    }
+    int id = entryCount;
+    if(id%PAGE_SIZE == 0)
+    {
+        if(id/PAGE_SIZE == MAX_PAGES)
+        {
+            throw Exception("Too many distinct names.");
+        }
+        pages[id/PAGE_SIZE] = new Entry[PAGE_SIZE];
+    }
+    Entry & added = pages[id/PAGE_SIZE][id%PAGE_SIZE];
+    added.data = store(utf8);
+    added.length = utf8.size();
+    added.hash = hash;
+    ++entryCount;
+    table[slot] = id;
+    if(entryCount*2 > table.size())
+    {
+        rehash();
+    }
+    return id;
+}
+
+/**
+ * @brief StringPool::at reads name without locking, entry of id is complete before intern
+ * returns the id, so any thread which got the id can read it.
+ * @param id id returned by intern.
+ * @return returns name with given id.
+ */
+QString StringPool::at(int id)
+{
+    const Entry & found = entry(id);
+    return QString::fromUtf8(found.data, found.length);
+}
+
+/**
+ * @brief StringPool::count
+ * @return returns number of distinct names in pool.
+ */
+int StringPool::count()
+{
+    QMutexLocker locker(&mutex);
+    return entryCount;
+}
+
+/**
+ * @brief StringPool::store copies name to end of current arena block, names longer
+ * than block get block of their own. Blocks never move, so stored names stay valid.
+ * @return returns copy of name in arena.
+ */
+const char * StringPool::store(const QByteArray & utf8)
+{
+    int length = utf8.size();
+    if(length > BLOCK_SIZE)
+    {
+        char * own = new char[length];
+        memcpy(own, utf8.constData(), length);
+        blocks.push_back(own);
+        return own;
+    }
+    if(blockUsed+length > BLOCK_SIZE)
+    {
+        current = new char[BLOCK_SIZE];
+        blocks.push_back(current);
+        blockUsed = 0;
+    }
+    char * data = current+blockUsed;
+    memcpy(data, utf8.constData(), length);
+    blockUsed += length;
+    return data;
+}
+
+/**
+ * @brief StringPool::rehash doubles hash table, it is kept at most half full.
+ */
+void StringPool::rehash()
+{
+    QVector<int> bigger(table.size()*2, -1);
+    int mask = bigger.size()-1;
+    for(int id = 0; id < entryCount; ++id)
+    {
+        int slot = entry(id).hash & mask;
+        while(bigger.at(slot) >= 0)
+        {
+            slot = (slot+1) & mask;
+        }
+        bigger[slot] = id;
+    }
+    table = bigger;
+}
@@ -0,0 +1,81 @@
+//
+//   StringPool.h
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef QWave_StringPool_h
+#define QWave_StringPool_h
+
+#include <QVector>
+#include <QMutex>
+#include <QString>
+
+/**
+ * @brief The StringPool class interns names of scopes and signals. Every distinct
+ * name is stored once as UTF-8 in large arena blocks and referred to by its id,
+ * so names repeated across huge hierarchies cost a single copy. Id 0 is empty name.
+ * Names are kept until the application exits. Entries are stored in pages which
+ * never move, so existing names are read without locking.
+ */
+class StringPool
+{
+public:
+    static StringPool & instance();
+    int intern(const QString & text);
+    QString at(int id);
+    int count();
+private:
+    struct Entry
+    {
+        const char * data;
+        int length;
+        uint hash;
+    };
+    static const int BLOCK_SIZE = 64*1024;
+    static const int PAGE_BITS = 12;
+    static const int PAGE_SIZE = 1 << PAGE_BITS;
+    static const int MAX_PAGES = 1 << 14;
+    StringPool();
+    ~StringPool();
+    StringPool(const StringPool &);
+    StringPool & operator=(const StringPool &);
+    const char * store(const QByteArray & utf8);
+    void rehash();
+    const Entry & entry(int id) const { return pages[id >> PAGE_BITS][id & (PAGE_SIZE-1)]; }
+    QMutex mutex;
+    QVector<char *> blocks;
+    char * current;
+    int blockUsed;
+    Entry * pages[MAX_PAGES];
+    int entryCount;
+    QVector<int> table;
+};
+
+#endif
@@ -0,0 +1,164 @@
+//
+//   Decoder.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Decoder.h"
+#include "../Datamodel/SampleScan.h"
+
+Decoder::Decoder(QVector<DecoderChannel> channels) : decodedTo(0), longest(0), channels(channels)
+{
+}
+
+/**
+ * @brief Decoder::findEdges
+ * @param channel
+ * @param from
+ * @param to
+ * @return returns sorted indexes of samples in [from, to) where channel changed.
+ */
+QVector<size_t> Decoder::findEdges(int channel, size_t from, size_t to)
+{
+    QVector<size_t> edges;
+    if(isConnected(channel))
+        ::findEdges(channels.at(channel).data->getSamples(channels.at(channel).bit), from, to, edges);
+    return edges;
+}
+
+/**
+ * @brief Decoder::findEdges
+ * @return returns sorted indexes of samples in [from, to) where any of two channels changed,
+ * sample where both changed is returned once.
+ */
+QVector<size_t> Decoder::findEdges(int channel, int otherChannel, size_t from, size_t to)
+{
+    QVector<size_t> first = findEdges(channel, from, to);
+    QVector<size_t> second = findEdges(otherChannel, from, to);
+    QVector<size_t> merged;
+    merged.reserve(first.size()+second.size());
+    int i = 0;
+    int j = 0;
+    while(i < first.size() or j < second.size())
+    {
+        if(j == second.size() or (i < first.size() and first.at(i) < second.at(j)))
+        {
+            merged.append(first.at(i++));
+        }
+        else if(i == first.size() or second.at(j) < first.at(i))
+        {
+            merged.append(second.at(j++));
+        }
+        else
+        {
+            merged.append(first.at(i++));
+            ++j;
+        }
+    }
+    return merged;
+}
+
+/**
+ * @brief Decoder::annotate adds annotation, annotations have to be added in order of start.
+ */
+void Decoder::annotate(size_t start, size_t end, QString label, int level)
+{
+    annotations.append(Annotation(start, end, label, level));
+    longest = qMax(longest, end-start);
+}
+
+/**
+ * @brief Decoder::getSampleRate
+ * @return returns sample rate of channels in samples per second.
+ */
+double Decoder::getSampleRate()
+{
+    uint64_t div = getData()->getDiv();
+    return div == 0 ? 0 : 1e12/div;
+}
+
+/**
+ * @brief Decoder::reset drops all annotations, data will be decoded from beginning on next update.
+ */
+void Decoder::reset()
+{
+    annotations.clear();
+    versions.clear();
+    decodedTo = 0;
+    longest = 0;
+    resetState();
+}
+
+/**
+ * @brief Decoder::update decodes samples appended since last update.
+ * When some of channels were rewritten, everything is decoded again.
+ */
+void Decoder::update()
+{
+    size_t available = channels.first().data->lastPositionOnBit(channels.first().bit);
+    bool rewritten = false;
+    for(int i = 0; i < channels.size(); ++i)
+    {
+        PlotData * data = channels.at(i).data;
+        if(data == NULL)
+            continue;
+        available = qMin(available, data->lastPositionOnBit(channels.at(i).bit));
+        if(versions.contains(data) and data->getDirtySince(versions.value(data)).first < decodedTo)
+            rewritten = true;
+    }
+    if(rewritten)
+        reset();
+    for(int i = 0; i < channels.size(); ++i)
+    {
+        if(channels.at(i).data != NULL)
+            versions.insert(channels.at(i).data, channels.at(i).data->checkpointVersion());
+    }
+    if(available > decodedTo)
+        decodedTo = decode(decodedTo, available);
+}
+
+/**
+ * @brief Decoder::findAnnotation
+ * @param sample
+ * @return returns index of first annotation which may end at or after sample.
+ */
+int Decoder::findAnnotation(size_t sample)
+{
+    size_t start = sample > longest ? sample-longest : 0;
+    int low = 0;
+    int high = annotations.size();
+    while(low < high)
+    {
+        int middle = (low+high)/2;
+        if(annotations.at(middle).start < start)
+            low = middle+1;
+        else
+            high = middle;
+    }
+    return low;
+}
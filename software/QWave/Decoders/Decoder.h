@@ -0,0 +1,105 @@
+//
+//   Decoder.h
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef QWave_Decoder_h
+#define QWave_Decoder_h
+
+#include <QString>
+#include <QVector>
+#include <QMap>
+#include "../Datamodel/PlotData.h"
+#include "../Datamodel/Constants.h"
+
+/**
+ * @brief The DecoderChannel struct binds decoder input to one bit of plot data.
+ * Channel without data is not connected.
+ */
+struct DecoderChannel
+{
+    PlotData * data;
+    int bit;
+    DecoderChannel(PlotData * data = NULL, int bit = 0) : data(data), bit(bit) {}
+};
+
+/**
+ * @brief The Annotation struct is one decoded item, samples [start, end] on given annotation row.
+ */
+struct Annotation
+{
+    size_t start;
+    size_t end;
+    QString label;
+    int level;
+    Annotation() : start(0), end(0), level(0) {}
+    Annotation(size_t start, size_t end, QString label, int level) : start(start), end(end), label(label), level(level) {}
+};
+
+/**
+ * @brief The Decoder class is base of protocol decoders.
+ * Decoder consumes edges of its channels and produces annotations sorted by start.
+ * Decoding is incremental, each update decodes only samples appended since previous update,
+ * state of unfinished frame is kept by decoder between updates. All channels are expected
+ * to have same div and start at same time.
+ */
+class Decoder
+{
+    QMap<PlotData*, uint64_t> versions;
+    QVector<Annotation> annotations;
+    size_t decodedTo;
+    size_t longest;
+protected:
+    QVector<DecoderChannel> channels;
+    bool isConnected(int channel) { return channel < channels.size() and channels.at(channel).data != NULL; }
+    int level(int channel, size_t sample) { return channels.at(channel).data->at(channels.at(channel).bit, sample) == HIGH; }
+    QVector<size_t> findEdges(int channel, size_t from, size_t to);
+    QVector<size_t> findEdges(int channel, int otherChannel, size_t from, size_t to);
+    void annotate(size_t start, size_t end, QString label, int level);
+    double getSampleRate();
+    /**
+     * @brief decode decodes samples [from, to).
+     * @return returns sample from which next decode has to continue,
+     * samples of unfinished frame are decoded again when more data arrive.
+     */
+    virtual size_t decode(size_t from, size_t to) = 0;
+    virtual void resetState() = 0;
+public:
+    Decoder(QVector<DecoderChannel> channels);
+    virtual ~Decoder() {}
+    virtual QString getName() = 0;
+    virtual int getLevels() = 0;
+    PlotData * getData() { return channels.first().data; }
+    void update();
+    void reset();
+    const QVector<Annotation> & getAnnotations() { return annotations; }
+    int findAnnotation(size_t sample);
+};
+
+#endif
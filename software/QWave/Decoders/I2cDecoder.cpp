@@ -0,0 +1,96 @@
+//
+//   I2cDecoder.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "I2cDecoder.h"
+
+I2cDecoder::I2cDecoder(DecoderChannel scl, DecoderChannel sda) :
+    Decoder(QVector<DecoderChannel>() << scl << sda)
+{
+    resetState();
+}
+
+/**
+ * @brief I2cDecoder::decode walks edges of both lines. SDA change while SCL is high
+ * is start or stop condition, otherwise SDA is sampled on rising edge of SCL.
+ */
+size_t I2cDecoder::decode(size_t from, size_t to)
+{
+    QVector<size_t> edges = findEdges(Scl, Sda, from, to);
+    for(int i = 0; i < edges.size(); ++i)
+    {
+        size_t e = edges.at(i);
+        int scl = level(Scl, e);
+        int sda = level(Sda, e);
+        int previousScl = level(Scl, e-1);
+        int previousSda = level(Sda, e-1);
+        if(sda != previousSda and scl and previousScl)
+        {
+            if(sda)
+            {
+                annotate(e, e, "Stop", 1);
+                inTransfer = false;
+            }
+            else
+            {
+                annotate(e, e, inTransfer ? "Repeated start" : "Start", 1);
+                inTransfer = true;
+                addressByte = true;
+                bits = 0;
+                value = 0;
+            }
+            continue;
+        }
+        if(not inTransfer or scl == previousScl or not scl)
+            continue;
+        if(bits < 8)
+        {
+            if(bits == 0)
+                byteStart = e;
+            value = (value << 1) | sda;
+            if(++bits == 8)
+            {
+                QString text = "0x"+QString::number(addressByte ? value >> 1 : value, 16).toUpper();
+                if(addressByte)
+                    annotate(byteStart, e, "Address "+text+((value & 1) ? " R" : " W"), 0);
+                else
+                    annotate(byteStart, e, "Data "+text, 0);
+            }
+        }
+        else
+        {
+            annotate(e, e, sda ? "NACK" : "ACK", 1);
+            addressByte = false;
+            bits = 0;
+            value = 0;
+        }
+    }
+    return to;
+}
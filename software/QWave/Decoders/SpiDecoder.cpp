@@ -0,0 +1,93 @@
+//
+//   SpiDecoder.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "SpiDecoder.h"
+
+/**
+ * @brief SpiDecoder::SpiDecoder
+ * @param mode SPI mode 0-3, bit 1 is clock polarity, bit 0 is clock phase.
+ */
+SpiDecoder::SpiDecoder(DecoderChannel clock, DecoderChannel mosi, DecoderChannel miso, DecoderChannel chipSelect,
+                       int mode, int wordBits, bool msbFirst) :
+    Decoder(QVector<DecoderChannel>() << clock << mosi << miso << chipSelect), mode(mode), wordBits(wordBits), msbFirst(msbFirst)
+{
+    resetState();
+}
+
+void SpiDecoder::addBit(int & word, int bit)
+{
+    if(msbFirst)
+        word = (word << 1) | bit;
+    else
+        word |= bit << bits;
+}
+
+/**
+ * @brief SpiDecoder::decode samples data lines on sampling clock edges while chip select is low.
+ * Sampling edge is rising for modes 0 and 3 and falling for modes 1 and 2.
+ */
+size_t SpiDecoder::decode(size_t from, size_t to)
+{
+    int polarity = (mode >> 1) & 1;
+    int phase = mode & 1;
+    int samplingLevel = polarity == phase ? 1 : 0;
+    QVector<size_t> edges = findEdges(Clock, ChipSelect, from, to);
+    for(int i = 0; i < edges.size(); ++i)
+    {
+        size_t e = edges.at(i);
+        if(isConnected(ChipSelect))
+        {
+            if(level(ChipSelect, e) != level(ChipSelect, e-1))
+            { // word is aligned to chip select
+                resetState();
+            }
+            if(level(ChipSelect, e))
+                continue;
+        }
+        if(level(Clock, e) == level(Clock, e-1) or level(Clock, e) != samplingLevel)
+            continue;
+        if(bits == 0)
+            wordStart = e;
+        addBit(mosi, level(Mosi, e));
+        if(isConnected(Miso))
+            addBit(miso, level(Miso, e));
+        if(++bits == wordBits)
+        {
+            annotate(wordStart, e, "0x"+QString::number(mosi, 16).toUpper(), 0);
+            if(isConnected(Miso))
+                annotate(wordStart, e, "0x"+QString::number(miso, 16).toUpper(), 1);
+            bits = 0;
+            mosi = 0;
+            miso = 0;
+        }
+    }
+    return to;
+}
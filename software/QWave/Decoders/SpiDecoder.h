@@ -0,0 +1,63 @@
+//
+//   SpiDecoder.h
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef QWave_SpiDecoder_h
+#define QWave_SpiDecoder_h
+
+#include "Decoder.h"
+
+/**
+ * @brief The SpiDecoder class decodes SPI words.
+ * Channels are clock, MOSI, MISO and active low chip select, MISO and chip select are optional.
+ * MOSI words are annotated on row 0, MISO words on row 1.
+ */
+class SpiDecoder : public Decoder
+{
+    int mode;
+    int wordBits;
+    bool msbFirst;
+    int bits;
+    int mosi;
+    int miso;
+    size_t wordStart;
+    void addBit(int & word, int bit);
+protected:
+    size_t decode(size_t from, size_t to);
+    void resetState() { bits = 0; mosi = 0; miso = 0; wordStart = 0; }
+public:
+    enum Channel { Clock, Mosi, Miso, ChipSelect };
+    SpiDecoder(DecoderChannel clock, DecoderChannel mosi, DecoderChannel miso, DecoderChannel chipSelect,
+               int mode = 0, int wordBits = 8, bool msbFirst = true);
+    QString getName() { return "SPI"; }
+    int getLevels() { return 2; }
+};
+
+#endif
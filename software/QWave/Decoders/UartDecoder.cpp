@@ -0,0 +1,98 @@
+//
+//   UartDecoder.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UartDecoder.h"
+
+UartDecoder::UartDecoder(DecoderChannel rx, int baudRate, int dataBits, int parity, int stopBits) :
+    Decoder(QVector<DecoderChannel>() << rx), baudRate(baudRate), dataBits(dataBits), parity(parity), stopBits(stopBits)
+{
+}
+
+/**
+ * @brief UartDecoder::getLabel
+ * @param value
+ * @return returns hex value followed by character if it is printable.
+ */
+QString UartDecoder::getLabel(int value)
+{
+    QString label = "0x"+QString::number(value, 16).toUpper();
+    if(value >= 32 and value < 127)
+        label += " '"+QString(QChar(value))+"'";
+    return label;
+}
+
+/**
+ * @brief UartDecoder::decode finds start bits on falling edges and samples bits in their middle.
+ * Frame which doesn't fit into available samples is left for next decode.
+ */
+size_t UartDecoder::decode(size_t from, size_t to)
+{
+    double bitLength = getSampleRate()/baudRate;
+    if(bitLength < 1)
+        return to;
+    int frameBits = 1+dataBits+(parity == NoParity ? 0 : 1)+stopBits;
+    QVector<size_t> edges = findEdges(0, from, to);
+    size_t position = from;
+    for(int i = 0; i < edges.size(); ++i)
+    {
+        size_t start = edges.at(i);
+        if(start < position or level(0, start) != 0)
+            continue;
+        size_t end = start+static_cast<size_t>(frameBits*bitLength);
+        if(end > to)
+            return start;
+        int value = 0;
+        int ones = 0;
+        for(int bit = 0; bit < dataBits; ++bit)
+        {
+            int b = level(0, start+static_cast<size_t>((bit+1.5)*bitLength));
+            value |= b << bit;
+            ones += b;
+        }
+        annotate(start, end, getLabel(value), 0);
+        if(parity != NoParity)
+        {
+            ones += level(0, start+static_cast<size_t>((dataBits+1.5)*bitLength));
+            if((ones%2 == 0) != (parity == EvenParity))
+                annotate(start, end, "Parity error", 1);
+        }
+        bool framed = true;
+        for(int bit = frameBits-stopBits; bit < frameBits; ++bit)
+        {
+            framed = framed and level(0, start+static_cast<size_t>((bit+0.5)*bitLength));
+        }
+        if(not framed)
+            annotate(start, end, "Framing error", 1);
+        // next start bit can't begin before middle of stop bit
+        position = start+static_cast<size_t>((frameBits-0.5)*bitLength);
+    }
+    return to;
+}
@@ -37,90 +37,135 @@
 #include <QSet>
 #include <QSetIterator>
 #include "Capabilities.h"
+#include "../Instrumentation/Profiler.h"
+#include "../Datamodel/MemoryManager.h"
 
 #define BLOCKS_BEFORE_DISSALOWED_OVERLAP 2048
 
 CaptureController::CaptureController(QObject *parent) :
-    QObject(parent), currentDataIndex(0), canvas(NULL), run(1), lastend(0)
+    QObject(parent), currentDataIndex(0), capturePending(false), continousSet(false), captureCompleted(false), run(1), lastend(0)
 {
 
 }
 
 /**
  * @brief CaptureController::updateData this method is called when all captured data from device was transmitted.
- * This method converts raw data into data model and updates canvas view to show new data.
+ * This method converts raw data into data model, scans new data with software trigger
+ * and notifies views that new data were appended.
  */
 void CaptureController::updateData()
 {
-    uint i;
-    qDebug() <<"updating data in controller";
-    QVector<uint8_t*> dataList = static_cast<AbstractDevice*>(sender())->getRawDataList();
+    AbstractDevice* device = static_cast<AbstractDevice*>(sender());
+    qHotDebug() <<"updating data in controller";
+    QVector<uint8_t*> dataList = device->getRawDataList();
+    unsigned int length = device->getRawDataLength();
     PlotData* plotData = NULL;
-    if(static_cast<AbstractDevice*>(sender())->getRawDataLength() != 0)
+    uint64_t position = 0;
+    bool triggered = false;
+    if(length != 0)
     {
-        for(int dataId = 0; dataId < dataList.count(); ++dataId)
+        QVector<unsigned char> column(length > currentDataIndex ? length-currentDataIndex : 0);
+        device->lockData();
+        for(int dataId = 0; dataId < dataList.count() and not column.isEmpty(); ++dataId)
         {
-            QPair<PlotData*, int > pair = deviceDataMap[dataId][static_cast<AbstractDevice*>(sender())][0];
+            QPair<PlotData*, int > pair = deviceDataMap[dataId][device][0];
             if(pair.first == NULL)
             {
                 continue;
             }
+            if(plotData == NULL)
+            {
+                position = pair.first->lastPositionOnBit(0);
+            }
             plotData = pair.first;
             uint8_t* data = dataList.at(dataId);
-            for(i = currentDataIndex; i < static_cast<AbstractDevice*>(sender())->getRawDataLength(); ++i)
+            if(plotData->getType() == PlotData::Logic)
             {
-                if(plotData->getType() == PlotData::Logic)
+                const uint16_t* digital = reinterpret_cast<uint16_t*>(data)+currentDataIndex;
+                for(int bitNumber = 0; bitNumber < 16; ++bitNumber)
                 {
-                    for(int bitNumber = 0; bitNumber < 16; ++bitNumber)
+                    PlotData* logicData = deviceDataMap[dataId][device][bitNumber].first;
+                    if(logicData == NULL)
+                        continue;
+                    int bw = logicData->getBitwidth();
+                    for(int bitNum = 0; bitNum < bw; ++bitNum)
                     {
-                            QPair<PlotData*, int > pair = deviceDataMap[dataId][static_cast<AbstractDevice*>(sender())][bitNumber];
-                            PlotData* plotData = pair.first;
-                            if(plotData == NULL)
-                                continue;
-                            int bw = plotData->getBitwidth();
-                            for(int bitNum = 0; bitNum < bw; ++bitNum)
+                        {
+                            ScopedTimer timer(Profiler::Demux);
+                            unsigned char* out = column.data();
+                            int shift = bitNum+bitNumber;
+                            for(int s = 0; s < column.count(); ++s)
                             {
-                                static_cast<AbstractDevice*>(sender())->lockData();
-                                uint16_t dataint = reinterpret_cast<uint16_t*>(data)[i];
-                                static_cast<AbstractDevice*>(sender())->unlockData();
-                                if(((dataint >> (bitNum+bitNumber)) & 1))
-                                {
-                                    plotData->appendDataAtBit(bw-1-bitNum, HIGH);
-                                }
-                                else
-                                {
-                                    plotData->appendDataAtBit(bw-1-bitNum, LOW);
-                                }
-                                //qDebug() << static_cast<AbstractDevice*>(sender())->getRawDataLength();
-                                //qDebug("Thread id %d", reinterpret_cast<ulong>(QThread::currentThreadId()));
-                                //qDebug() << "Last append digital: " << plotData->lastPositionOnBit(bw-1-bitNum);
+                                out[s] = ((digital[s] >> shift) & 1) ? HIGH : LOW;
                             }
-                     }
-                }
-                else
-                {
-                    static_cast<AbstractDevice*>(sender())->lockData();
-                    plotData->appendDataAtBit(0, data[i]);
-                    //qDebug("Thread id %d", reinterpret_cast<ulong>(QThread::currentThreadId()));
-                    //qDebug() << "Last append analog: " << plotData->lastPositionOnBit(0);
-                    static_cast<AbstractDevice*>(sender())->unlockData();
+                        }
+                        ScopedTimer timer(Profiler::ModelAppend);
+                        logicData->appendDataAtBit(bw-1-bitNum, column.constData(), column.count());
+                    }
                 }
             }
+            else
+            {
+                ScopedTimer timer(Profiler::ModelAppend);
+                plotData->appendDataAtBit(0, data+currentDataIndex, column.count());
+            }
         }
-        currentDataIndex = i;
-        if(canvas != NULL)
-            canvas->repaint();
         if(plotData != NULL)
+        {
+            ScopedTimer timer(Profiler::TriggerScan);
+            triggered = softwareTrigger.scan(dataList, currentDataIndex, length, position);
+        }
+        {
+            ScopedTimer timer(Profiler::Statistics);
+            statistics.accumulate();
+        }
+        int maskFailures = 0;
+        if(maskTest.isEnabled())
+        { // with software trigger blocks are triggered segments, otherwise every run is one block
+            ScopedTimer timer(Profiler::MaskTest);
+            if(not softwareTrigger.isEnabled())
+                maskTest.addBlock();
+            else if(triggered)
+                maskTest.addSegment(softwareTrigger.getSegmentStart());
+            maskFailures = maskTest.process();
+        }
+        device->unlockData();
+        unsigned int appended = length-currentDataIndex;
+        currentDataIndex = length;
+        emit dataAppended();
+        if(triggered)
+        {
+            emit softwareTriggered(softwareTrigger.getTriggerPosition()*plotData->getDiv());
+            emit newFrom(softwareTrigger.getSegmentStart()*plotData->getDiv());
+        }
+        else if(plotData != NULL and not softwareTrigger.isEnabled())
         {
             emit newFrom((lastend+BLOCKS_BEFORE_DISSALOWED_OVERLAP*2)*plotData->getDiv());
+        }
+        if(plotData != NULL)
+        {
             lastend = plotData->lastPositionOnBit(0);
         }
+        if(maskTest.isEnabled())
+        {
+            emit maskTested(maskTest.getPassed(), maskTest.getFailed());
+            if(maskFailures > 0)
+                emit maskFailed(maskTest.getLastViolation()*maskTest.getData()->getDiv());
+            if(maskFailures > 0 and maskTest.getStopOnFailure())
+                stopCapture();
+        }
         ++run;
-        qDebug() << "run number: " << run;
+        qHotDebug() << "run number: " << run;
+        emit captureFinished(appended);
+        MemoryManager::instance().enforce();
+    }
+    else
+    { // device gave up waiting for data
+        emit captureTimedOut();
     }
     if(continousSet and run < INT_MAX)
     {
-        startCapture(continousSet, oldPlots);
+        startCapture(continousSet, oldData);
     }
 }
 
@@ -193,39 +238,49 @@ void CaptureController::addFt245Device()
 }
 
 /**
- * @brief CaptureController::getDeviceByPlot
- * @param plot
- * @return  returns device assigned to given plot
+ * @brief CaptureController::getDeviceByData
+ * @param plotData
+ * @return  returns device assigned to given plot data
+ */
+AbstractDevice* CaptureController::getDeviceByData(PlotData* plotData)
+{
+    return plotDeviceMap[plotData];
+}
+
+/**
+ * @brief CaptureController::getDataIdByData
+ * @param plotData
+ * @return return data id assigned to given plot data
  */
-AbstractDevice* CaptureController::getDeviceByPlot(Plot* plot)
+int CaptureController::getDataIdByData(PlotData* plotData)
 {
-    return plotDeviceMap[plot->getData()];
+    return plotDataIdMap[plotData];
 }
 
 /**
- * @brief CaptureController::getDataIdByPlot
- * @param plot
- * @return return data id assigned to given plot
+ * @brief CaptureController::stopCapture stops continous capture after current run.
  */
-int CaptureController::getDataIdByPlot(Plot* plot)
+void CaptureController::stopCapture()
 {
-    return plotDataIdMap[plot->getData()];
+    continousSet = false;
+    emit rollModeChanged(false);
 }
 
 /**
  * @brief CaptureController::startCapture
  * Triggered when user pushes arm button, caries out process of correctly initializing capture, by
- * examining opened plots to set combination of triggered inputs.
+ * examining assigned plot data to set combination of triggered inputs.
  * @param continous
- * @param plots
+ * @param data
  */
-void CaptureController::startCapture(bool continous, QVector<Plot*> plots)
+void CaptureController::startCapture(bool continous, QVector<PlotData*> data)
 {
     currentDataIndex = 0;
     captureCompleted = false;
     capturePending = true;
     continousSet = continous;
-    oldPlots = plots;
+    oldData = data;
+    emit rollModeChanged(continous and not softwareTrigger.isEnabled());
     QSet<AbstractDevice*> devices;
     QMap<AbstractDevice*, bool> hasAnalog1;
     QMap<AbstractDevice*, bool> hasAnalog2;
@@ -237,15 +292,17 @@ void CaptureController::startCapture(bool continous, QVector<Plot*> plots)
         hasAnalog2[dev] = false;
         hasDigital[dev] = false;
     }
-    for(int i = 0; i < plots.count(); ++i)
+    for(int i = 0; i < data.count(); ++i)
     {
-        AbstractDevice* dev = plotDeviceMap[plots[i]->getData()];
+        if(not plotDeviceMap.contains(data[i]))
+            continue;
+        AbstractDevice* dev = plotDeviceMap[data[i]];
         devices.insert(dev);
-        if(plotDataIdMap[plots[i]->getData()] == 0)
+        if(plotDataIdMap[data[i]] == 0)
             hasAnalog1[dev] = true;
-        if(plotDataIdMap[plots[i]->getData()] == 1)
+        if(plotDataIdMap[data[i]] == 1)
             hasAnalog2[dev] = true;
-        if(plotDataIdMap[plots[i]->getData()] == 2)
+        if(plotDataIdMap[data[i]] == 2)
             hasDigital[dev] = true;
     }
     QSetIterator<AbstractDevice*> i(devices);
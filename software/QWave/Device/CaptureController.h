@@ -37,9 +37,10 @@
 #include <QMap>
 #include <QPair>
 #include "DeviceController.h"
+#include "SoftwareTrigger.h"
+#include "../Datamodel/Statistics.h"
+#include "../Datamodel/MaskTest.h"
 #include "../Datamodel/PlotData.h"
-#include "../GUI/Plot.h"
-#include "../GUI/PlotCanvas.h"
 
 /**
  * @brief The CaptureController class controls the data capture process
@@ -50,6 +51,9 @@ class CaptureController : public QObject
 {
     Q_OBJECT
     DeviceController controller;
+    SoftwareTrigger softwareTrigger;
+    StatisticsCollector statistics;
+    MaskTest maskTest;
     QMap<int, QMap<AbstractDevice*, QMap<int, QPair <PlotData*, int> > > > deviceDataMap;
     QMap<AbstractDevice*, int> currentWireIndex;
     QMap<AbstractDevice*, bool> analog1free;
@@ -57,21 +61,22 @@ class CaptureController : public QObject
     QMap<PlotData*, int> plotDataIdMap;
     QMap<PlotData*, AbstractDevice*> plotDeviceMap;
     unsigned int currentDataIndex;
-    PlotCanvas* canvas;
     bool capturePending;
     bool continousSet;
     bool captureCompleted;
-    QVector<Plot*> oldPlots;
+    QVector<PlotData*> oldData;
     int run;
     uint64_t lastend;
 public:
     bool hasDevice() { return controller.getlistOfDevices()->count() > 0;  }
     CaptureController(QObject *parent = 0);
-    AbstractDevice* getDeviceByPlot(Plot* plot);
-    int getDataIdByPlot(Plot* plot);
-    void startCapture(bool continous, QVector<Plot*> plots);
-    void setPlotCanvas(PlotCanvas* canvas) { this->canvas = canvas; }
-    void stopCapture() { continousSet = false; }
+    AbstractDevice* getDeviceByData(PlotData* plotData);
+    int getDataIdByData(PlotData* plotData);
+    void startCapture(bool continous, QVector<PlotData*> data);
+    void stopCapture();
+    SoftwareTrigger* getSoftwareTrigger() { return &softwareTrigger; }
+    StatisticsCollector* getStatistics() { return &statistics; }
+    MaskTest* getMaskTest() { return &maskTest; }
 public slots:
     void updateData();
     void addDummyDevice();
@@ -83,6 +88,13 @@ public slots:
     bool isAnalog2Free(AbstractDevice* dev) { return analog2free[dev]; }
 signals:
     void newFrom(uint64_t);
+    void dataAppended();
+    void rollModeChanged(bool);
+    void captureFinished(unsigned int samples);
+    void captureTimedOut();
+    void softwareTriggered(uint64_t);
+    void maskTested(uint64_t passed, uint64_t failed);
+    void maskFailed(uint64_t);
 };
 
 #endif // CAPTURECONTROLLER_H
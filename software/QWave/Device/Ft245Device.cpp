@@ -36,6 +36,7 @@
 #include <QThread>
 #include <QSemaphore>
 #include "../Exceptions/DeviceException.h"
+#include "../Instrumentation/Profiler.h"
 
 #define READ_LENGTH 16384
 #define WRITE_LENGTH 10
@@ -417,8 +418,14 @@ void Ft245DeviceCapturer::doCapture()
     int skew = 0;
     while(incoming == READ_LENGTH)
     {
-        while((incoming = ft245cnt->read(bufIn)) == 0)
+        while(true)
         {
+            { // waits between retries are not part of read time
+                ScopedTimer timer(Profiler::UsbRead);
+                incoming = ft245cnt->read(bufIn);
+            }
+            if(incoming != 0)
+                break;
             if(wait++ > 5)
             {
                 usleep(500000);
@@ -0,0 +1,460 @@
+//
+//   SoftwareTrigger.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "SoftwareTrigger.h"
+#include "../Datamodel/SampleScan.h"
+
+#define PATTERN_BITS 16
+
+/**
+ * Sample accessors, both return sample level in 0-255 range.
+ */
+struct AnalogSample
+{
+    const uint8_t* data;
+    AnalogSample(const uint8_t* data) : data(data) {}
+    int operator[](size_t i) const { return data[i]; }
+};
+
+struct DigitalBitSample
+{
+    const uint16_t* data;
+    int bit;
+    DigitalBitSample(const uint16_t* data, int bit) : data(data), bit(bit) {}
+    int operator[](size_t i) const { return ((data[i] >> bit) & 1)*255; }
+};
+
+/**
+ * @brief findPattern finds first digital word in [from, to) which matches (or does not match) pattern.
+ * @return returns index of found word or to if there is none.
+ */
+static size_t findPattern(const uint16_t* data, size_t from, size_t to, uint16_t mask, uint16_t value, bool matching)
+{
+    int expected = matching ? 1 : 0;
+    size_t i = from;
+    while(i < to)
+    {
+        size_t end = qMin(to, i+SCAN_CHUNK);
+        int hits = 0;
+        for(size_t j = i; j < end; ++j)
+        {
+            hits |= ((data[j] & mask) == value) == expected;
+        }
+        if(hits)
+        {
+            for(; i < end; ++i)
+            {
+                if(((data[i] & mask) == value) == expected)
+                    return i;
+            }
+        }
+        i = end;
+    }
+    return to;
+}
+
+SoftwareTrigger::SoftwareTrigger()
+    :   enabled(false),
+        condition(Edge),
+        source(Analog1),
+        bit(0),
+        positive(true),
+        level(128),
+        secondLevel(0),
+        lessThan(true),
+        width(0),
+        preTrigger(0),
+        state(0),
+        pulseStart(0),
+        triggered(false),
+        triggerPosition(0)
+{
+}
+
+/**
+ * @brief SoftwareTrigger::reset forgets scanning state, called whenever condition changes.
+ */
+void SoftwareTrigger::reset()
+{
+    state = 0;
+    pulseStart = 0;
+    triggered = false;
+}
+
+/**
+ * @brief SoftwareTrigger::setEdge sets edge trigger, signal has to leave hysteresis band
+ * on the opposite side of level before edge is accepted, so noise around level does not trigger.
+ * @param source
+ * @param rising
+ * @param level
+ * @param hysteresis
+ */
+void SoftwareTrigger::setEdge(int source, bool rising, uint8_t level, uint8_t hysteresis)
+{
+    condition = Edge;
+    this->source = source;
+    positive = rising;
+    this->level = level;
+    secondLevel = hysteresis;
+    reset();
+}
+
+/**
+ * @brief SoftwareTrigger::setPulseWidth sets trigger on pulse shorter or longer than width.
+ * Pulse shorter than width triggers at its end, pulse longer triggers as soon as width is exceeded.
+ * @param source
+ * @param positive true for high pulses, false for low pulses.
+ * @param level
+ * @param hysteresis
+ * @param lessThan
+ * @param width width in samples.
+ */
+void SoftwareTrigger::setPulseWidth(int source, bool positive, uint8_t level, uint8_t hysteresis, bool lessThan, uint64_t width)
+{
+    condition = PulseWidth;
+    this->source = source;
+    this->positive = positive;
+    this->level = level;
+    secondLevel = hysteresis;
+    this->lessThan = lessThan;
+    this->width = width;
+    reset();
+}
+
+/**
+ * @brief SoftwareTrigger::setRunt sets trigger on pulse crossing low level but returning without reaching high level
+ * (or the other way round for negative runt).
+ * @param source
+ * @param positive
+ * @param low
+ * @param high
+ */
+void SoftwareTrigger::setRunt(int source, bool positive, uint8_t low, uint8_t high)
+{
+    condition = Runt;
+    this->source = source;
+    this->positive = positive;
+    level = qMin(low, high);
+    secondLevel = qMax(low, high);
+    reset();
+}
+
+/**
+ * @brief SoftwareTrigger::setWindow sets trigger on signal entering or leaving window [low, high].
+ * @param source
+ * @param entering
+ * @param low
+ * @param high
+ */
+void SoftwareTrigger::setWindow(int source, bool entering, uint8_t low, uint8_t high)
+{
+    condition = Window;
+    this->source = source;
+    positive = entering;
+    level = qMin(low, high);
+    secondLevel = qMax(low, high);
+    reset();
+}
+
+/**
+ * @brief SoftwareTrigger::setPattern sets trigger on sequence of patterns on digital input.
+ * Each pattern is pair of mask and value, trigger fires when last pattern starts to match
+ * after all previous ones matched in order.
+ * @param patterns
+ */
+void SoftwareTrigger::setPattern(QVector<QPair<uint16_t, uint16_t> > patterns)
+{
+    condition = Pattern;
+    source = Digital;
+    this->patterns = patterns;
+    reset();
+}
+
+/**
+ * @brief SoftwareTrigger::fire remembers trigger position, only first trigger of scan is kept.
+ * @param position
+ */
+void SoftwareTrigger::fire(uint64_t position)
+{
+    if(not triggered)
+    {
+        triggered = true;
+        triggerPosition = position;
+    }
+}
+
+/**
+ * @brief SoftwareTrigger::scan scans samples [from, to) of raw device data.
+ * @param dataList raw data of device, indexed by Source.
+ * @param from
+ * @param to
+ * @param position absolute position (in data model) of sample from.
+ * @return returns true if trigger condition occured in scanned samples,
+ * position of trigger is then available from getTriggerPosition.
+ */
+bool SoftwareTrigger::scan(const QVector<uint8_t*> & dataList, size_t from, size_t to, uint64_t position)
+{
+    triggered = false;
+    if(not enabled or from >= to or source >= dataList.count())
+        return false;
+    uint64_t base = position-from;
+    if(condition == Pattern)
+    {
+        if(not patterns.isEmpty())
+            scanPattern(reinterpret_cast<const uint16_t*>(dataList.at(Digital)), from, to, base);
+    }
+    else if(source == Digital)
+    {
+        scanLevels(DigitalBitSample(reinterpret_cast<const uint16_t*>(dataList.at(Digital)), bit), from, to, base);
+    }
+    else
+    {
+        scanLevels(AnalogSample(dataList.at(source)), from, to, base);
+    }
+    return triggered;
+}
+
+/**
+ * @brief SoftwareTrigger::scanLevels runs state machine of level based conditions.
+ * Every state waits for one sample test, so scanning is sequence of findFirst calls.
+ * @param sample
+ * @param from
+ * @param to
+ * @param base absolute position of sample with index 0.
+ */
+template<class Sample>
+void SoftwareTrigger::scanLevels(const Sample & sample, size_t from, size_t to, uint64_t base)
+{
+    //level where edge or pulse is armed again, at least one step away from level
+    int arm = positive ? level-qMax<int>(secondLevel, 1) : level+qMax<int>(secondLevel, 1);
+    size_t i = from;
+    while(i < to)
+    {
+        if(condition == Edge or condition == PulseWidth)
+        {
+            if(state == 0)
+            {
+                i = positive ? findFirst(sample, i, to, AtMost(arm)) : findFirst(sample, i, to, AtLeast(arm));
+                if(i < to)
+                    state = 1;
+            }
+            else if(state == 1)
+            {
+                i = positive ? findFirst(sample, i, to, AtLeast(level)) : findFirst(sample, i, to, AtMost(level));
+                if(i == to)
+                    break;
+                if(condition == Edge)
+                {
+                    fire(base+i);
+                    state = 0;
+                }
+                else
+                {
+                    pulseStart = base+i;
+                    state = 2;
+                }
+            }
+            else
+            {
+                //searching pulse end, longer pulses are fired once they are too long
+                size_t limit = to;
+                if(state == 2 and not lessThan and pulseStart+width+1 < base+to)
+                {
+                    limit = qMax<size_t>(i, pulseStart+width+1-base);
+                }
+                size_t end = positive ? findFirst(sample, i, limit, AtMost(arm)) : findFirst(sample, i, limit, AtLeast(arm));
+                if(end == limit and limit < to)
+                {
+                    fire(base+limit);
+                    state = 3;
+                    i = limit;
+                    continue;
+                }
+                i = end;
+                if(i == to)
+                    break;
+                if(state == 2 and lessThan and base+i-pulseStart < width)
+                {
+                    fire(base+i);
+                }
+                state = 1;
+            }
+        }
+        else if(condition == Runt)
+        {
+            int low = level;
+            int high = secondLevel;
+            //outer is level where signal rests, inner is level runt does not reach
+            if(state == 0)
+            {
+                i = positive ? findFirst(sample, i, to, AtMost(low)) : findFirst(sample, i, to, AtLeast(high));
+                if(i < to)
+                    state = 1;
+            }
+            else if(state == 1)
+            {
+                i = positive ? findFirst(sample, i, to, AtLeast(low+1)) : findFirst(sample, i, to, AtMost(high-1));
+                if(i < to)
+                    state = 2;
+            }
+            else if(state == 2)
+            {
+                i = findFirst(sample, i, to, Outside(low+1, high-1));
+                if(i == to)
+                    break;
+                bool returned = positive ? sample[i] <= low : sample[i] >= high;
+                if(returned)
+                {
+                    fire(base+i);
+                    state = 1;
+                }
+                else
+                {
+                    state = 3;
+                }
+            }
+            else
+            {
+                //full pulse, wait until it returns
+                i = positive ? findFirst(sample, i, to, AtMost(low)) : findFirst(sample, i, to, AtLeast(high));
+                if(i < to)
+                    state = 1;
+            }
+        }
+        else if(condition == Window)
+        {
+            bool waitOutside = (state == 0) == positive;
+            i = waitOutside ? findFirst(sample, i, to, Outside(level, secondLevel)) : findFirst(sample, i, to, Inside(level, secondLevel));
+            if(i == to)
+                break;
+            if(state == 1)
+            {
+                fire(base+i);
+            }
+            state = 1-state;
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief SoftwareTrigger::scanPattern waits for patterns in order, after firing waits until
+ * last pattern stops matching, so one long pattern fires only once.
+ * @param data
+ * @param from
+ * @param to
+ * @param base absolute position of sample with index 0.
+ */
+void SoftwareTrigger::scanPattern(const uint16_t* data, size_t from, size_t to, uint64_t base)
+{
+    size_t i = from;
+    while(i < to)
+    {
+        if(state >= patterns.count())
+        {
+            i = findPattern(data, i, to, patterns.last().first, patterns.last().second, false);
+            if(i < to)
+                state = 0;
+            continue;
+        }
+        i = findPattern(data, i, to, patterns.at(state).first, patterns.at(state).second, true);
+        if(i == to)
+            break;
+        ++state;
+        if(state == patterns.count())
+        {
+            fire(base+i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+/**
+ * @brief SoftwareTrigger::parsePattern parses pattern written from highest bit, as string of '0', '1' and 'X'.
+ * Missing high bits are don't care.
+ * @param text
+ * @param mask
+ * @param value
+ * @return returns false if text is not valid pattern.
+ */
+bool SoftwareTrigger::parsePattern(const QString & text, uint16_t & mask, uint16_t & value)
+{
+    QString pattern = text.trimmed().toUpper();
+    if(pattern.isEmpty() or pattern.length() > PATTERN_BITS)
+        return false;
+    mask = 0;
+    value = 0;
+    for(int i = 0; i < pattern.length(); ++i)
+    {
+        int bitNumber = pattern.length()-1-i;
+        if(pattern.at(i) == '1')
+        {
+            mask |= 1 << bitNumber;
+            value |= 1 << bitNumber;
+        }
+        else if(pattern.at(i) == '0')
+        {
+            mask |= 1 << bitNumber;
+        }
+        else if(pattern.at(i) != 'X')
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief SoftwareTrigger::patternToString
+ * @param mask
+ * @param value
+ * @return returns pattern in form accepted by parsePattern.
+ */
+QString SoftwareTrigger::patternToString(uint16_t mask, uint16_t value)
+{
+    QString pattern;
+    for(int bitNumber = PATTERN_BITS-1; bitNumber >= 0; --bitNumber)
+    {
+        if(not (mask & (1 << bitNumber)))
+            pattern += 'X';
+        else if(value & (1 << bitNumber))
+            pattern += '1';
+        else
+            pattern += '0';
+    }
+    return pattern;
+}
@@ -0,0 +1,101 @@
+//
+//   SoftwareTrigger.h
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef SOFTWARETRIGGER_H
+#define SOFTWARETRIGGER_H
+
+#include <QVector>
+#include <QPair>
+#include <QString>
+#include <inttypes.h>
+
+/**
+ * @brief The SoftwareTrigger class evaluates trigger conditions on the host over raw device
+ * blocks as they arrive, for conditions firmware cannot do. Blocks are scanned in chunks,
+ * chunks where nothing can happen are skipped by branchless tests the compiler vectorizes.
+ * Scanning state is kept between blocks, so conditions may span block boundaries.
+ */
+class SoftwareTrigger
+{
+public:
+    enum Condition { Edge, PulseWidth, Runt, Pattern, Window };
+    enum Source { Analog1, Analog2, Digital };
+private:
+    bool enabled;
+    int condition;
+    int source;
+    int bit;
+    bool positive;
+    uint8_t level;
+    uint8_t secondLevel;
+    bool lessThan;
+    uint64_t width;
+    QVector<QPair<uint16_t, uint16_t> > patterns;
+    uint64_t preTrigger;
+    //scanning state
+    int state;
+    uint64_t pulseStart;
+    bool triggered;
+    uint64_t triggerPosition;
+    template<class Sample>
+    void scanLevels(const Sample & sample, size_t from, size_t to, uint64_t base);
+    void scanPattern(const uint16_t* data, size_t from, size_t to, uint64_t base);
+    void fire(uint64_t position);
+public:
+    SoftwareTrigger();
+    void setEdge(int source, bool rising, uint8_t level, uint8_t hysteresis);
+    void setPulseWidth(int source, bool positive, uint8_t level, uint8_t hysteresis, bool lessThan, uint64_t width);
+    void setRunt(int source, bool positive, uint8_t low, uint8_t high);
+    void setWindow(int source, bool entering, uint8_t low, uint8_t high);
+    void setPattern(QVector<QPair<uint16_t, uint16_t> > patterns);
+    void setDigitalBit(int bit) { this->bit = bit; reset(); }
+    void setPreTrigger(uint64_t samples) { preTrigger = samples; }
+    void setEnabled(bool enabled) { this->enabled = enabled; reset(); }
+    bool isEnabled() { return enabled; }
+    int getCondition() { return condition; }
+    int getSource() { return source; }
+    int getDigitalBit() { return bit; }
+    bool isPositive() { return positive; }
+    uint8_t getLevel() { return level; }
+    uint8_t getSecondLevel() { return secondLevel; }
+    bool isLessThan() { return lessThan; }
+    uint64_t getWidth() { return width; }
+    QVector<QPair<uint16_t, uint16_t> > getPatterns() { return patterns; }
+    uint64_t getPreTrigger() { return preTrigger; }
+    void reset();
+    bool scan(const QVector<uint8_t*> & dataList, size_t from, size_t to, uint64_t base);
+    uint64_t getTriggerPosition() { return triggerPosition; }
+    uint64_t getSegmentStart() { return triggerPosition > preTrigger ? triggerPosition-preTrigger : 0; }
+    static bool parsePattern(const QString & text, uint16_t & mask, uint16_t & value);
+    static QString patternToString(uint16_t mask, uint16_t value);
+};
+
+#endif // SOFTWARETRIGGER_H
@@ -0,0 +1,123 @@
+//
+//   AnnotationPlot.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <QPainter>
+#include "AnnotationPlot.h"
+#include "../Instrumentation/Profiler.h"
+
+/**
+ * @brief AnnotationPlot::AnnotationPlot
+ * @param decoder decoder owned by this plot, data of it's first channel are used as plot data.
+ * @param name
+ */
+AnnotationPlot::AnnotationPlot(Decoder * decoder, QString name) : Plot(decoder->getData(), name), decoder(decoder), paintedCount(0)
+{
+    setHeight(decoder->getLevels()*DATASTRING_HEIGHT);
+    decode();
+}
+
+AnnotationPlot::~AnnotationPlot()
+{
+    delete(decoder);
+}
+
+/**
+ * @brief AnnotationPlot::decode decodes data appended since last decode.
+ */
+void AnnotationPlot::decode()
+{
+    ScopedTimer timer(Profiler::Decode);
+    decoder->update();
+}
+
+/**
+ * @brief AnnotationPlot::getChangedFrom
+ * @return returns start of first annotation decoded since last paint, or 0 if annotations were decoded again.
+ */
+size_t AnnotationPlot::getChangedFrom()
+{
+    const QVector<Annotation> & annotations = decoder->getAnnotations();
+    if(annotations.size() < paintedCount)
+        return 0;
+    if(annotations.size() == paintedCount)
+        return ALL_SAMPLES;
+    return annotations.at(paintedCount).start;
+}
+
+/**
+ * @brief AnnotationPlot::paint paints annotations overlapping painted range as boxes with labels.
+ * Annotations narrower than pixel are painted as single line, which is painted only once per pixel,
+ * so zoomed out view of long capture doesn't flood painter with overlapping items.
+ * Labels of annotations starting left of canvas are kept at its left edge, also when only strip of it is painted.
+ * @param painter
+ * @param startCoordY
+ * @param width
+ * @param fromTime
+ * @param divSize
+ */
+void AnnotationPlot::paint(QPainter * painter, int startCoordY, int width, uint64_t fromTime, double divSize)
+{
+    uint64_t div = getData()->getDiv();
+    if(div == 0 or divSize <= 0)
+        return;
+    const QVector<Annotation> & annotations = decoder->getAnnotations();
+    paintedCount = annotations.size();
+    // painter is moved right when canvas paints only strip of it
+    double canvasLeft = -painter->worldTransform().dx();
+    double firstSample = static_cast<double>(fromTime)/div;
+    size_t lastSample = static_cast<size_t>(firstSample+width/divSize)+1;
+    QColor colors[] = { QColor(255, 255, 180), QColor(255, 200, 0) };
+    int lastLineX[] = { -1, -1 };
+    int i = decoder->findAnnotation(static_cast<size_t>(firstSample));
+    while(i < annotations.size() and annotations.at(i).start <= lastSample)
+    {
+        const Annotation & annotation = annotations.at(i);
+        double x1 = (annotation.start-firstSample)*divSize;
+        double x2 = (annotation.end-firstSample)*divSize;
+        ++i;
+        if(x2 < 0)
+            continue;
+        int y = startCoordY+annotation.level*DATASTRING_HEIGHT;
+        painter->setPen(colors[annotation.level%2]);
+        if(x2-x1 < 1)
+        {
+            int x = static_cast<int>(x1);
+            if(x != lastLineX[annotation.level%2])
+                painter->drawLine(x, y+2, x, y+DATASTRING_HEIGHT-2);
+            lastLineX[annotation.level%2] = x;
+            continue;
+        }
+        int left = static_cast<int>(qMax(x1, canvasLeft-1));
+        int right = static_cast<int>(qMin(x2, width+1.0));
+        painter->drawRect(left, y+2, right-left, DATASTRING_HEIGHT-4);
+        drawText(painter, left+2, y+2, right-left-2, DATASTRING_HEIGHT-4, annotation.label);
+    }
+}
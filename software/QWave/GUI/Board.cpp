@@ -32,15 +32,27 @@
 #include "Board.h"
 #include "Plot.h"
 #include "../Datamodel/PlotData.h"
+#include "../Datamodel/MemoryManager.h"
 #include <QFileInfo>
 #include <QRegExp>
 #include "../Datamodel/FileSplitter.h"
 #include "../Exceptions/IOException.h"
 #include <QDebug>
 #include <QMenu>
+#include <QInputDialog>
+#include <QMessageBox>
 #include "Window.h"
 #include "ProbeAssignDialog.h"
 #include "TriggerSetupDialog.h"
+#include "SoftwareTriggerDialog.h"
+#include "SpectrumPlot.h"
+#include "AnnotationPlot.h"
+#include "DecoderDialog.h"
+#include "MathPlot.h"
+#include "HistogramPlot.h"
+#include "EyePlot.h"
+#include "CompareDialog.h"
+#include "MaskDialog.h"
 #include "../Device/Capabilities.h"
 #include "ConnectDevice.h"
 
@@ -50,7 +62,8 @@
  * @param name name of tab
  * @param parent parent widget, in this application it is always instance of Window
  */
-Board::Board(QString & name, QWidget * parent) : name(name), QWidget(parent), randomSign('!'), controller(this), filePath("")
+Board::Board(QString & name, QWidget * parent) : name(name), QWidget(parent), loadJob(NULL), loadDialog(NULL), controller(this), filePath(""),
+    searchFrom(UINT64_MAX), searchHit(0), differenceFrom(UINT64_MAX), differenceTime(0)
 {
     ui.setupUi(this);
     treeModel = new PlotTreeModel();
@@ -67,10 +80,12 @@ Board::Board(QString & name, QWidget * parent) : name(name), QWidget(parent), ra
     connect(ui.plotNamesColumn, SIGNAL(pressed(QModelIndex)), this, SLOT(plotClickAction(QModelIndex)));
     ui.plotNamesColumn->setContextMenuPolicy(Qt::CustomContextMenu);
     connect(ui.plotNamesColumn, SIGNAL(customContextMenuRequested(QPoint)), this, SLOT(showPlotContextMenu(QPoint)));
-    controller.setPlotCanvas(ui.plotCanvas);
+    connect(&controller, SIGNAL(dataAppended()), ui.plotCanvas, SLOT(update()));
+    connect(&controller, SIGNAL(rollModeChanged(bool)), ui.plotCanvas, SLOT(setRollMode(bool)));
     ui.horizontalScrollBar->hide();
     connect(ui.horizontalScrollBar, SIGNAL(valueChanged(int)), this, SLOT(updateFromScroll(int)));
     connect(&controller, SIGNAL(newFrom(uint64_t)), this, SLOT(setFrom(uint64_t)));
+    connect(&controller, SIGNAL(maskTested(uint64_t, uint64_t)), this, SLOT(showMaskResults(uint64_t, uint64_t)));
 }
 
 /**
@@ -81,10 +96,13 @@ Board::Board(QString & name, QWidget * parent) : name(name), QWidget(parent), ra
 void Board::connectWindow(QObject * window)
 {
     connect(this, SIGNAL(updateStatusBar(QString)), static_cast<Window*>(window), SLOT(setStatusBarText(QString)));
+    connect(this, SIGNAL(closeRequested(Board*)), static_cast<Window*>(window), SLOT(closeBoard(Board*)));
 }
 
 Board::~Board() 
 {
+    // worker must stop before model it loads into is gone
+    delete(loadJob);
     delete(treeModel);
     qDebug() << "Board deleting";
 };
@@ -112,17 +130,148 @@ void Board::showPlotContextMenu(QPoint p)
 {
     qDebug("Context menu");
     QMenu contextMenu;
-    QAction interpolate("Toggle interpolation", this);
-    if(ui.plotCanvas->isAnalog(ui.plotNamesColumn->currentIndex().row()))
+    int row = ui.plotNamesColumn->currentIndex().row();
+    QMenu interpolationMenu("Interpolation");
+    QAction dots("Dots", this);
+    QAction linear("Linear", this);
+    QAction sinc("Sin(x)/x", this);
+    if(ui.plotCanvas->isAnalog(row))
     {
-        contextMenu.addAction(&interpolate);
-        connect(&interpolate, SIGNAL(triggered(bool)), this, SLOT(setInterpolateOnPlot()));
+        QAction* actions[] = { &dots, &linear, &sinc };
+        int modes[] = { Plot::Dots, Plot::Linear, Plot::Sinc };
+        for(int i = 0; i < 3; ++i)
+        {
+            actions[i]->setCheckable(true);
+            actions[i]->setChecked(ui.plotCanvas->getPlot(row)->getInterpolation() == modes[i]);
+            actions[i]->setData(modes[i]);
+            interpolationMenu.addAction(actions[i]);
+        }
+        contextMenu.addMenu(&interpolationMenu);
+        connect(&interpolationMenu, SIGNAL(triggered(QAction*)), this, SLOT(setInterpolationOnPlot(QAction*)));
     }
+    QAction showSpectrum("Show spectrum", this);
+    QMenu windowMenu("Window");
+    QMenu averagingMenu("Averaging");
+    QMenu lengthMenu("FFT length");
+    SpectrumPlot* spectrumPlot = dynamic_cast<SpectrumPlot*>(ui.plotCanvas->getPlot(row));
+    if(spectrumPlot != NULL)
+    {
+        SpectrumAnalyzer* analyzer = spectrumPlot->getAnalyzer();
+        const char* windows[] = { "Rectangular", "Hann", "Blackman-Harris", "Flat top" };
+        for(int i = Fft::Rectangular; i <= Fft::FlatTop; ++i)
+        {
+            QAction* action = windowMenu.addAction(windows[i]);
+            action->setCheckable(true);
+            action->setChecked(analyzer->getWindow() == i);
+            action->setData(i);
+        }
+        const char* averagings[] = { "None", "Linear", "Peak hold" };
+        for(int i = SpectrumAnalyzer::NoAveraging; i <= SpectrumAnalyzer::PeakHold; ++i)
+        {
+            QAction* action = averagingMenu.addAction(averagings[i]);
+            action->setCheckable(true);
+            action->setChecked(analyzer->getAveraging() == i);
+            action->setData(i);
+        }
+        for(int length = 1 << 10; length <= SpectrumAnalyzer::MAX_LENGTH; length *= 4)
+        {
+            QAction* action = lengthMenu.addAction(QString::number(length/1024)+"k");
+            action->setCheckable(true);
+            action->setChecked(analyzer->getLength() == length);
+            action->setData(length);
+        }
+        contextMenu.addMenu(&windowMenu);
+        contextMenu.addMenu(&averagingMenu);
+        contextMenu.addMenu(&lengthMenu);
+        connect(&windowMenu, SIGNAL(triggered(QAction*)), this, SLOT(setSpectrumWindow(QAction*)));
+        connect(&averagingMenu, SIGNAL(triggered(QAction*)), this, SLOT(setSpectrumAveraging(QAction*)));
+        connect(&lengthMenu, SIGNAL(triggered(QAction*)), this, SLOT(setSpectrumLength(QAction*)));
+    }
+    else if(ui.plotCanvas->isAnalog(row) and dynamic_cast<MathPlot*>(ui.plotCanvas->getPlot(row)) == NULL)
+    {
+        contextMenu.addAction(&showSpectrum);
+        connect(&showSpectrum, SIGNAL(triggered()), this, SLOT(addSpectrumPlot()));
+    }
+    QMenu statisticsMenu("Collect statistics");
+    QAction resetStatistics("Reset statistics", this);
+    Plot* plot = ui.plotCanvas->getPlot(row);
+    if(dynamic_cast<HistogramPlot*>(plot) != NULL)
+    {
+        contextMenu.addAction(&resetStatistics);
+        connect(&resetStatistics, SIGNAL(triggered()), this, SLOT(resetStatistics()));
+    }
+    else if(plot->isTimeBased() and dynamic_cast<MathPlot*>(plot) == NULL and dynamic_cast<AnnotationPlot*>(plot) == NULL)
+    {
+        for(int i = StatisticsCollector::Level; i <= StatisticsCollector::Period; ++i)
+        {
+            if(i == StatisticsCollector::Level and not plot->isAnalog())
+                continue;
+            statisticsMenu.addAction(StatisticsCollector::getQuantityName(i))->setData(i);
+        }
+        contextMenu.addMenu(&statisticsMenu);
+        connect(&statisticsMenu, SIGNAL(triggered(QAction*)), this, SLOT(addStatisticsPlot(QAction*)));
+    }
+    QAction showEye("Show eye diagram", this);
+    QAction resetEye("Reset eye diagram", this);
+    if(dynamic_cast<EyePlot*>(plot) != NULL)
+    {
+        contextMenu.addAction(&resetEye);
+        connect(&resetEye, SIGNAL(triggered()), this, SLOT(resetEyeDiagram()));
+    }
+    else if(plot->isTimeBased() and dynamic_cast<MathPlot*>(plot) == NULL and dynamic_cast<AnnotationPlot*>(plot) == NULL)
+    {
+        contextMenu.addAction(&showEye);
+        connect(&showEye, SIGNAL(triggered()), this, SLOT(addEyePlot()));
+    }
+    QMenu maskMenu("Mask test");
+    QAction createMask("Create mask from visible range...", this);
+    QAction disableMask("Disable mask test", this);
+    QAction resetMask("Reset mask counters", this);
+    QAction showMaskFailures("Show failed blocks...", this);
+    if(plot->isTimeBased() and plot->getData() != NULL and dynamic_cast<MathPlot*>(plot) == NULL
+       and dynamic_cast<AnnotationPlot*>(plot) == NULL)
+    {
+        maskMenu.addAction(&createMask);
+        connect(&createMask, SIGNAL(triggered()), this, SLOT(createMask()));
+        MaskTest* maskTest = controller.getMaskTest();
+        if(maskTest->isEnabled() and maskTest->getData() == plot->getData())
+        {
+            maskMenu.addAction(&disableMask);
+            maskMenu.addAction(&resetMask);
+            maskMenu.addAction(&showMaskFailures);
+            connect(&disableMask, SIGNAL(triggered()), this, SLOT(disableMask()));
+            connect(&resetMask, SIGNAL(triggered()), this, SLOT(resetMask()));
+            connect(&showMaskFailures, SIGNAL(triggered()), this, SLOT(showMaskFailures()));
+        }
+        contextMenu.addMenu(&maskMenu);
+    }
+    QAction addBitsView("Create view of bits...", this);
+    QAction addRangeView("Create view of visible range", this);
+    if(plot->isTimeBased() and plot->getData() != NULL and dynamic_cast<MathPlot*>(plot) == NULL
+       and dynamic_cast<AnnotationPlot*>(plot) == NULL)
+    {
+        if(plot->getData()->getBitwidth() > 1)
+        {
+            contextMenu.addAction(&addBitsView);
+            connect(&addBitsView, SIGNAL(triggered()), this, SLOT(addBitsView()));
+        }
+        contextMenu.addAction(&addRangeView);
+        connect(&addRangeView, SIGNAL(triggered()), this, SLOT(addRangeView()));
+    }
+    QAction addMath("Add math channel", this);
+    contextMenu.addAction(&addMath);
+    connect(&addMath, SIGNAL(triggered()), this, SLOT(addMathPlot()));
+    QAction addDecoder("Add protocol decoder", this);
+    contextMenu.addAction(&addDecoder);
+    connect(&addDecoder, SIGNAL(triggered()), this, SLOT(addDecoderPlot()));
     QAction remove("Remove", this);
     contextMenu.addAction(&remove);
     QAction setTrigger("Set trigger", this);
     contextMenu.addAction(&setTrigger);
     connect(&setTrigger, SIGNAL(triggered()), this, SLOT(openTriggerDialog()));
+    QAction setSoftwareTrigger("Set software trigger", this);
+    contextMenu.addAction(&setSoftwareTrigger);
+    connect(&setSoftwareTrigger, SIGNAL(triggered()), this, SLOT(openSoftwareTriggerDialog()));
     contextMenu.exec(ui.plotNamesColumn->mapToGlobal(p));
 }
 
@@ -134,7 +283,7 @@ void Board::openTriggerDialog()
 {
     TriggerSetupDialog triggerDialog;
     int plotIndexRow = ui.plotNamesColumn->currentIndex().row();
-    AbstractDevice* device = controller.getDeviceByPlot(ui.plotCanvas->getPlot(plotIndexRow));
+    AbstractDevice* device = controller.getDeviceByData(ui.plotCanvas->getPlot(plotIndexRow)->getData());
     int kind;
     if(ui.plotCanvas->isAnalog(plotIndexRow))
     {
@@ -145,16 +294,372 @@ void Board::openTriggerDialog()
         kind = DIGITAL;
     }
 
-    triggerDialog.assignTrigger(device, kind, controller.getDataIdByPlot(ui.plotCanvas->getPlot(plotIndexRow)));
+    triggerDialog.assignTrigger(device, kind, controller.getDataIdByData(ui.plotCanvas->getPlot(plotIndexRow)->getData()));
+}
+
+/**
+ * This function is triggered by user when he selects to set software trigger.
+ * @brief Board::openSoftwareTriggerDialog
+ */
+void Board::openSoftwareTriggerDialog()
+{
+    SoftwareTriggerDialog softwareTriggerDialog;
+    softwareTriggerDialog.setupTrigger(controller.getSoftwareTrigger());
+}
+
+/**
+ * This helper function sets interpolation chosen in context menu on selected plot.
+ * @brief Board::setInterpolationOnPlot
+ * @param action chosen action, holding interpolation in it's data.
+ */
+void Board::setInterpolationOnPlot(QAction* action)
+{
+    ui.plotCanvas->setInterpolation(ui.plotNamesColumn->currentIndex().row(), action->data().toInt());
+}
+
+/**
+ * Creates spectrum view of selected analog plot and appends it to list of plots.
+ * Spectrum is recomputed whenever capture appends new data.
+ * @brief Board::addSpectrumPlot
+ */
+void Board::addSpectrumPlot()
+{
+    Plot* source = ui.plotCanvas->getPlot(ui.plotNamesColumn->currentIndex().row());
+    SpectrumAnalyzer* analyzer = new SpectrumAnalyzer(source->getData());
+    SpectrumPlot* spectrumPlot = new SpectrumPlot(analyzer, "FFT "+source->getName());
+    connect(&controller, SIGNAL(dataAppended()), analyzer, SLOT(update()));
+    connect(analyzer, SIGNAL(spectrumUpdated()), ui.plotCanvas, SLOT(update()));
+    ui.plotNamesColumn->addItem(spectrumPlot->getName());
+    ui.plotCanvas->addPlot(spectrumPlot);
+    analyzer->update();
+}
+
+/**
+ * Presents DecoderDialog and appends annotation plot of created decoder to list of plots.
+ * @brief Board::addDecoderPlot
+ */
+void Board::addDecoderPlot()
+{
+    DecoderDialog decoderDialog(this);
+    Decoder* decoder = decoderDialog.createDecoder(ui.plotCanvas->getPlots());
+    if(decoder == NULL)
+        return;
+    AnnotationPlot* annotationPlot = new AnnotationPlot(decoder, decoder->getName());
+    connect(&controller, SIGNAL(dataAppended()), annotationPlot, SLOT(decode()));
+    if(loadJob != NULL)
+    {
+        connect(loadJob, SIGNAL(progress(qint64, qint64, int, int)), annotationPlot, SLOT(decode()));
+        connect(loadJob, SIGNAL(loaded()), annotationPlot, SLOT(decode()));
+    }
+    ui.plotNamesColumn->addItem(annotationPlot->getName());
+    ui.plotCanvas->addPlot(annotationPlot);
+}
+
+/**
+ * Asks for expression over analog plots and appends plot of resulting math channel to list of plots.
+ * @brief Board::addMathPlot
+ */
+void Board::addMathPlot()
+{
+    QVector<PlotData*> channels;
+    QString help = "Expression of ch1..chN, + - * /, integ(x), diff(x), avg(x, n), lowpass(x, t):";
+    for(int i = 0; i < ui.plotCanvas->getPlots().size(); ++i)
+    {
+        Plot* plot = ui.plotCanvas->getPlot(i);
+        if(not plot->isTimeBased() or not plot->isAnalog() or dynamic_cast<MathPlot*>(plot) != NULL
+           or channels.contains(plot->getData()))
+            continue;
+        channels.append(plot->getData());
+        help += "\nch"+QString::number(channels.size())+" = "+plot->getName();
+    }
+    if(channels.isEmpty())
+    {
+        QMessageBox::warning(this, "No data", "There are no analog plots to compute with.");
+        return;
+    }
+    bool ok;
+    QString expression = QInputDialog::getText(this, "Math channel", help, QLineEdit::Normal, "ch1", &ok);
+    if(not ok)
+        return;
+    try
+    {
+        MathPlot* mathPlot = new MathPlot(new MathChannel(expression, channels), expression);
+        ui.plotNamesColumn->addItem(mathPlot->getName());
+        ui.plotCanvas->addPlot(mathPlot);
+    }
+    catch(Exception e)
+    {
+        QMessageBox::warning(this, "Expression error", e.getMessage());
+    }
+}
+
+/**
+ * Registers view of source data and appends its plot to list of plots.
+ * @brief Board::addView
+ * @param source
+ * @param view
+ */
+void Board::addView(PlotData * source, PlotData * view)
+{
+    try
+    {
+        treeModel->registerView(source, view);
+    }
+    catch(Exception e)
+    {
+        delete(view);
+        QMessageBox::warning(this, "View error", e.getMessage());
+        return;
+    }
+    Plot* plot = new Plot(view, view->getName());
+    ui.plotNamesColumn->addItem(plot->getName());
+    ui.plotCanvas->addPlot(plot);
+}
+
+/**
+ * Asks for bits of selected plot and appends view showing just them as new signal.
+ * Samples are not copied, view reads them from selected plot.
+ * @brief Board::addBitsView
+ */
+void Board::addBitsView()
+{
+    Plot* source = ui.plotCanvas->getPlot(ui.plotNamesColumn->currentIndex().row());
+    PlotData* data = source->getData();
+    bool ok;
+    QString bitList = QInputDialog::getText(this, "View of bits", "Bits of "+source->getName()+" from most significant, e.g. 7..4 or 0, 2, 5:",
+                                            QLineEdit::Normal, QString::number(data->getBitwidth()-1)+"..0", &ok);
+    if(not ok)
+        return;
+    try
+    {
+        QVector<int> bits = PlotData::parseBits(bitList, data->getBitwidth());
+        addView(data, new PlotData(data, source->getName()+"["+bitList.simplified()+"]", getFreeSign(), bits));
+    }
+    catch(Exception e)
+    {
+        QMessageBox::warning(this, "Bits error", e.getMessage());
+    }
+}
+
+/**
+ * Appends view showing samples of selected plot in visible range, starting at time 0.
+ * @brief Board::addRangeView
+ */
+void Board::addRangeView()
+{
+    Plot* source = ui.plotCanvas->getPlot(ui.plotNamesColumn->currentIndex().row());
+    PlotData* data = source->getData();
+    uint64_t div = data->getDiv();
+    if(div == 0)
+        return;
+    size_t from = ui.plotCanvas->getFrom()/div;
+    size_t to = from+ui.plotCanvas->getScale()*getDivCount()/div;
+    QVector<int> bits;
+    for(int i = 0; i < data->getBitwidth(); ++i)
+    {
+        bits.append(i);
+    }
+    try
+    {
+        addView(data, new PlotData(data, source->getName()+" ["+QString::number(from)+".."+QString::number(to)+")", getFreeSign(), bits, from, to));
+    }
+    catch(Exception e)
+    {
+        QMessageBox::warning(this, "View error", e.getMessage());
+    }
+}
+
+/**
+ * Starts collecting statistics of quantity chosen in context menu on selected plot and appends
+ * histogram view of them to list of plots. Statistics are accumulated with every captured block.
+ * @brief Board::addStatisticsPlot
+ * @param action chosen action, holding quantity in it's data.
+ */
+void Board::addStatisticsPlot(QAction* action)
+{
+    Plot* source = ui.plotCanvas->getPlot(ui.plotNamesColumn->currentIndex().row());
+    int quantity = action->data().toInt();
+    StatisticsCollector* statistics = controller.getStatistics();
+    int id = statistics->addChannel(source->getData(), 0, quantity);
+    statistics->accumulate();
+    HistogramPlot* histogramPlot = new HistogramPlot(statistics, id, StatisticsCollector::getQuantityName(quantity)+" "+source->getName());
+    ui.plotNamesColumn->addItem(histogramPlot->getName());
+    ui.plotCanvas->addPlot(histogramPlot);
+}
+
+/**
+ * @brief Board::resetStatistics drops statistics collected by selected histogram plot.
+ */
+void Board::resetStatistics()
+{
+    HistogramPlot* histogramPlot = dynamic_cast<HistogramPlot*>(ui.plotCanvas->getPlot(ui.plotNamesColumn->currentIndex().row()));
+    if(histogramPlot != NULL)
+    {
+        histogramPlot->reset();
+        ui.plotCanvas->update();
+    }
+}
+
+/**
+ * Asks for bit period and appends eye diagram of selected plot to list of plots.
+ * Eye diagram is updated whenever capture appends new data.
+ * @brief Board::addEyePlot
+ */
+void Board::addEyePlot()
+{
+    Plot* source = ui.plotCanvas->getPlot(ui.plotNamesColumn->currentIndex().row());
+    bool ok;
+    double period = QInputDialog::getDouble(this, "Eye diagram", "Bit period in ns (0 recovers it from data):", 0, 0, 1e9, 3, &ok);
+    if(not ok)
+        return;
+    EyeDiagram* eye = new EyeDiagram(source->getData(), period*E3);
+    EyePlot* eyePlot = new EyePlot(eye, "Eye "+source->getName());
+    connect(&controller, SIGNAL(dataAppended()), eye, SLOT(update()));
+    connect(eye, SIGNAL(eyeUpdated()), ui.plotCanvas, SLOT(update()));
+    ui.plotNamesColumn->addItem(eyePlot->getName());
+    ui.plotCanvas->addPlot(eyePlot);
+    eye->update();
+}
+
+/**
+ * @brief Board::resetEyeDiagram clears density of selected eye diagram, it is refolded from all data.
+ */
+void Board::resetEyeDiagram()
+{
+    EyePlot* eyePlot = dynamic_cast<EyePlot*>(ui.plotCanvas->getPlot(ui.plotNamesColumn->currentIndex().row()));
+    if(eyePlot != NULL)
+    {
+        eyePlot->getEyeDiagram()->reset();
+        eyePlot->getEyeDiagram()->update();
+        ui.plotCanvas->update();
+    }
+}
+
+/**
+ * Presents MaskDialog creating mask test from visible part of selected plot.
+ * Following captured blocks of that plot are tested against it.
+ * @brief Board::createMask
+ */
+void Board::createMask()
+{
+    PlotData* data = ui.plotCanvas->getPlot(ui.plotNamesColumn->currentIndex().row())->getData();
+    uint64_t div = data->getDiv();
+    if(div == 0)
+        return;
+    size_t from = ui.plotCanvas->getFrom()/div;
+    size_t length = ui.plotCanvas->getScale()*getDivCount()/div;
+    MaskDialog maskDialog(this);
+    if(maskDialog.setupMask(controller.getMaskTest(), data, from, length))
+        setStatusBarText("Mask of "+QString::number(controller.getMaskTest()->getLength())+" samples created");
+}
+
+/**
+ * @brief Board::disableMask stops testing captured blocks against mask.
+ */
+void Board::disableMask()
+{
+    controller.getMaskTest()->setEnabled(false);
+    setStatusBarText("Mask test disabled");
+}
+
+/**
+ * @brief Board::resetMask resets pass and fail counters and forgets failed blocks.
+ */
+void Board::resetMask()
+{
+    controller.getMaskTest()->reset();
+    showMaskResults(0, 0);
+}
+
+/**
+ * @brief Board::showMaskResults shows counters of mask test in status bar.
+ * @param passed
+ * @param failed
+ */
+void Board::showMaskResults(uint64_t passed, uint64_t failed)
+{
+    setStatusBarText("Mask test: "+QString::number(passed)+" passed, "+QString::number(failed)+" failed");
+}
+
+/**
+ * Lists saved failed blocks of mask test, view is moved to first violation of chosen block
+ * if data weren't rewritten since.
+ * @brief Board::showMaskFailures
+ */
+void Board::showMaskFailures()
+{
+    MaskTest* maskTest = controller.getMaskTest();
+    const QVector<MaskTest::Failure> & failures = maskTest->getFailures();
+    if(failures.isEmpty())
+    {
+        setStatusBarText("No failed blocks");
+        return;
+    }
+    uint64_t div = maskTest->getData()->getDiv();
+    QStringList items;
+    for(int i = 0; i < failures.size(); ++i)
+    {
+        items << "Block "+QString::number(failures.at(i).block)+": violation at "
+                 +QString::number(failures.at(i).violation*div/static_cast<double>(E3), 'f', 3)+" "+NS;
+    }
+    bool ok;
+    QString item = QInputDialog::getItem(this, "Failed blocks", "Blocks which failed mask test:", items, 0, false, &ok);
+    if(not ok)
+        return;
+    const MaskTest::Failure & failure = failures.at(items.indexOf(item));
+    if(failure.start+maskTest->getLength() > maskTest->getData()->lastPositionOnBit(0))
+    {
+        setStatusBarText("Failed block was overwritten");
+        return;
+    }
+    uint64_t time = failure.violation*div;
+    uint64_t offset = ui.plotCanvas->getScale()*getDivCount()/4;
+    setFrom(time > offset ? time-offset : 0);
+}
+
+/**
+ * @brief Board::getSelectedAnalyzer
+ * @return returns analyzer of selected plot or NULL if selected plot is not spectrum.
+ */
+SpectrumAnalyzer* Board::getSelectedAnalyzer()
+{
+    SpectrumPlot* spectrumPlot = dynamic_cast<SpectrumPlot*>(ui.plotCanvas->getPlot(ui.plotNamesColumn->currentIndex().row()));
+    if(spectrumPlot == NULL)
+        return NULL;
+    return spectrumPlot->getAnalyzer();
 }
 
 /**
- * This helper function sets interpolation on selected plot.
- * @brief Board::setInterpolateOnPlot
+ * @brief Board::setSpectrumWindow sets window function chosen in context menu on selected spectrum.
+ * @param action chosen action, holding window type in it's data.
  */
-void Board::setInterpolateOnPlot()
+void Board::setSpectrumWindow(QAction* action)
 {
-    ui.plotCanvas->toggleInterpolate(ui.plotNamesColumn->currentIndex().row());
+    SpectrumAnalyzer* analyzer = getSelectedAnalyzer();
+    if(analyzer != NULL)
+        analyzer->setWindow(action->data().toInt());
+}
+
+/**
+ * @brief Board::setSpectrumAveraging sets averaging chosen in context menu on selected spectrum.
+ * @param action chosen action, holding averaging mode in it's data.
+ */
+void Board::setSpectrumAveraging(QAction* action)
+{
+    SpectrumAnalyzer* analyzer = getSelectedAnalyzer();
+    if(analyzer != NULL)
+        analyzer->setAveraging(action->data().toInt());
+}
+
+/**
+ * @brief Board::setSpectrumLength sets FFT length chosen in context menu on selected spectrum.
+ * @param action chosen action, holding length in it's data.
+ */
+void Board::setSpectrumLength(QAction* action)
+{
+    SpectrumAnalyzer* analyzer = getSelectedAnalyzer();
+    if(analyzer != NULL)
+        analyzer->setLength(action->data().toInt());
 }
 
 /**
@@ -183,6 +688,9 @@ void Board::addMeasurementPlot()
 {
     if(controller.hasDevice())
     {
+        // probe can replace data of plot
+        clearSearch();
+        clearComparison();
         ProbeAssignDialog probeAssignDialog(this);
         probeAssignDialog.assignDialog(&controller, this);
         refreshPlotNames();
@@ -214,7 +722,7 @@ void Board::changePageNames(QListWidgetItem * current, QListWidgetItem * previou
     int currentWidget = ui.plotNamesColumn->row(current);
     if(controller.hasDevice() and currentWidget != -1)
     {
-        ui.scopeKnobs->setCurrentDevice(controller.getDeviceByPlot(ui.plotCanvas->getPlot(ui.plotNamesColumn->row(current))));
+        ui.scopeKnobs->setCurrentDevice(controller.getDeviceByData(ui.plotCanvas->getPlot(ui.plotNamesColumn->row(current))->getData()));
         ui.scopeKnobs->setCurrentPlot(ui.plotCanvas->getPlot(ui.plotNamesColumn->row(current)));
     }
     //plotNamesColumn->setCurrentRow(currentWidget); //probably unnecessary
@@ -222,23 +730,49 @@ void Board::changePageNames(QListWidgetItem * current, QListWidgetItem * previou
 }
 
 /**
- * Refreshes list of plot nasmes in list of plots.
+ * Refreshes list of plot nasmes in list of plots. Plots already showing data of selected
+ * scope in same order are kept, so only changed end of list is rebuilt.
  * @brief Board::refreshPlotNames
  */
 void Board::refreshPlotNames()
 {
     QModelIndex idxs = ui.plotNamesColumn->currentIndex();
-    ui.plotNamesColumn->clear();
-    ui.plotCanvas->clear();
-    PlotTreeItem * treeItem = static_cast<PlotTreeItem*>(ui.treeWidget->selectedItem());
+    PlotTreeItem * treeItem = ui.treeWidget->selectedItem();
     if(treeItem == NULL)
+    {
+        ui.plotNamesColumn->clear();
+        ui.plotCanvas->clear();
         return;
-    for(int i = 0; i < treeItem->plotData().size(); ++i)
+    }
+    QVector<PlotData*> data = treeItem->plotData();
+    int kept = 0;
+    while(kept < data.size() and kept < ui.plotCanvas->getPlotCount()
+          and ui.plotCanvas->getPlot(kept)->getData() == data.at(kept))
     {
-        //qDebug() << treeItem->plotData().at(i)->getName();
-        ui.plotNamesColumn->addItem(treeItem->plotData().at(i)->getName()+" ["+QString::number(treeItem->plotData().at(i)->getBitwidth())+"]");
-        ui.plotCanvas->addPlot(new Plot(treeItem->plotData().at(i), treeItem->plotData().at(i)->getName()));
+        ++kept;
     }
+    if(kept == 0)
+    {
+        ui.plotNamesColumn->clear();
+        ui.plotCanvas->clear();
+    }
+    else
+    {
+        while(ui.plotNamesColumn->count() > kept)
+        {
+            delete(ui.plotNamesColumn->takeItem(ui.plotNamesColumn->count()-1));
+        }
+        ui.plotCanvas->removePlots(kept);
+    }
+    QStringList names;
+    QVector<Plot*> newPlots;
+    for(int i = kept; i < data.size(); ++i)
+    {
+        names.append(data.at(i)->getName()+" ["+QString::number(data.at(i)->getBitwidth())+"]");
+        newPlots.push_back(new Plot(data.at(i), data.at(i)->getName()));
+    }
+    ui.plotNamesColumn->addItems(names);
+    ui.plotCanvas->addPlots(newPlots);
     ui.plotCanvas->zoomOut();
     ui.plotCanvas->zoomIn();
     treeModel->setCurrentTop(treeItem);
@@ -250,22 +784,78 @@ void Board::refreshPlotNames()
 }
 
 /**
- * Loat plot hierarchy from VCD file.
+ * Starts loading plot hierarchy from VCD file in background. Hierarchy is shown once header is read,
+ * signals fill in as values are read.
  * @brief Board::loadFromFile
- * @param file file to load VCD from.
+ * @param fileName file to load VCD from.
+ */
+void Board::loadFromFile(const QString & fileName)
+{
+    clearSearch();
+    clearComparison();
+    loadJob = new LoadJob(treeModel, fileName);
+    connect(loadJob, SIGNAL(hierarchyLoaded()), this, SLOT(refreshPlotNames()));
+    connect(loadJob, SIGNAL(progress(qint64, qint64, int, int)), this, SLOT(showLoadProgress(qint64, qint64, int, int)));
+    connect(loadJob, SIGNAL(loaded()), this, SLOT(loadFinished()));
+    connect(loadJob, SIGNAL(failed(QString)), this, SLOT(loadFailed(QString)));
+    loadDialog = new ProgressBarDialog("Loading "+name, this);
+    connect(loadDialog, SIGNAL(cancelled()), loadJob, SLOT(cancel()));
+    loadDialog->show();
+    setStatusBarText("Loading measurement/simulation "+name+"..");
+    loadJob->start();
+}
+
+/**
+ * @brief Board::showLoadProgress shows values applied so far.
  */
-void Board::loadFromFile(QFile * file)
+void Board::showLoadProgress(qint64 bytesRead, qint64 fileSize, int signalsWithData, int signalCount)
 {
-    if(!file->open(QIODevice::ReadOnly |
-                   QIODevice::Text))
+    loadDialog->setProgress(bytesRead, fileSize);
+    loadDialog->setText("Loading "+name+": "+QString::number(signalsWithData)+" of "
+                        +QString::number(signalCount)+" signals have data");
+    MemoryManager::instance().enforce();
+    updateFromTo();
+    ui.plotCanvas->update();
+}
+
+/**
+ * @brief Board::endLoading closes progress dialog and releases finished load job.
+ * @return returns true if loading was cancelled.
+ */
+bool Board::endLoading()
+{
+    bool cancelled = loadJob->isCancelled();
+    loadJob->deleteLater();
+    loadJob = NULL;
+    loadDialog->close();
+    loadDialog->deleteLater();
+    loadDialog = NULL;
+    refreshPlotNames();
+    updateFromTo();
+    MemoryManager::instance().enforce();
+    return cancelled;
+}
+
+void Board::loadFinished()
+{
+    if(endLoading())
+        setStatusBarText("Loading of measurement/simulation "+name+" cancelled, values read so far are shown.");
+    else
+        setStatusBarText("Measurement/simulation "+name+" opened sucessfully.");
+}
+
+void Board::loadFailed(QString message)
+{
+    bool empty = not loadJob->isHeaderTaken();
+    endLoading();
+    QMessageBox::critical(this, "File error", message);
+    if(empty)
     {
-        QFileInfo fi(file->fileName());
-        throw IOException("Could not open file: "+fi.fileName());
+        setStatusBarText("Measurement/simulation "+name+" could not be opened.");
+        emit closeRequested(this); // tab without any signal is not kept
     }
-    
-    FileSplitter splitter = FileSplitter(file);
-    treeModel->loadFromFile(splitter);
-    refreshPlotNames();
+    else
+        setStatusBarText("Measurement/simulation "+name+" could not be read whole, values read so far are shown.");
 }
 
 /**
@@ -282,9 +872,287 @@ void Board::saveToFile(QFile *file)
     }
     //treeModel->setTimeScale()
     treeModel->setComment(file->fileName());
+    QReadLocker locker(MemoryManager::instance().getAccessLock());
     treeModel->saveToFile(file);
 }
 
+/**
+ * Asks for pattern and searches selected logic plot for it, view is moved to first match.
+ * @brief Board::findPattern
+ */
+void Board::findPattern()
+{
+    int row = ui.plotNamesColumn->currentIndex().row();
+    if(row < 0 or ui.plotCanvas->getPlot(row)->getData() == NULL or ui.plotCanvas->isAnalog(row)
+       or not ui.plotCanvas->getPlot(row)->isTimeBased())
+    {
+        QMessageBox::warning(this, "No logic plot", "Select logic plot to search in.");
+        return;
+    }
+    bool ok;
+    QString text = QInputDialog::getText(this, "Find pattern",
+                                         "Pattern from highest bit (0, 1, X, R rising, F falling, E any edge):",
+                                         QLineEdit::Normal, patternSearch.getPattern(), &ok);
+    if(not ok)
+        return;
+    if(not patternSearch.setPattern(text))
+    {
+        QMessageBox::warning(this, "Data error", "Failed to parse pattern, use string of 0, 1, X, R, F and E.");
+        return;
+    }
+    patternSearch.search(ui.plotCanvas->getPlot(row)->getData());
+    setStatusBarText(QString::number(patternSearch.getHits().size())+" matches");
+    if(not patternSearch.getHits().isEmpty())
+        showSearchHit(patternSearch.getHits().first());
+}
+
+/**
+ * @brief Board::getSearchPosition
+ * @return returns sample from which next and previous match are searched, last shown match
+ * if view wasn't moved since, otherwise sample at position where matches are shown.
+ */
+size_t Board::getSearchPosition()
+{
+    uint64_t from = ui.plotCanvas->getFrom();
+    if(from == searchFrom)
+        return searchHit;
+    uint64_t div = patternSearch.getData()->getDiv();
+    return div == 0 ? 0 : (from+ui.plotCanvas->getScale()*getDivCount()/4)/div;
+}
+
+/**
+ * @brief Board::showSearchHit moves view so that match is in first quarter of it.
+ * @param hit
+ */
+void Board::showSearchHit(size_t hit)
+{
+    uint64_t time = hit*patternSearch.getData()->getDiv();
+    uint64_t offset = ui.plotCanvas->getScale()*getDivCount()/4;
+    setFrom(time > offset ? time-offset : 0);
+    searchFrom = ui.plotCanvas->getFrom();
+    searchHit = hit;
+}
+
+/**
+ * @brief Board::clearSearch forgets matches of last search, call before searched data is replaced or removed.
+ */
+void Board::clearSearch()
+{
+    patternSearch.clear();
+    searchFrom = UINT64_MAX;
+}
+
+/**
+ * Moves view to next match of last search.
+ * @brief Board::findNext
+ */
+void Board::findNext()
+{
+    size_t hit;
+    if(patternSearch.getData() == NULL)
+        return;
+    if(patternSearch.findNext(getSearchPosition(), hit))
+        showSearchHit(hit);
+    else
+        setStatusBarText("No next match");
+}
+
+/**
+ * Moves view to previous match of last search.
+ * @brief Board::findPrevious
+ */
+void Board::findPrevious()
+{
+    size_t hit;
+    if(patternSearch.getData() == NULL)
+        return;
+    if(patternSearch.findPrevious(getSearchPosition(), hit))
+        showSearchHit(hit);
+    else
+        setStatusBarText("No previous match");
+}
+
+/**
+ * @brief Board::getTriggerTime
+ * @param time time of last software trigger in ps.
+ * @return returns false if capture wasn't triggered by software trigger.
+ */
+bool Board::getTriggerTime(uint64_t & time)
+{
+    QMap<QString, PlotData*> dataByPath;
+    collectData(dataByPath);
+    if(not controller.getSoftwareTrigger()->isEnabled() or dataByPath.isEmpty())
+        return false;
+    time = controller.getSoftwareTrigger()->getTriggerPosition()*dataByPath.begin().value()->getDiv();
+    return true;
+}
+
+/**
+ * Presents CompareDialog and compares all signals of this board with chosen reference board.
+ * Differences are highlighted in plot canvas.
+ * @brief Board::compare
+ * @param captures names of other boards.
+ * @param boards other boards which can be used as reference.
+ */
+void Board::compare(QStringList captures, QVector<Board*> boards)
+{
+    CompareDialog compareDialog(this);
+    if(not compareDialog.choose(captures, ui.plotCanvas->getPlots()))
+        return;
+    Board* reference = boards.at(compareDialog.getReference());
+    QMap<QString, PlotData*> referenceData;
+    QMap<QString, PlotData*> comparedData;
+    reference->collectData(referenceData);
+    collectData(comparedData);
+    int64_t offset = 0;
+    if(compareDialog.getAlignment() == CompareDialog::TriggerAlignment)
+    {
+        uint64_t referenceTime;
+        uint64_t comparedTime;
+        if(not reference->getTriggerTime(referenceTime) or not getTriggerTime(comparedTime))
+        {
+            QMessageBox::warning(this, "No trigger", "Both captures have to be captured with software trigger.");
+            return;
+        }
+        offset = static_cast<int64_t>(referenceTime)-static_cast<int64_t>(comparedTime);
+    }
+    else if(compareDialog.getAlignment() == CompareDialog::PatternAlignment)
+    {
+        PlotData* compared = compareDialog.getPatternData();
+        PlotData* referenceSignal = NULL;
+        QString path = compared != NULL ? comparedData.key(compared) : QString();
+        if(referenceData.contains(path))
+            referenceSignal = referenceData.value(path);
+        for(QMap<QString, PlotData*>::const_iterator it = referenceData.constBegin(); referenceSignal == NULL and compared != NULL and it != referenceData.constEnd(); ++it)
+        {
+            if(it.value()->getName() == compared->getName())
+                referenceSignal = it.value();
+        }
+        uint64_t referenceTime;
+        uint64_t comparedTime;
+        if(referenceSignal == NULL or not CaptureComparator::findPatternTime(referenceSignal, compareDialog.getPattern(), referenceTime)
+           or not CaptureComparator::findPatternTime(compared, compareDialog.getPattern(), comparedTime))
+        {
+            QMessageBox::warning(this, "No match", "Pattern wasn't found in selected signal of both captures.");
+            return;
+        }
+        offset = static_cast<int64_t>(referenceTime)-static_cast<int64_t>(comparedTime);
+    }
+    comparator.compare(referenceData, comparedData, offset);
+    ui.plotCanvas->setComparator(&comparator);
+    int different = 0;
+    for(int i = 0; i < comparator.getComparisons().size(); ++i)
+    {
+        if(not comparator.getComparisons().at(i).ranges.isEmpty())
+            ++different;
+    }
+    setStatusBarText(QString::number(comparator.getDifferenceCount())+" differences in "+QString::number(different)+" of "
+                     +QString::number(comparator.getComparisons().size())+" signals, "
+                     +QString::number(comparator.getUnmatched().size())+" signals without pair");
+    differenceFrom = UINT64_MAX;
+    uint64_t time;
+    int comparison;
+    if(comparator.findPrevious(1, time, comparison) or comparator.findNext(0, time, comparison))
+        showDifference(time, comparison); // first difference
+}
+
+/**
+ * @brief Board::clearComparison forgets differences of last comparison, call before compared
+ * data of this or reference board are replaced or removed.
+ */
+void Board::clearComparison()
+{
+    comparator.clear();
+    ui.plotCanvas->setComparator(NULL);
+    differenceFrom = UINT64_MAX;
+}
+
+/**
+ * @brief Board::getDifferencePosition
+ * @return returns time from which next and previous difference are searched, last shown difference
+ * if view wasn't moved since, otherwise time at position where differences are shown.
+ */
+uint64_t Board::getDifferencePosition()
+{
+    uint64_t from = ui.plotCanvas->getFrom();
+    if(from == differenceFrom)
+        return differenceTime;
+    return from+ui.plotCanvas->getScale()*getDivCount()/4;
+}
+
+/**
+ * @brief Board::showDifference moves view so that difference is in first quarter of it.
+ * @param time
+ * @param comparison index of comparison with difference, it's path is shown in status bar.
+ */
+void Board::showDifference(uint64_t time, int comparison)
+{
+    uint64_t offset = ui.plotCanvas->getScale()*getDivCount()/4;
+    setFrom(time > offset ? time-offset : 0);
+    differenceFrom = ui.plotCanvas->getFrom();
+    differenceTime = time;
+    setStatusBarText("Difference in "+comparator.getComparisons().at(comparison).path);
+}
+
+/**
+ * Moves view to next difference of last comparison.
+ * @brief Board::findNextDifference
+ */
+void Board::findNextDifference()
+{
+    uint64_t time;
+    int comparison;
+    if(comparator.findNext(getDifferencePosition(), time, comparison))
+        showDifference(time, comparison);
+    else
+        setStatusBarText("No next difference");
+}
+
+/**
+ * Moves view to previous difference of last comparison.
+ * @brief Board::findPreviousDifference
+ */
+void Board::findPreviousDifference()
+{
+    uint64_t time;
+    int comparison;
+    if(comparator.findPrevious(getDifferencePosition(), time, comparison))
+        showDifference(time, comparison);
+    else
+        setStatusBarText("No previous difference");
+}
+
+/**
+ * Lists signals which differ in last comparison, view is moved to first difference of chosen signal.
+ * @brief Board::listDifferences
+ */
+void Board::listDifferences()
+{
+    QStringList items;
+    QVector<int> indexes;
+    const QVector<CaptureComparator::SignalComparison> & comparisons = comparator.getComparisons();
+    for(int i = 0; i < comparisons.size(); ++i)
+    {
+        if(comparisons.at(i).ranges.isEmpty())
+            continue;
+        items << comparisons.at(i).path+": "+QString::number(comparisons.at(i).ranges.size())
+                 +(comparisons.at(i).truncated ? "+" : "")+" ranges, "
+                 +QString::number(comparisons.at(i).differentSamples)+" samples";
+        indexes.append(i);
+    }
+    if(items.isEmpty())
+    {
+        setStatusBarText(comparisons.isEmpty() ? "No comparison" : "Captures don't differ");
+        return;
+    }
+    bool ok;
+    QString item = QInputDialog::getItem(this, "Differences", "Signals which differ from reference:", items, 0, false, &ok);
+    if(not ok)
+        return;
+    int comparison = indexes.at(items.indexOf(item));
+    showDifference(comparisons.at(comparison).ranges.first().first*comparisons.at(comparison).compared->getDiv(), comparison);
+}
+
 /**
  * Set starting time of viewport.
  * @brief Board::setFrom
@@ -360,7 +1228,16 @@ void Board::updateFromTo()
  */
 void Board::startCapture(bool continous)
 {
-    this->controller.startCapture(continous, ui.plotCanvas->getPlots());
+    QVector<PlotData*> data;
+    QVector<Plot*> plots = ui.plotCanvas->getPlots();
+    for(int i = 0; i < plots.count(); ++i)
+    {
+        data.append(plots[i]->getData());
+    }
+    // matches and differences of previous capture are no longer valid
+    clearSearch();
+    clearComparison();
+    this->controller.startCapture(continous, data);
 }
 
 /**
@@ -46,6 +46,11 @@
 #include "../Datamodel/PlotTreeModel.h"
 #include <ui_Board.h>
 #include "../Device/CaptureController.h"
+#include "../Datamodel/SpectrumAnalyzer.h"
+#include "../Datamodel/CaptureComparator.h"
+#include "../Datamodel/PatternSearch.h"
+#include "../Datamodel/LoadJob.h"
+#include "ProgressBarDialog.h"
 
 /**
  * This class represents "tab" of applications and provides wrapper for all underlying graphics widgets.
@@ -59,15 +64,51 @@ private:
     Ui::Board ui;
     QString name;
     PlotTreeModel * treeModel;
+    LoadJob * loadJob;
+    ProgressBarDialog * loadDialog;
+    bool endLoading();
     CaptureController controller;
-    char randomSign;
     ulong scrollbarDivision;
+    SpectrumAnalyzer* getSelectedAnalyzer();
+    PatternSearch patternSearch;
+    uint64_t searchFrom;
+    size_t searchHit;
+    size_t getSearchPosition();
+    void showSearchHit(size_t hit);
+    CaptureComparator comparator;
+    uint64_t differenceFrom;
+    uint64_t differenceTime;
+    uint64_t getDifferencePosition();
+    void showDifference(uint64_t time, int comparison);
+    bool getTriggerTime(uint64_t & time);
+    void addView(PlotData * source, PlotData * view);
 private slots:
     void changePageNames(QListWidgetItem* current, QListWidgetItem* previous);
     void plotClickAction(const QModelIndex & index);
     void showPlotContextMenu(QPoint p);
-    void setInterpolateOnPlot();
+    void setInterpolationOnPlot(QAction* action);
     void openTriggerDialog();
+    void openSoftwareTriggerDialog();
+    void addSpectrumPlot();
+    void addDecoderPlot();
+    void addMathPlot();
+    void addBitsView();
+    void addRangeView();
+    void addStatisticsPlot(QAction* action);
+    void resetStatistics();
+    void addEyePlot();
+    void resetEyeDiagram();
+    void createMask();
+    void disableMask();
+    void resetMask();
+    void showMaskFailures();
+    void showMaskResults(uint64_t passed, uint64_t failed);
+    void setSpectrumWindow(QAction* action);
+    void setSpectrumAveraging(QAction* action);
+    void setSpectrumLength(QAction* action);
+    void showLoadProgress(qint64 bytesRead, qint64 fileSize, int signalsWithData, int signalCount);
+    void loadFinished();
+    void loadFailed(QString message);
 public slots:
     void refreshPlotNames();
     void updateFromScroll(int val) { ui.plotCanvas->setFrom(val*scrollbarDivision); }
@@ -81,23 +122,35 @@ public:
     void connectDevice();
     void startCapture(bool contionous);
     void stopCapture() { controller.stopCapture(); }
-    AbstractDevice* getCurrentDevice() { return controller.getDeviceByPlot(ui.plotCanvas->getPlot(ui.plotNamesColumn->currentIndex().row())); }
-    int getCurrentDataId() { return controller.getDataIdByPlot(ui.plotCanvas->getPlot(ui.plotNamesColumn->currentIndex().row())); }
+    AbstractDevice* getCurrentDevice() { return controller.getDeviceByData(ui.plotCanvas->getPlot(ui.plotNamesColumn->currentIndex().row())->getData()); }
+    int getCurrentDataId() { return controller.getDataIdByData(ui.plotCanvas->getPlot(ui.plotNamesColumn->currentIndex().row())->getData()); }
     Plot* createMeasurementPlot(int type);
-    char getRandomSign() { return randomSign++; }
+    char getFreeSign() { return treeModel->getFreeSign(); }
     void setStatusBarText(QString text) { emit updateStatusBar(text); }
     void connectWindow(QObject * window);
     void addMeasurementPlot();
     void removeMeasurementPlot();
+    void findPattern();
+    void findNext();
+    void findPrevious();
+    void compare(QStringList captures, QVector<Board*> boards);
+    void findNextDifference();
+    void findPreviousDifference();
+    void listDifferences();
+    void clearSearch();
+    void clearComparison();
+    void collectData(QMap<QString, PlotData*> & dataByPath) { treeModel->collectData(dataByPath); }
     int getDivCount() { return ui.plotCanvas->getDivCount(); }
     PlotCanvas* getPlotCanvas() { return ui.plotCanvas; }
     uint64_t getScale() { return ui.plotCanvas->getScale(); }
-    void loadFromFile(QFile* file);
+    void loadFromFile(const QString & fileName);
+    bool isLoading() { return loadJob != NULL; }
     void saveToFile(QFile* file);
     Board(QString & name, QWidget * parent = 0);
     ~Board();
 signals:
     void updateStatusBar(QString);
+    void closeRequested(Board *);
 };
 
 #endif
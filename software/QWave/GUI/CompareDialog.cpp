@@ -0,0 +1,110 @@
+//
+//   CompareDialog.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "CompareDialog.h"
+#include "ui_CompareDialog.h"
+#include <QMessageBox>
+
+CompareDialog::CompareDialog(QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::CompareDialog)
+{
+    ui->setupUi(this);
+    connect(ui->alignmentCombo, SIGNAL(currentIndexChanged(int)), this, SLOT(alignmentChanged(int)));
+}
+
+CompareDialog::~CompareDialog()
+{
+    delete ui;
+}
+
+/**
+ * @brief CompareDialog::alignmentChanged enables pattern inputs only when captures are aligned by pattern.
+ * @param alignment
+ */
+void CompareDialog::alignmentChanged(int alignment)
+{
+    ui->signalCombo->setEnabled(alignment == PatternAlignment);
+    ui->patternEdit->setEnabled(alignment == PatternAlignment);
+}
+
+/**
+ * @brief CompareDialog::choose this function presents dialog.
+ * @param captures names of captures which can be used as reference.
+ * @param plots plots of board, logic ones are offered for pattern alignment.
+ * @return returns true if user clicked OK.
+ */
+bool CompareDialog::choose(QStringList captures, QVector<Plot*> plots)
+{
+    if(captures.isEmpty())
+    {
+        QMessageBox::warning(this, "No reference", "Open another capture to compare with.");
+        return false;
+    }
+    ui->referenceCombo->addItems(captures);
+    for(int i = 0; i < plots.count(); ++i)
+    {
+        PlotData* data = plots.at(i)->getData();
+        if(not plots.at(i)->isTimeBased() or data == NULL or data->getType() != PlotData::Logic)
+            continue;
+        patternData.append(data);
+        ui->signalCombo->addItem(plots.at(i)->getName());
+    }
+    alignmentChanged(ui->alignmentCombo->currentIndex());
+    return this->exec() == QDialog::Accepted;
+}
+
+int CompareDialog::getReference()
+{
+    return ui->referenceCombo->currentIndex();
+}
+
+int CompareDialog::getAlignment()
+{
+    return ui->alignmentCombo->currentIndex();
+}
+
+/**
+ * @brief CompareDialog::getPatternData
+ * @return returns data of signal searched for pattern or NULL if there is none.
+ */
+PlotData* CompareDialog::getPatternData()
+{
+    int index = ui->signalCombo->currentIndex();
+    if(index < 0 or index >= patternData.size())
+        return NULL;
+    return patternData.at(index);
+}
+
+QString CompareDialog::getPattern()
+{
+    return ui->patternEdit->text();
+}
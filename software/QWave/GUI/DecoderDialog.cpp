@@ -0,0 +1,147 @@
+//
+//   DecoderDialog.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "DecoderDialog.h"
+#include "ui_DecoderDialog.h"
+#include "../Decoders/UartDecoder.h"
+#include "../Decoders/SpiDecoder.h"
+#include "../Decoders/I2cDecoder.h"
+#include <QMessageBox>
+
+DecoderDialog::DecoderDialog(QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::DecoderDialog)
+{
+    ui->setupUi(this);
+    connect(ui->protocolCombo, SIGNAL(currentIndexChanged(int)), this, SLOT(protocolChanged(int)));
+}
+
+DecoderDialog::~DecoderDialog()
+{
+    delete ui;
+}
+
+/**
+ * @brief DecoderDialog::protocolChanged names channels of selected protocol and enables only used inputs.
+ * @param protocol
+ */
+void DecoderDialog::protocolChanged(int protocol)
+{
+    const char* names[][4] = { { "RX:", "", "", "" },
+                               { "Clock:", "MOSI:", "MISO:", "Chip select:" },
+                               { "SCL:", "SDA:", "", "" } };
+    QLabel* labels[] = { ui->channel1Label, ui->channel2Label, ui->channel3Label, ui->channel4Label };
+    QComboBox* combos[] = { ui->channel1Combo, ui->channel2Combo, ui->channel3Combo, ui->channel4Combo };
+    for(int i = 0; i < 4; ++i)
+    {
+        bool used = names[protocol][i][0] != '\0';
+        labels[i]->setText(used ? names[protocol][i] : "Unused:");
+        combos[i]->setEnabled(used);
+    }
+    ui->baudRateSpinBox->setEnabled(protocol == Uart);
+    ui->dataBitsSpinBox->setEnabled(protocol != I2c);
+    ui->parityCombo->setEnabled(protocol == Uart);
+    ui->stopBitsSpinBox->setEnabled(protocol == Uart);
+    ui->modeCombo->setEnabled(protocol == Spi);
+    ui->bitOrderCombo->setEnabled(protocol == Spi);
+}
+
+/**
+ * @brief DecoderDialog::getChannel
+ * @param index selected index of channel combo.
+ * @param optional optional channel combos start with "None".
+ * @return returns selected channel.
+ */
+DecoderChannel DecoderDialog::getChannel(int index, bool optional)
+{
+    if(optional)
+        --index;
+    if(index < 0 or index >= channels.size())
+        return DecoderChannel();
+    return channels.at(index);
+}
+
+/**
+ * @brief DecoderDialog::createDecoder this function presents dialog and when user
+ * clicks OK it creates selected decoder.
+ * @param plots plots of board, their logic bits are offered as decoder channels.
+ * @return returns new decoder owned by caller or NULL if dialog was canceled.
+ */
+Decoder* DecoderDialog::createDecoder(QVector<Plot*> plots)
+{
+    QStringList names;
+    for(int i = 0; i < plots.count(); ++i)
+    {
+        PlotData* data = plots.at(i)->getData();
+        if(not plots.at(i)->isTimeBased() or data == NULL or data->getType() != PlotData::Logic)
+            continue;
+        for(int bit = 0; bit < data->getBitwidth(); ++bit)
+        {
+            channels.append(DecoderChannel(data, bit));
+            if(data->getBitwidth() == 1)
+                names << plots.at(i)->getName();
+            else // data keep highest bit first, bits are labeled from lowest as everywhere else
+                names << plots.at(i)->getName()+"["+QString::number(data->getBitwidth()-1-bit)+"]";
+        }
+    }
+    if(channels.isEmpty())
+    {
+        QMessageBox::warning(this, "No data", "There are no logic signals to decode.");
+        return NULL;
+    }
+    ui->channel1Combo->addItems(names);
+    ui->channel2Combo->addItems(names);
+    ui->channel3Combo->addItem("None");
+    ui->channel3Combo->addItems(names);
+    ui->channel4Combo->addItem("None");
+    ui->channel4Combo->addItems(names);
+    ui->channel2Combo->setCurrentIndex(qMin(1, names.count()-1));
+    protocolChanged(ui->protocolCombo->currentIndex());
+
+    int result = this->exec();
+    if(result != QDialog::Accepted)
+        return NULL;
+    DecoderChannel first = getChannel(ui->channel1Combo->currentIndex(), false);
+    DecoderChannel second = getChannel(ui->channel2Combo->currentIndex(), false);
+    switch(ui->protocolCombo->currentIndex())
+    {
+    case Uart:
+        return new UartDecoder(first, ui->baudRateSpinBox->value(), ui->dataBitsSpinBox->value(),
+                               ui->parityCombo->currentIndex(), ui->stopBitsSpinBox->value());
+    case Spi:
+        return new SpiDecoder(first, second, getChannel(ui->channel3Combo->currentIndex(), true),
+                              getChannel(ui->channel4Combo->currentIndex(), true), ui->modeCombo->currentIndex(),
+                              ui->dataBitsSpinBox->value(), ui->bitOrderCombo->currentIndex() == 0);
+    case I2c:
+        return new I2cDecoder(first, second);
+    }
+    return NULL;
+}
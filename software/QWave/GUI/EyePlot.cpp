@@ -0,0 +1,114 @@
+//
+//   EyePlot.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <QPainter>
+#include <math.h>
+#include "EyePlot.h"
+#include "../Datamodel/Constants.h"
+
+/**
+ * @brief EyePlot::EyePlot
+ * @param eye eye diagram owned by this plot, it's source data are used as plot data.
+ * @param name
+ */
+EyePlot::EyePlot(EyeDiagram * eye, QString name) :
+    Plot(eye->getSource(), name), eye(eye), paintedVersion(0),
+    image(EyeDiagram::COLUMNS, EyeDiagram::ROWS, QImage::Format_RGB32), palette(256)
+{
+    setHeight(EYE_HEIGHT);
+    for(int i = 0; i < palette.size(); ++i)
+    { // black through blue, green and yellow to red
+        double level = i/255.0;
+        int red = static_cast<int>(255*qBound(0.0, 2*level-1, 1.0));
+        int green = static_cast<int>(255*qBound(0.0, 1-fabs(2*level-1.2), 1.0));
+        int blue = static_cast<int>(255*qBound(0.0, 1.5-2.5*level, 1.0)*qMin(1.0, 8*level));
+        palette[i] = qRgb(red, green, blue);
+    }
+    palette[0] = qRgb(0, 0, 0);
+}
+
+EyePlot::~EyePlot()
+{
+    delete(eye);
+}
+
+/**
+ * @brief EyePlot::getTimeText
+ * @param time in ps.
+ * @return returns time formatted with appropriate unit.
+ */
+QString EyePlot::getTimeText(double time)
+{
+    if(time >= E9)
+        return QString::number(time/E9, 'f', 3)+" "+MS;
+    if(time >= E6)
+        return QString::number(time/E6, 'f', 3)+" "+US;
+    if(time >= E3)
+        return QString::number(time/E3, 'f', 3)+" "+NS;
+    return QString::number(time, 'f', 0)+" "+PS;
+}
+
+/**
+ * @brief EyePlot::paint converts density to image through palette and paints it scaled to plot,
+ * with unit interval markers and text with bit period and number of folded samples.
+ * @param painter
+ * @param startCoordY
+ * @param width
+ * @param fromTime not used, eye diagram is not time based.
+ * @param divSize not used.
+ */
+void EyePlot::paint(QPainter * painter, int startCoordY, int width, uint64_t fromTime, double divSize)
+{
+    Q_UNUSED(fromTime);
+    Q_UNUSED(divSize);
+    paintedVersion = eye->getVersion();
+    const QVector<quint32> & density = eye->getDensity();
+    double scale = eye->getMaximum() > 0 ? 255/log(1.0+eye->getMaximum()) : 0;
+    for(int row = 0; row < EyeDiagram::ROWS; ++row)
+    {
+        QRgb * line = reinterpret_cast<QRgb*>(image.scanLine(row));
+        const quint32 * cells = density.constData()+row*EyeDiagram::COLUMNS;
+        for(int column = 0; column < EyeDiagram::COLUMNS; ++column)
+        {
+            line[column] = palette.at(static_cast<int>(log(1.0+cells[column])*scale));
+        }
+    }
+    painter->drawImage(QRect(0, startCoordY, width, getHeight()), image);
+    painter->setPen(QColor(90, 90, 90));
+    for(int i = 1; i < 4; ++i)
+    {
+        painter->drawLine(i*width/4, startCoordY, i*width/4, startCoordY+getHeight());
+    }
+    painter->setPen(QColor(255, 255, 255));
+    QString text = eye->getUnitInterval() > 0 ? "UI: "+getTimeText(eye->getUnitInterval()) : QString("UI: recovering");
+    text += "  samples: "+QString::number(eye->getSampleCount());
+    painter->drawText(2, startCoordY, width-4, DATASTRING_HEIGHT, Qt::AlignLeft, text);
+}
@@ -0,0 +1,133 @@
+//
+//   HistogramPlot.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <QPainter>
+#include "HistogramPlot.h"
+#include "../Datamodel/Constants.h"
+
+/**
+ * @brief HistogramPlot::HistogramPlot
+ * @param collector collector holding statistics, channel is removed from it when plot is deleted.
+ * @param channelId
+ * @param name
+ */
+HistogramPlot::HistogramPlot(StatisticsCollector * collector, int channelId, QString name) :
+    Plot(collector->getChannel(channelId).data, name), collector(collector), channelId(channelId), paintedCount(0)
+{
+    setHeight(HISTOGRAM_HEIGHT);
+}
+
+HistogramPlot::~HistogramPlot()
+{
+    collector->removeChannel(channelId);
+}
+
+/**
+ * @brief HistogramPlot::reset drops statistics collected so far.
+ */
+void HistogramPlot::reset()
+{
+    collector->reset(channelId);
+}
+
+/**
+ * @brief HistogramPlot::getValueText
+ * @param value level or time in ps depending on collected quantity.
+ * @return returns value formatted with appropriate unit.
+ */
+QString HistogramPlot::getValueText(double value)
+{
+    if(collector->getChannel(channelId).quantity == StatisticsCollector::Level)
+        return QString::number(value, 'f', 2);
+    if(value >= E12)
+        return QString::number(value/E12, 'f', 3)+" "+S;
+    if(value >= E9)
+        return QString::number(value/E9, 'f', 3)+" "+MS;
+    if(value >= E6)
+        return QString::number(value/E6, 'f', 3)+" "+US;
+    if(value >= E3)
+        return QString::number(value/E3, 'f', 3)+" "+NS;
+    return QString::number(value, 'f', 0)+" "+PS;
+}
+
+/**
+ * @brief HistogramPlot::paint paints bars of histogram up to highest used bin scaled to width
+ * of canvas, and line with count, mean, standard deviation, minimum and maximum.
+ * @param painter
+ * @param startCoordY
+ * @param width
+ * @param fromTime not used, histogram is not time based.
+ * @param divSize not used.
+ */
+void HistogramPlot::paint(QPainter * painter, int startCoordY, int width, uint64_t fromTime, double divSize)
+{
+    Q_UNUSED(fromTime);
+    Q_UNUSED(divSize);
+    const StatisticsCollector::Channel & channel = collector->getChannel(channelId);
+    const RunningStatistics & statistics = channel.statistics;
+    const Histogram & histogram = channel.histogram;
+    paintedCount = statistics.count;
+    painter->setPen(QColor(255, 255, 255));
+    QString summary = StatisticsCollector::getQuantityName(channel.quantity)+"  n: "+QString::number(statistics.count);
+    if(statistics.count > 0)
+    {
+        summary += "  mean: "+getValueText(statistics.mean)+"  std dev: "+getValueText(statistics.getStdDev())
+                +"  min: "+getValueText(statistics.minimum)+"  max: "+getValueText(statistics.maximum);
+    }
+    painter->drawText(2, startCoordY, width-4, DATASTRING_HEIGHT, Qt::AlignLeft, summary);
+    uint64_t maximum = histogram.getMaximum();
+    if(maximum == 0 or width <= 0)
+        return;
+    int used = histogram.getBinCount();
+    while(used > 1 and histogram.getBin(used-1) == 0)
+        --used;
+    int top = startCoordY+DATASTRING_HEIGHT;
+    int height = getHeight()-2*DATASTRING_HEIGHT;
+    int bottom = top+height;
+    double binWidthPx = static_cast<double>(width)/used;
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(QColor(0, 160, 255));
+    for(int bin = 0; bin < used; ++bin)
+    {
+        uint64_t count = histogram.getBin(bin);
+        if(count == 0)
+            continue;
+        int barHeight = qMax(1, static_cast<int>(static_cast<double>(count)*height/maximum));
+        int x = static_cast<int>(bin*binWidthPx);
+        int barWidth = qMax(1, static_cast<int>((bin+1)*binWidthPx)-x);
+        painter->drawRect(x, bottom-barHeight, barWidth, barHeight);
+    }
+    painter->setBrush(Qt::NoBrush);
+    painter->setPen(QColor(255, 255, 255));
+    painter->drawText(2, bottom, DATASTRING_WIDTH*2, DATASTRING_HEIGHT, Qt::AlignLeft, getValueText(histogram.getLow()));
+    painter->drawText(width-2*DATASTRING_WIDTH, bottom, 2*DATASTRING_WIDTH, DATASTRING_HEIGHT, Qt::AlignRight,
+                      getValueText(histogram.getLow()+histogram.getBinWidth()*used));
+}
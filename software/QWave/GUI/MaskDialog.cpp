@@ -0,0 +1,67 @@
+//
+//   MaskDialog.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "MaskDialog.h"
+#include "ui_MaskDialog.h"
+
+MaskDialog::MaskDialog(QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::MaskDialog)
+{
+    ui->setupUi(this);
+}
+
+MaskDialog::~MaskDialog()
+{
+    delete ui;
+}
+
+/**
+ * @brief MaskDialog::setupMask this function presents dialog and when user clicks OK it creates
+ * mask from golden waveform and enables mask test.
+ * @param maskTest
+ * @param data data with golden waveform, later blocks of them are tested.
+ * @param from first sample of golden waveform.
+ * @param length length of golden waveform.
+ * @return returns true if mask was set.
+ */
+bool MaskDialog::setupMask(MaskTest* maskTest, PlotData* data, size_t from, size_t length)
+{
+    ui->toleranceSpinBox->setEnabled(data->getType() == PlotData::Linear);
+    ui->stopCheck->setChecked(maskTest->getStopOnFailure());
+    int result = this->exec();
+    if(result != QDialog::Accepted)
+        return false;
+    maskTest->setMask(data, from, length, ui->toleranceSpinBox->value(), ui->timeToleranceSpinBox->value());
+    maskTest->setStopOnFailure(ui->stopCheck->isChecked());
+    maskTest->setEnabled(true);
+    return true;
+}
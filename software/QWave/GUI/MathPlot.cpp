@@ -0,0 +1,198 @@
+//
+//   MathPlot.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <QPainter>
+#include <math.h>
+#include "MathPlot.h"
+#include "SincReconstructor.h"
+
+/**
+ * @brief MathPlot::MathPlot
+ * @param channel math channel owned by this plot, data of it's first channel are used as plot data.
+ * @param name
+ */
+MathPlot::MathPlot(MathChannel * channel, QString name) : Plot(channel->getData(), name), channel(channel),
+    cacheValid(false), cachedBase(0), cachedDivSize(0), cachedWidth(0), cachedFirst(0), cachedPosition(0), pendingSum(0), pendingCount(0),
+    minimum(-128), maximum(127), rangeEnd(0)
+{
+}
+
+MathPlot::~MathPlot()
+{
+    delete(channel);
+}
+
+/**
+ * @brief MathPlot::widen widens range of values by computed values.
+ * @param computedValues
+ * @param count
+ * @param end sample after last computed value.
+ */
+void MathPlot::widen(const float * computedValues, size_t count, size_t end)
+{
+    for(size_t i = 0; i < count; ++i)
+    {
+        minimum = qMin(minimum, computedValues[i]);
+        maximum = qMax(maximum, computedValues[i]);
+    }
+    rangeEnd = qMax(rangeEnd, end);
+}
+
+/**
+ * @brief MathPlot::quantize converts first count values to samples in range of values.
+ * @param count
+ */
+void MathPlot::quantize(int count)
+{
+    double scale = 255/(static_cast<double>(maximum)-minimum);
+    samples.resize(count);
+    for(int i = 0; i < count; ++i)
+    {
+        samples[i] = static_cast<unsigned char>(qBound(0.0, (values.at(i)-minimum)*scale+0.5, 255.0));
+    }
+}
+
+/**
+ * @brief MathPlot::getChangedFrom
+ * @return returns first sample changed in any used channel since last paint.
+ */
+size_t MathPlot::getChangedFrom()
+{
+    size_t first = ALL_SAMPLES;
+    QVector<PlotData*> used = channel->getUsedData();
+    for(int i = 0; i < used.size(); ++i)
+    {
+        if(not paintedVersions.contains(used.at(i)))
+            return 0;
+        QPair<size_t, size_t> dirty = used.at(i)->getDirtySince(paintedVersions.value(used.at(i)));
+        if(dirty.first != dirty.second)
+            first = qMin(first, dirty.first);
+    }
+    return first;
+}
+
+/**
+ * @brief MathPlot::paint computes painted range of math channel and paints it as analog samples.
+ * Values computed by previous paint are reused if view did not change.
+ * @param painter
+ * @param startCoordY
+ * @param width
+ * @param fromTime
+ * @param divSize
+ */
+void MathPlot::paint(QPainter * painter, int startCoordY, int width, uint64_t fromTime, double divSize)
+{
+    uint64_t div = getData()->getDiv();
+    if(div == 0 or divSize <= 0 or width <= 0)
+        return;
+    size_t dirty = channel->update();
+    QVector<PlotData*> used = channel->getUsedData();
+    for(int i = 0; i < used.size(); ++i)
+    {
+        paintedVersions.insert(used.at(i), used.at(i)->checkpointVersion());
+    }
+    if(dirty < rangeEnd)
+    { // values seen so far may be rewritten
+        minimum = -128;
+        maximum = 127;
+        rangeEnd = 0;
+    }
+    size_t length = channel->getLength();
+    double sampleBase = static_cast<double>(fromTime)/div;
+    if(sampleBase >= length)
+        return;
+    if(not cacheValid or dirty < cachedPosition or cachedBase != sampleBase or cachedDivSize != divSize or cachedWidth != width)
+    {
+        cacheValid = true;
+        cachedBase = sampleBase;
+        cachedDivSize = divSize;
+        cachedWidth = width;
+        cachedFirst = static_cast<size_t>(sampleBase);
+        if(divSize >= 1)
+        { // margin for sinc reconstruction
+            cachedFirst = cachedFirst > SincReconstructor::TAPS ? cachedFirst-SincReconstructor::TAPS : 0;
+        }
+        cachedPosition = cachedFirst;
+        values.clear();
+        pendingSum = 0;
+        pendingCount = 0;
+    }
+    if(divSize < 1)
+    { // average samples of each pixel while they are computed
+        double samplesPerPixel = 1/divSize;
+        computed.resize(COMPUTE_BLOCK);
+        int x = values.size();
+        size_t position = cachedPosition;
+        while(x < width and position < length)
+        {
+            size_t end = qMin(length, position+COMPUTE_BLOCK);
+            channel->compute(position, end, computed.data());
+            widen(computed.constData(), end-position, end);
+            size_t s = position;
+            for(; s < end and x < width; ++s)
+            {
+                pendingSum += computed[s-position];
+                ++pendingCount;
+                if(s+1 >= static_cast<size_t>(sampleBase+(x+1)*samplesPerPixel))
+                {
+                    values.append(pendingSum/pendingCount);
+                    ++x;
+                    pendingSum = 0;
+                    pendingCount = 0;
+                }
+            }
+            position = s;
+        }
+        cachedPosition = position;
+        int complete = values.size();
+        if(pendingCount > 0 and complete < width)
+        { // last pixel is painted, but stays open for samples appended later
+            values.append(pendingSum/pendingCount);
+        }
+        x = values.size();
+        quantize(x);
+        values.resize(complete);
+        paintSamples(painter, startCoordY, 1, x, samples.constData(), x, 0);
+    }
+    else
+    { // samples needed for painting
+        size_t last = qMin(length, static_cast<size_t>(ceil(sampleBase+width/divSize))+1+SincReconstructor::TAPS);
+        if(last > cachedPosition)
+        {
+            values.resize(last-cachedFirst);
+            channel->compute(cachedPosition, last, values.data()+(cachedPosition-cachedFirst));
+            widen(values.constData()+(cachedPosition-cachedFirst), last-cachedPosition, last);
+            cachedPosition = last;
+        }
+        quantize(values.size());
+        paintSamples(painter, startCoordY, divSize, width, samples.constData(), values.size(), sampleBase-cachedFirst);
+    }
+}
@@ -0,0 +1,78 @@
+//
+//   MathPlot.h
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef QWave_MathPlot_h
+#define QWave_MathPlot_h
+
+#include "Plot.h"
+#include "../Datamodel/MathChannel.h"
+
+/**
+ * @brief The MathPlot class displays math channel. Only samples of painted range are computed,
+ * when there are more samples than pixels they are averaged while computing, so only one value
+ * per pixel is kept. Values are shown in raw sample range, which widens to minimum and maximum
+ * of all values computed since data were last rewritten, so integrals and products are not
+ * clipped and scale does not jump while scrolling.
+ * Values of painted range are kept while view stays and computed samples are not rewritten,
+ * then only samples appended since last paint are computed.
+ * Plot is repainted from first sample changed in any channel used by expression.
+ */
+class MathPlot : public Plot
+{
+    Q_OBJECT
+    MathChannel * channel;
+    QVector<float> computed;
+    QVector<float> values;
+    QVector<unsigned char> samples;
+    bool cacheValid;
+    double cachedBase;
+    double cachedDivSize;
+    int cachedWidth;
+    size_t cachedFirst;
+    size_t cachedPosition;
+    double pendingSum;
+    size_t pendingCount;
+    float minimum;
+    float maximum;
+    size_t rangeEnd;
+    QMap<PlotData*, uint64_t> paintedVersions;
+    void widen(const float * computedValues, size_t count, size_t end);
+    void quantize(int count);
+public:
+    static const int COMPUTE_BLOCK = 1 << 16;
+    MathPlot(MathChannel * channel, QString name);
+    ~MathPlot();
+    MathChannel * getChannel() { return channel; }
+    void paint(QPainter * painter, int startCoordY, int width, uint64_t fromTime, double divSize);
+    size_t getChangedFrom();
+};
+
+#endif
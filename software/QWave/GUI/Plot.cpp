@@ -34,9 +34,11 @@
 #include "../Datamodel/Constants.h"
 #include <QDebug>
 #include "PlotCanvas.h"
+#include "SincReconstructor.h"
+#include "../Instrumentation/Profiler.h"
 #include <math.h>
 
-Plot::Plot(PlotData * data, QString name) : plotName(name), data(data), analogInterpolated(true), active(false), plotCanvas(NULL)
+Plot::Plot(PlotData * data, QString name) : plotName(name), data(data), interpolation(Linear), active(false), plotCanvas(NULL)
 {
     if(data == NULL or data->getType() == PlotData::Linear)
     {
@@ -65,6 +67,19 @@ void Plot::setData(PlotData * newData)
     {
         heightOfPlot = DEFAULT_HEIGHT_LOG;
     }
+    if(plotCanvas != NULL)
+        static_cast<PlotCanvas*>(plotCanvas)->invalidateRows();
+}
+
+/**
+ * @brief Plot::setHeight sets height of plot, canvas is notified to move following plots.
+ * @param height
+ */
+void Plot::setHeight(int height)
+{
+    heightOfPlot = height;
+    if(plotCanvas != NULL)
+        static_cast<PlotCanvas*>(plotCanvas)->invalidateRows();
 }
 
 Plot::~Plot()
@@ -74,33 +89,43 @@ Plot::~Plot()
 
 /**
  * This function paints actual plot into plot canvas.
- * It determines what it should paint and calls appropriate painting functions.
+ * It uses div size of canvas plot is connected to.
  */
 void Plot::paint(QPainter * painter, int startCoordY,  int width, uint64_t fromTime)
-{   
+{
     if(plotCanvas == NULL)
         return;
-    qDebug() << "Div size: " << static_cast<PlotCanvas*>(plotCanvas)->getDivSize();
+    paint(painter, startCoordY, width, fromTime, static_cast<PlotCanvas*>(plotCanvas)->getDivSize());
+}
+
+/**
+ * This function paints actual plot with given div size (pixels per sample), so it can
+ * be painted also outside of canvas.
+ * It determines what it should paint and calls appropriate painting functions.
+ */
+void Plot::paint(QPainter * painter, int startCoordY,  int width, uint64_t fromTime, double divSize)
+{
+    qHotDebug() << "Div size: " << divSize;
     if(data == NULL)
         return;
     if(data->getType() == PlotData::Logic)
     { // we have logic plot
         if(data->getBitwidth() == 1)
         { // we have plot of sigle bit signal
-            paintWire(painter, startCoordY, static_cast<PlotCanvas*>(plotCanvas)->getDivSize(), width, fromTime);
+            paintWire(painter, startCoordY, divSize, width, fromTime);
         }
         else
         { // we have plot of some register
-            paintRegister(painter, startCoordY, static_cast<PlotCanvas*>(plotCanvas)->getDivSize(), width, fromTime);
+            paintRegister(painter, startCoordY, divSize, width, fromTime);
         }
     }
     else
     { // we have linear plot /i.e. oscillograph/
-        paintLinear(painter, startCoordY, static_cast<PlotCanvas*>(plotCanvas)->getDivSize(), width, fromTime);
+        paintLinear(painter, startCoordY, divSize, width, fromTime);
     }
     if(active)
     {
-        qDebug("Activating..");
+        qHotDebug() << "Activating..";
         painter->setPen(QColor(0, 0, 255)); //blue
         painter->drawLine(1, startCoordY-1, width, startCoordY-1);
         painter->drawLine(1, startCoordY+heightOfPlot+1, width, startCoordY+heightOfPlot+1);
@@ -125,9 +150,11 @@ void Plot::paintWire(QPainter * painter, int startCoordY, double divWidthF, int
     {
         divWidth = divWidthF;
     }
+    BitSamples samples = data->getSamples(0);
+    size_t last = data->lastPositionOnBit(0);
     for(int i = 0; i < width; i += divWidth)
     { // going thru viewport width
-        if(sample >= data->lastPositionOnBit(0))
+        if(sample >= last)
         {
             //we have reached end of data block
             continue;
@@ -135,7 +162,8 @@ void Plot::paintWire(QPainter * painter, int startCoordY, double divWidthF, int
         painter->setPen(QColor(37, 254, 0)); //green
         if(skew > 0 and i == 0)
         {
-            switch (data->getDataAtBit(0)[sample-sampleAdder])
+            size_t previous = sample >= size_t(sampleAdder) ? sample-sampleAdder : 0;
+            switch (samples[previous])
             { // drawing line
             case HIGH:
             {
@@ -162,15 +190,15 @@ void Plot::paintWire(QPainter * painter, int startCoordY, double divWidthF, int
                 break;
             }
             default:
-                qDebug() << "Bad data at: " << sample << " value: " << data->getDataAtBit(0)[sample];
+                qHotDebug() << "Bad data at: " << sample << " value: " << samples[sample];
                 break;
             }
-            if(data->getDataAtBit(0)[sample-sampleAdder] != data->getDataAtBit(0)[sample])
+            if(samples[previous] != samples[sample])
             {
                 painter->drawLine(i+skew, startCoordY, i+skew, startCoordY+heightOfPlot);
             }
         }
-        switch (data->getDataAtBit(0)[sample]) 
+        switch (samples[sample]) 
         { // drawing line
             case HIGH:
             { 
@@ -197,10 +225,10 @@ void Plot::paintWire(QPainter * painter, int startCoordY, double divWidthF, int
                 break;
             }
             default:
-                qDebug() << "Bad data at: " << sample << " value: " << data->getDataAtBit(0)[sample];
+                qHotDebug() << "Bad data at: " << sample << " value: " << samples[sample];
                 break;
         }
-        if(data->getDataAtBit(0)[sample] != data->getDataAtBit(0)[sample+sampleAdder])
+        if(sample+sampleAdder < last and samples[sample] != samples[sample+sampleAdder])
         {
             painter->drawLine(i+skew+divWidth, startCoordY, i+skew+divWidth, startCoordY+heightOfPlot);
         }
@@ -265,19 +293,20 @@ void Plot::paintRegister(QPainter * painter, int startCoordY, double divWidthF,
                 return;
             }
             painter->setPen(QColor(37, 254, 0)); //green
-            if(data->getDataAtBit(ii)[sample] == HIGH_IMPEDANCE)
+            unsigned char value = data->at(ii, sample);
+            if(value == HIGH_IMPEDANCE)
             {
                 painter->setPen(QColor(254, 37, 0)); //red - high impedance
             }
-            if(data->getDataAtBit(ii)[sample] == NO_INFORMATION)
+            if(value == NO_INFORMATION)
             {
                 painter->setPen(QColor(254, 37, 40)); //red - no info
             }
-            if(sample != 0 and data->getDataAtBit(ii)[sample] != data->getDataAtBit(ii)[sample-sampleAdder])
+            if(sample >= size_t(sampleAdder) and value != data->at(ii, sample-sampleAdder))
             {
                 prevDiffers = true;
             }
-            if(data->getDataAtBit(ii)[sample] != data->getDataAtBit(ii)[sample+sampleAdder])
+            if(sample+sampleAdder < data->lastPositionOnBit(ii) and value != data->at(ii, sample+sampleAdder))
             {
                 nextDiffers = true;
             }
@@ -360,7 +389,7 @@ QString Plot::getDatastring(int sample)
             //we have reached end of data block
             return QString("");
         }
-        switch (data->getDataAtBit(i)[sample]) 
+        switch (data->at(i, sample))
         { 
             case HIGH:
             { 
@@ -403,6 +432,9 @@ QString Plot::getDatastring(int sample)
 
 /**
  * This function draws linear data into plot.
+ * Samples are placed at their fractional pixel position. When there are more samples
+ * than pixels each pixel shows average of it's samples, otherwise samples are shown
+ * as dots, joined by lines or reconstructed by sinc interpolation for every pixel.
  * @brief Plot::paintLinear
  * @param painter
  * @param startCoordY
@@ -412,98 +444,127 @@ QString Plot::getDatastring(int sample)
  */
 void Plot::paintLinear(QPainter * painter, int startCoordY, double divWidthF, int width, uint64_t fromTime)
 {
-    if(data->lastPositionOnBit(0) == 0)
-        return;
-    int divWidth = 1;
-    int sampleAdder = 1;
+    size_t length = data->lastPositionOnBit(0);
     double sampleBase = (double)fromTime/data->getDiv();
-    size_t sample = ceil(sampleBase); //getting real starting time
-    int skew = ceil(divWidthF*((double)sample-sampleBase));
+    if(length == 0 or sampleBase >= length)
+        return;
+    QVector<unsigned char> samples;
     if(divWidthF < 1)
-    {
-        sampleAdder = ceil(1/divWidthF);
+    { // one averaged sample per pixel, summed run by run of stored chunks
+        double samplesPerPixel = 1/divWidthF;
+        samples.reserve(width);
+        for(int x = 0; x < width; ++x)
+        {
+            size_t first = static_cast<size_t>(sampleBase+x*samplesPerPixel);
+            size_t last = static_cast<size_t>(sampleBase+(x+1)*samplesPerPixel);
+            if(first >= length)
+                break;
+            if(last > length)
+                last = length;
+            if(last <= first)
+                last = first+1;
+            uint64_t sum = 0;
+            for(size_t s = first; s < last;)
+            {
+                size_t run;
+                const unsigned char * values = data->getRun(0, s, run);
+                run = qMin(run, last-s);
+                for(size_t ii = 0; ii < run; ++ii)
+                {
+                    sum += values[ii];
+                }
+                s += run;
+            }
+            samples.append((sum+(last-first)/2)/(last-first));
+        }
+        paintSamples(painter, startCoordY, 1, samples.size(), samples.constData(), samples.size(), 0);
     }
     else
-    {
-        divWidth = divWidthF;
+    { // samples needed for painting, with margin for sinc reconstruction
+        size_t first = static_cast<size_t>(sampleBase);
+        first = first > SincReconstructor::TAPS ? first-SincReconstructor::TAPS : 0;
+        size_t last = qMin(length, static_cast<size_t>(ceil(sampleBase+width/divWidthF))+1+SincReconstructor::TAPS);
+        samples.resize(last-first);
+        data->copySamples(0, first, last-first, samples.data());
+        paintSamples(painter, startCoordY, divWidthF, width, samples.constData(), last-first, sampleBase-first);
     }
-    for(int i = 0; i < width; i += divWidth)
-    {
-        uint32_t sampleResult = 0;
-        if(sampleAdder > 1)
+}
+
+/**
+ * This function paints analog samples, it is used by paintLinear and by plots
+ * which compute their samples instead of reading them from data.
+ * @brief Plot::paintSamples
+ * @param painter
+ * @param startCoordY
+ * @param divWidthF pixels per sample.
+ * @param width
+ * @param samples
+ * @param length number of samples.
+ * @param sampleBase position of left edge of plot in samples.
+ */
+void Plot::paintSamples(QPainter * painter, int startCoordY, double divWidthF, int width, const unsigned char * samples, size_t length, double sampleBase)
+{
+    if(sampleBase >= length)
+        return;
+    QPolygonF points;
+    if(divWidthF < 1)
+    { // more samples than pixels
+        double samplesPerPixel = 1/divWidthF;
+        points.reserve(width);
+        for(int x = 0; x < width; ++x)
         {
-            for(int s = -sampleAdder; s < 0; ++s)
+            size_t first = static_cast<size_t>(sampleBase+x*samplesPerPixel);
+            size_t last = static_cast<size_t>(sampleBase+(x+1)*samplesPerPixel);
+            if(first >= length)
+                break;
+            if(last > length)
+                last = length;
+            if(last <= first)
+                last = first+1;
+            uint32_t sum = 0;
+            for(size_t s = first; s < last; ++s)
             {
-                if(((long)sample + s > 0) and (sample + s < data->lastPositionOnBit(0))-1)
-                    sampleResult += data->getDataAtBit(0)[sample+s];
-                else
-                    sampleResult += data->getDataAtBit(0)[sample];
+                sum += samples[s];
             }
-            sampleResult = sampleResult/sampleAdder;
+            points.append(QPointF(x, valueToY(startCoordY, (double)sum/(last-first))));
         }
-        else
+    }
+    else if(interpolation == Sinc)
+    { // one reconstructed point per pixel up to last sample
+        int count = static_cast<int>(ceil((length-1-sampleBase)*divWidthF))+1;
+        if(count > width)
+            count = width;
+        QVector<float> values(count);
+        SincReconstructor::instance().reconstruct(samples, length, sampleBase, 1/divWidthF, count, values.data());
+        points.reserve(count);
+        for(int x = 0; x < count; ++x)
         {
-            sampleResult = data->getDataAtBit(0)[sample];
+            points.append(QPointF(x, valueToY(startCoordY, qBound(0.0f, values.at(x), 255.0f))));
         }
-        if(analogInterpolated)
-        {
-            uint32_t sampleResult1 = 0;
-            if(sampleAdder > 1)
-            {
-                for(int s = 0; s < sampleAdder; ++s)
-                {
-                    if((sample + s > 0) and (sample + s < data->lastPositionOnBit(0))-1)
-                        sampleResult1 += data->getDataAtBit(0)[sample+s];
-                    else
-                        sampleResult1 += data->getDataAtBit(0)[sample];
-                }
-                sampleResult1 = sampleResult1/sampleAdder;
-            }
-            else
-            {
-                if(sample + sampleAdder < data->lastPositionOnBit(0)-1)
-                    sampleResult1 = data->getDataAtBit(0)[sample+sampleAdder];
-                else
-                    sampleResult1 = data->getDataAtBit(0)[sample];
-            }
-           // qDebug("Will interpolate");
-            if(skew > 0 and i == 0)
-            {
-                uint32_t previousSampleResult;
-                if(sampleAdder > 1)
-                {
-                    for(int s = -2*sampleAdder; s < -sampleAdder; ++s)
-                    {
-                        //if((sample + s > 0) and (sample + s < data->lastPositionOnBit(0)))
-                            previousSampleResult += data->getDataAtBit(0)[sample+s];
-                        //else
-                        //    sampleResult += data->getDataAtBit(0)[sample];
-                    }
-                    previousSampleResult = previousSampleResult/sampleAdder;
-                }
-                else
-                {
-                    previousSampleResult = data->getDataAtBit(0)[sample-sampleAdder];
-                }
-                painter->drawLine(i+skew-divWidth, startCoordY+(heightOfPlot*(255-previousSampleResult)/255),
-                                  i+skew, startCoordY+(heightOfPlot*(255-sampleResult)/255));
-            }
-            painter->drawLine(i+skew, startCoordY+(heightOfPlot*(255-sampleResult)/255),
-                              i+skew+divWidth, startCoordY+(heightOfPlot*(255-sampleResult1)/255));
-        }
-        else
+    }
+    else
+    { // samples on their positions, including one before and after viewport to join edges
+        size_t first = static_cast<size_t>(sampleBase);
+        size_t last = static_cast<size_t>(ceil(sampleBase+width/divWidthF))+1;
+        if(last > length)
+            last = length;
+        points.reserve(last-first);
+        for(size_t s = first; s < last; ++s)
         {
-            //qDebug("Will scatter");
-            painter->drawPoint(i+skew, startCoordY+(heightOfPlot*(255-sampleResult))/255);
-            /*qDebug() << "Data at: " << sample << " is:"
-                     << sampleResult
-                     << "result is: "
-                     << sampleResult/255;*/
+            points.append(QPointF((s-sampleBase)*divWidthF, valueToY(startCoordY, samples[s])));
         }
-        sample += sampleAdder;
-        if(sample > data->lastPositionOnBit(0)-2)
-            return;
     }
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+    if(interpolation == Dots)
+    {
+        painter->drawPoints(points);
+    }
+    else
+    {
+        painter->drawPolyline(points);
+    }
+    painter->restore();
 }
 
 /**
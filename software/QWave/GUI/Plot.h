@@ -56,23 +56,34 @@ class Plot : public QObject
     PlotData * data;
     //int calculateDivSize(uint64_t scale, int widthOfDiv);
     QString getDatastring(int sample);
-    bool analogInterpolated;
+    int interpolation;
     bool active;
     QObject* plotCanvas;
-    void drawText(QPainter* painter, int x, int y, int w, int h, QString text);
     void paintWire(QPainter * painter, int startCoordY, double divWidth, int width, uint64_t fromTime);
     void paintRegister(QPainter * painter, int startCoordY, double divWidth, int width, uint64_t fromTime);
     void paintLinear(QPainter * painter, int startCoordY, double divWidth, int width, uint64_t fromTime);
+    double valueToY(int startCoordY, double value) { return startCoordY+(heightOfPlot*(255-value))/255; }
+protected:
+    void drawText(QPainter* painter, int x, int y, int w, int h, QString text);
+    void setHeight(int height);
+    void paintSamples(QPainter * painter, int startCoordY, double divWidthF, int width, const unsigned char * samples, size_t length, double sampleBase);
 public:
+    enum Interpolation { Dots, Linear, Sinc };
     Plot(PlotData * data, QString name);  
-    ~Plot();
+    virtual ~Plot();
     PlotData* getData() { return data; }
     void setData(PlotData * newData);
     void paint(QPainter * painter, int startCoordY, int width, uint64_t fromTime);
-    void toggleInterpolate() { this->analogInterpolated = not this->analogInterpolated; }
+    virtual void paint(QPainter * painter, int startCoordY, int width, uint64_t fromTime, double divSize);
+    virtual bool isTimeBased() { return true; }
+    virtual bool needsRepaint() { return false; }
+    virtual size_t getChangedFrom() { return ALL_SAMPLES; }
+    void setInterpolation(int interpolation) { this->interpolation = interpolation; }
+    int getInterpolation() { return interpolation; }
     int getHeight() { return heightOfPlot; }
     void setActive() { active = true; }
     void setInactive() { active = false; }
+    bool isActive() { return active; }
     bool isAnalog() { if(data->getType() == PlotData::Linear) return true; else return false; }
     void connectPlotCanvas(QObject* plotCanvas) { this->plotCanvas = plotCanvas; }
     uint64_t getSmallestDiv();
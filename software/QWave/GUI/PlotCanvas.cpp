@@ -34,8 +34,11 @@
 #include "Board.h"
 #include <QDebug>
 #include <QSize>
+#include <QtAlgorithms>
+#include "../Instrumentation/Profiler.h"
+#include "../Datamodel/Constants.h"
 
-PlotCanvas::PlotCanvas(QWidget * parent) : QWidget(parent), board(NULL), from(0), to(0), scale(0), divSize(10), markerPosition(1), markerPosition2(1), showSecondMarker(false)
+PlotCanvas::PlotCanvas(QWidget * parent) : QWidget(parent), board(NULL), from(0), to(0), scale(0), divSize(10), markerPosition(1), markerPosition2(1), showSecondMarker(false), backingValid(false), rollMode(false), cachedFrom(0), cachedDivSize(0), measurementMode(NoMeasurements), comparator(NULL), rowsValid(false), firstRow(0), lastRow(0), cachedTop(0)
 {
     setStyleSheet("background-color: black");
     setAutoFillBackground(true);
@@ -46,13 +49,15 @@ PlotCanvas::PlotCanvas(QWidget * parent) : QWidget(parent), board(NULL), from(0)
 }
 
 /**
- * @brief PlotCanvas::toggleInterpolate Toggles interpolation
+ * @brief PlotCanvas::setInterpolation sets interpolation
  * of given plot.
- * @param index index of toggled plot.
+ * @param index index of plot.
+ * @param interpolation one of Plot::Interpolation.
  */
-void PlotCanvas::toggleInterpolate(int index)
+void PlotCanvas::setInterpolation(int index, int interpolation)
 {
-    plots.at(index)->toggleInterpolate();
+    plots.at(index)->setInterpolation(interpolation);
+    invalidate();
     repaint();
 }
 
@@ -67,6 +72,7 @@ void PlotCanvas::setPlotActive(int index)
         plots[i]->setInactive();
     }
     plots[index]->setActive();
+    invalidate();
     repaint();
 }
 
@@ -85,7 +91,7 @@ PlotCanvas::~PlotCanvas()
  */
 int PlotCanvas::getDivCount()
 {
-    qDebug() << "W: " << width() << "DIV_SPACING_PX: " << DIV_SPACING_PX;
+    qHotDebug() << "W: " << width() << "DIV_SPACING_PX: " << DIV_SPACING_PX;
     return width()/DIV_SPACING_PX;
 }
 
@@ -351,20 +357,432 @@ void PlotCanvas::paintEvent(QPaintEvent * e)
         delete(painter);
         return;
     }
-    drawGrid(painter); // drawing grid
-    int lastCoordY = MARKER_HEIGHT*2+PLOT_SPACING_PX;
-    painter->setPen(QColor(0, 255, 0));
-    for(int i = 0; i < plots.size(); ++i)
-    { // painting plots and markers
-        int newWidth = width();
-        plots.at(i)->paint(painter, lastCoordY, newWidth, from);
-        lastCoordY += plots.at(i)->getHeight() + PLOT_SPACING_PX;
-        painter->setPen(QColor(40, 40, 60));
-        painter->drawLine(0, lastCoordY-PLOT_SPACING_PX/2, width(), lastCoordY-PLOT_SPACING_PX/2);
-        painter->setPen(QColor(0, 255, 0));
+    // only rows in visible part of scroll area are painted
+    QRect area = visibleRegion().boundingRect();
+    if(area.isEmpty())
+        area = rect();
+    updateBackingStore(QRect(0, area.top(), width(), area.height()));
+    {
+        ScopedTimer timer(Profiler::Composite);
+        drawGrid(painter); // drawing grid
+        painter->drawPixmap(0, cachedTop, backingStore);
+    }
+    if(comparator != NULL and not comparator->isEmpty())
+    {
+        drawDifferencesOverlay(painter);
+    }
+    if(measurementMode != NoMeasurements)
+    {
+        drawMeasurementsOverlay(painter);
+    }
+    if(Profiler::instance().isEnabled())
+    {
+        drawProfilerOverlay(painter);
     }
     painter->end();
     delete(painter);
+    Profiler::instance().frameFinished();
+}
+
+/**
+ * @brief PlotCanvas::drawProfilerOverlay draws FPS and stage times in top right corner.
+ * @param painter
+ */
+void PlotCanvas::drawProfilerOverlay(QPainter * painter)
+{
+    QStringList lines = Profiler::instance().getSummary();
+    QFontMetrics fm(painter->font());
+    int lineHeight = fm.height();
+    int boxWidth = 0;
+    for(int i = 0; i < lines.count(); ++i)
+    {
+        boxWidth = qMax(boxWidth, fm.width(lines.at(i)));
+    }
+    boxWidth += 2*PLOT_SPACING_PX;
+    int x = width()-boxWidth-PLOT_SPACING_PX;
+    int y = MARKER_HEIGHT*2+PLOT_SPACING_PX;
+    painter->fillRect(x, y, boxWidth, lineHeight*lines.count()+2*PLOT_SPACING_PX, QColor(0, 0, 0, 180));
+    painter->setPen(QColor(255, 255, 180));
+    for(int i = 0; i < lines.count(); ++i)
+    {
+        painter->drawText(x+PLOT_SPACING_PX, y+PLOT_SPACING_PX+i*lineHeight, boxWidth, lineHeight, 0, lines.at(i));
+    }
+}
+
+/**
+ * @brief PlotCanvas::getFrequencyText
+ * @param period period in ps.
+ * @return returns text of frequency corresponding to given period.
+ */
+QString PlotCanvas::getFrequencyText(double period)
+{
+    double frequency = E12/period;
+    if(frequency < E3)
+        return QString::number(frequency, 'f', 2)+HERTZ;
+    if(frequency < E6)
+        return QString::number(frequency/E3, 'f', 2)+KHZ;
+    return QString::number(frequency/E6, 'f', 2)+MHZ;
+}
+
+/**
+ * @brief PlotCanvas::getMeasurementLines measures plot over visible range or whole data.
+ * Registers are measured on their least significant bit.
+ * @param plot
+ * @return returns lines of measurement readout.
+ */
+QStringList PlotCanvas::getMeasurementLines(Plot * plot)
+{
+    PlotData * data = plot->getData();
+    int bit = data->getBitwidth()-1;
+    Measurement m;
+    if(measurementMode == WholeMeasurements)
+    {
+        m = measurements.measureWhole(data, bit);
+    }
+    else
+    {
+        m = Measurements::measure(data, bit, from/data->getDiv(), to/data->getDiv()+1);
+    }
+    QStringList lines;
+    lines << plot->getName()+(measurementMode == WholeMeasurements ? " (whole capture)" : " (visible)")+": "+QString::number(m.samples)+" samples";
+    if(m.samples == 0)
+        return lines;
+    if(plot->isAnalog())
+    {
+        lines << QString("Vpp %1  Min %2  Max %3").arg(m.maximum-m.minimum).arg(m.minimum).arg(m.maximum);
+        lines << QString("Mean %1  RMS %2").arg(m.mean, 0, 'f', 2).arg(m.rms, 0, 'f', 2);
+    }
+    else
+    {
+        lines << QString("Edges: %1 rising, %2 falling").arg(m.risingEdges).arg(m.fallingEdges);
+    }
+    if(m.period > 0)
+    {
+        lines << "Frequency "+getFrequencyText(m.period)+"  Period "+getMarker(m.period)
+                 +"  Duty "+QString::number(m.dutyCycle, 'f', 1)+" %";
+    }
+    if(plot->isAnalog())
+    {
+        if(m.riseTime > 0 or m.fallTime > 0)
+            lines << "Rise "+getMarker(m.riseTime)+"  Fall "+getMarker(m.fallTime);
+    }
+    else
+    {
+        if(m.maxHighWidth > 0)
+            lines << "High pulses "+getMarker(m.minHighWidth)+" - "+getMarker(m.maxHighWidth);
+        if(m.maxLowWidth > 0)
+            lines << "Low pulses "+getMarker(m.minLowWidth)+" - "+getMarker(m.maxLowWidth);
+    }
+    return lines;
+}
+
+/**
+ * @brief PlotCanvas::drawMeasurementsOverlay draws measurements of active plots in bottom left corner.
+ * @param painter
+ */
+void PlotCanvas::drawMeasurementsOverlay(QPainter * painter)
+{
+    QStringList lines;
+    for(int i = 0; i < plots.count(); ++i)
+    {
+        if(plots[i]->isActive() and plots[i]->getData() != NULL)
+            lines << getMeasurementLines(plots[i]);
+    }
+    if(lines.isEmpty())
+        return;
+    QFontMetrics fm(painter->font());
+    int lineHeight = fm.height();
+    int boxWidth = 0;
+    for(int i = 0; i < lines.count(); ++i)
+    {
+        boxWidth = qMax(boxWidth, fm.width(lines.at(i)));
+    }
+    boxWidth += 2*PLOT_SPACING_PX;
+    int boxHeight = lineHeight*lines.count()+2*PLOT_SPACING_PX;
+    int x = PLOT_SPACING_PX;
+    int y = height()-boxHeight-PLOT_SPACING_PX;
+    painter->fillRect(x, y, boxWidth, boxHeight, QColor(0, 0, 0, 180));
+    painter->setPen(QColor(255, 255, 180));
+    for(int i = 0; i < lines.count(); ++i)
+    {
+        painter->drawText(x+PLOT_SPACING_PX, y+PLOT_SPACING_PX+i*lineHeight, boxWidth, lineHeight, 0, lines.at(i));
+    }
+}
+
+/**
+ * @brief PlotCanvas::drawDifferencesOverlay highlights ranges where plots differ from reference
+ * capture. Only ranges in visible time are looked up, ranges falling into already highlighted
+ * pixel are skipped.
+ * @param painter
+ */
+void PlotCanvas::drawDifferencesOverlay(QPainter * painter)
+{
+    double pxPerPs = divSize/smallestDiv();
+    uint64_t visibleTo = from+static_cast<uint64_t>(width()/pxPerPs);
+    for(int i = firstRow; i < lastRow; ++i)
+    {
+        int y = rowTops.at(i);
+        const QVector<QPair<size_t, size_t> > * ranges = NULL;
+        if(plots.at(i)->isTimeBased() and plots.at(i)->getData() != NULL)
+            ranges = comparator->getRanges(plots.at(i)->getData());
+        if(ranges != NULL and not ranges->isEmpty())
+        {
+            uint64_t div = plots.at(i)->getData()->getDiv();
+            QPair<size_t, size_t> first(static_cast<size_t>(from/div), 0);
+            QVector<QPair<size_t, size_t> >::const_iterator it = qLowerBound(ranges->constBegin(), ranges->constEnd(), first);
+            if(it != ranges->constBegin() and (it-1)->second > first.first)
+                --it;
+            int lastX = -1;
+            for(; it != ranges->constEnd() and it->first*div < visibleTo; ++it)
+            {
+                double startX = (static_cast<double>(it->first*div)-static_cast<double>(from))*pxPerPs;
+                double endX = (static_cast<double>(it->second*div)-static_cast<double>(from))*pxPerPs;
+                int x = qMax(0, static_cast<int>(startX));
+                int w = qMax(1, static_cast<int>(endX)-x);
+                if(x+w <= lastX)
+                    continue;
+                painter->fillRect(x, y, w, plots.at(i)->getHeight(), QColor(255, 0, 0, 90));
+                lastX = x+w;
+            }
+        }
+    }
+}
+
+/**
+ * @brief PlotCanvas::setRollMode enables roll mode used during live capture.
+ * In roll mode already painted part of plots is scrolled when from moves forward
+ * and only newly appended samples are painted.
+ * @param enabled
+ */
+void PlotCanvas::setRollMode(bool enabled)
+{
+    if(rollMode != enabled)
+        invalidate();
+    rollMode = enabled;
+}
+
+/**
+ * @brief PlotCanvas::invalidate forces plots to be painted from scratch on next repaint.
+ */
+void PlotCanvas::invalidate()
+{
+    backingValid = false;
+}
+
+/**
+ * @brief PlotCanvas::invalidateRows forces positions of rows to be calculated again,
+ * called when plots are added, removed or change their height.
+ */
+void PlotCanvas::invalidateRows()
+{
+    rowsValid = false;
+    invalidate();
+    updateGeometry();
+}
+
+/**
+ * @brief PlotCanvas::updateRows calculates prefix sum of row heights, rowTops[i] is
+ * top of plot i and last item is bottom of last plot.
+ */
+void PlotCanvas::updateRows() const
+{
+    if(rowsValid)
+        return;
+    rowTops.resize(plots.size()+1);
+    int y = MARKER_HEIGHT*2+PLOT_SPACING_PX;
+    for(int i = 0; i < plots.size(); ++i)
+    {
+        rowTops[i] = y;
+        y += plots.at(i)->getHeight() + PLOT_SPACING_PX;
+    }
+    rowTops[plots.size()] = y;
+    rowsValid = true;
+}
+
+/**
+ * @brief PlotCanvas::findVisibleRows sets firstRow and lastRow (exclusive) to rows
+ * intersecting given vertical range, found by binary search in row tops.
+ * @param top
+ * @param bottom
+ */
+void PlotCanvas::findVisibleRows(int top, int bottom)
+{
+    updateRows();
+    firstRow = qUpperBound(rowTops.constBegin(), rowTops.constEnd(), top)-rowTops.constBegin()-1;
+    firstRow = qMax(firstRow, 0);
+    lastRow = qLowerBound(rowTops.constBegin(), rowTops.constEnd(), bottom)-rowTops.constBegin();
+    lastRow = qMax(qMin(lastRow, plots.size()), firstRow);
+}
+
+/**
+ * @brief PlotCanvas::hasCommonDiv
+ * @return returns true if all visible plots have same div, so they move by same number of pixels.
+ */
+bool PlotCanvas::hasCommonDiv()
+{
+    for(int i = firstRow+1; i < lastRow; ++i)
+    {
+        if(plots.at(i)->getData() == NULL or plots.at(firstRow)->getData() == NULL
+           or plots.at(i)->getData()->getDiv() != plots.at(firstRow)->getData()->getDiv())
+        {
+            return false;
+        }
+    }
+    return lastRow > firstRow and plots.at(firstRow)->getData() != NULL;
+}
+
+/**
+ * @brief PlotCanvas::renderPlots paints visible plots into backing store starting from column fromX,
+ * backing store column 0 corresponds to time cachedFrom and its row 0 to canvas row cachedTop.
+ * Columns left of fromX are left untouched, except rows of plots which are not time based,
+ * those are repainted whole.
+ * @param fromX
+ */
+void PlotCanvas::renderPlots(int fromX)
+{
+    QPainter painter(&backingStore);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(fromX, 0, width()-fromX, backingStore.height(), Qt::transparent);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    painter.setClipRect(fromX, 0, width()-fromX, backingStore.height());
+    // start a bit earlier so that datastrings and transitions at left edge
+    // of repainted strip are clipped away instead of being repeated
+    int startX = 0;
+    uint64_t fromTime = cachedFrom;
+    if(fromX > DATASTRING_WIDTH and hasCommonDiv())
+    {
+        startX = fromX-DATASTRING_WIDTH;
+        fromTime += static_cast<uint64_t>((startX*plots.at(firstRow)->getData()->getDiv())/divSize);
+    }
+    painter.translate(startX, -cachedTop);
+    painter.setPen(QColor(0, 255, 0));
+    for(int i = firstRow; i < lastRow; ++i)
+    { // painting plots and separators
+        int lastCoordY = rowTops.at(i);
+        if(plots.at(i)->isTimeBased())
+        {
+            if(fromX < width())
+            {
+                ScopedTimer timer(Profiler::PaintPlot);
+                plots.at(i)->paint(&painter, lastCoordY, width()-startX, fromTime);
+            }
+        }
+        else
+        { // plots not based on time are always painted over whole row
+            ScopedTimer timer(Profiler::PaintPlot);
+            painter.save();
+            painter.resetTransform();
+            painter.translate(0, -cachedTop);
+            painter.setClipping(false);
+            painter.setCompositionMode(QPainter::CompositionMode_Source);
+            painter.fillRect(0, lastCoordY, width(), plots.at(i)->getHeight(), Qt::transparent);
+            painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+            plots.at(i)->paint(&painter, lastCoordY, width(), fromTime);
+            painter.restore();
+        }
+        int separatorY = rowTops.at(i+1)-PLOT_SPACING_PX/2;
+        painter.setPen(QColor(40, 40, 60));
+        painter.drawLine(0, separatorY, width()-startX, separatorY);
+        painter.setPen(QColor(0, 255, 0));
+    }
+    painter.end();
+    for(int i = firstRow; i < lastRow; ++i)
+    {
+        if(plots.at(i)->getData() != NULL)
+        {
+            renderedVersions.insert(plots.at(i)->getData(), plots.at(i)->getData()->checkpointVersion());
+        }
+    }
+}
+
+/**
+ * @brief PlotCanvas::updateBackingStore brings backing store up to date with plots.
+ * Backing store covers only given visible area of canvas and only rows in it are painted.
+ * Whole backing store is repainted only when view changed, otherwise only columns
+ * showing samples appended since last repaint are painted. In roll mode moving
+ * forward scrolls already painted columns instead of painting them again.
+ * @param area visible area of canvas.
+ */
+void PlotCanvas::updateBackingStore(const QRect & area)
+{
+    if(backingStore.size() != area.size())
+    {
+        backingStore = QPixmap(area.size());
+        // filling with transparent color gives pixmap alpha channel, so grid stays visible under plots
+        backingStore.fill(Qt::transparent);
+        backingValid = false;
+    }
+    if(cachedTop != area.top())
+    {
+        cachedTop = area.top();
+        backingValid = false;
+    }
+    findVisibleRows(area.top(), area.bottom()+1);
+    if(not backingValid or cachedDivSize != divSize or from < cachedFrom or not hasCommonDiv())
+    {
+        renderedVersions.clear();
+        cachedFrom = from;
+        cachedDivSize = divSize;
+        renderPlots(0);
+        backingValid = true;
+        return;
+    }
+    uint64_t div = plots.at(firstRow)->getData()->getDiv();
+    int shift = static_cast<int>(((from-cachedFrom)*divSize)/div);
+    if(shift > 0)
+    {
+        if(not rollMode or shift >= width())
+        {
+            renderedVersions.clear();
+            cachedFrom = from;
+            renderPlots(0);
+            return;
+        }
+        backingStore.scroll(-shift, 0, backingStore.rect());
+        cachedFrom += static_cast<uint64_t>((shift*div)/divSize);
+    }
+    int dirtyX = width()-shift;
+    for(int i = firstRow; i < lastRow; ++i)
+    {
+        PlotData* data = plots.at(i)->getData();
+        if(not renderedVersions.contains(data))
+        {
+            dirtyX = 0;
+            break;
+        }
+        QPair<size_t, size_t> dirty = data->getDirtySince(renderedVersions.value(data));
+        size_t first = plots.at(i)->getChangedFrom();
+        if(dirty.first != dirty.second)
+            first = qMin(first, dirty.first);
+        if(first == ALL_SAMPLES)
+            continue;
+        // previous sample has to be repainted too, as it's transition to new sample was unknown
+        uint64_t dirtyTime = (first > 0 ? first-1 : 0)*div;
+        if(dirtyTime <= cachedFrom)
+        {
+            dirtyX = 0;
+            break;
+        }
+        int x = static_cast<int>(((dirtyTime-cachedFrom)*divSize)/div);
+        if(x < dirtyX)
+            dirtyX = x;
+    }
+    if(dirtyX < width() or needsRepaint())
+        renderPlots(dirtyX);
+}
+
+/**
+ * @brief PlotCanvas::needsRepaint
+ * @return returns true if some visible plot not based on time changed since it was painted.
+ */
+bool PlotCanvas::needsRepaint()
+{
+    for(int i = firstRow; i < lastRow; ++i)
+    {
+        if(plots.at(i)->needsRepaint())
+            return true;
+    }
+    return false;
 }
 
 /**
@@ -375,7 +793,22 @@ void PlotCanvas::addPlot(Plot * plot)
 {
     plots.push_back(plot);
     plot->connectPlotCanvas(this);
-    updateGeometry();
+    invalidateRows();
+    repaint();
+}
+
+/**
+ * @brief PlotCanvas::addPlots adds given plots to canvas and repaints it once.
+ * @param newPlots
+ */
+void PlotCanvas::addPlots(const QVector<Plot*> & newPlots)
+{
+    for(int i = 0; i < newPlots.size(); ++i)
+    {
+        plots.push_back(newPlots.at(i));
+        newPlots.at(i)->connectPlotCanvas(this);
+    }
+    invalidateRows();
     repaint();
 }
 
@@ -391,17 +824,13 @@ int PlotCanvas::calculateWidth() const
 }
 
 /**
- * @brief PlotCanvas::calculateHeight calculates height of canvas.
+ * @brief PlotCanvas::calculateHeight calculates height of canvas from bottom of last row.
  * @return
  */
 int PlotCanvas::calculateHeight() const
 {
-    int height = 2*MARKER_HEIGHT;
-    for(int i = 0; i < plots.size(); ++i)
-    {
-        height += plots.at(i)->getHeight() + PLOT_SPACING_PX*2;
-    }
-    return height;
+    updateRows();
+    return rowTops.last() + PLOT_SPACING_PX;
 }
 
 /**
@@ -423,6 +852,29 @@ void PlotCanvas::clear()
         delete(plots.at(i));
     }
     plots.clear();
+    renderedVersions.clear();
+    measurements.clear();
+    invalidateRows();
+}
+
+/**
+ * Removes plots from given index to end of canvas, plots before it are kept.
+ */
+void PlotCanvas::removePlots(int from)
+{
+    for(int i = from; i < plots.size(); ++i)
+    {
+        PlotData * data = plots.at(i)->getData();
+        if(data != NULL)
+        {
+            renderedVersions.remove(data);
+            measurements.forget(data);
+        }
+        delete(plots.at(i));
+    }
+    if(from < plots.size())
+        plots.resize(from);
+    invalidateRows();
 }
 
 /**
@@ -34,10 +34,14 @@
 
 #include <QWidget>
 #include "Plot.h"
+#include "../Datamodel/Measurements.h"
+#include "../Datamodel/CaptureComparator.h"
 #include <QScrollArea>
 #include <QVBoxLayout>
 #include <QString>
 #include <QScrollBar>
+#include <QPixmap>
+#include <QMap>
 
 const static int PLOT_SPACING_PX = 5;
 const static int DIV_SPACING_PX = 160;
@@ -65,6 +69,13 @@ class PlotCanvas : public QWidget
     void drawGrid(QPainter * painter);
     QVector<Plot*> plots;
     int calculateHeight() const;
+    mutable QVector<int> rowTops;
+    mutable bool rowsValid;
+    int firstRow;
+    int lastRow;
+    int cachedTop;
+    void updateRows() const;
+    void findVisibleRows(int top, int bottom);
     int calculateWidth() const;
     int markerPosition;
     int markerPosition2;
@@ -76,26 +87,54 @@ class PlotCanvas : public QWidget
     void keyPressEvent(QKeyEvent * e );
     QString getMarker(uint64_t marker);
     void refreshScaleTo();
+    QPixmap backingStore;
+    bool backingValid;
+    bool rollMode;
+    uint64_t cachedFrom;
+    double cachedDivSize;
+    QMap<PlotData*, uint64_t> renderedVersions;
+    bool hasCommonDiv();
+    void updateBackingStore(const QRect & area);
+    void renderPlots(int fromX);
+    bool needsRepaint();
+    void drawProfilerOverlay(QPainter * painter);
+    Measurements measurements;
+    int measurementMode;
+    QStringList getMeasurementLines(Plot * plot);
+    QString getFrequencyText(double period);
+    void drawMeasurementsOverlay(QPainter * painter);
+    CaptureComparator * comparator;
+    void drawDifferencesOverlay(QPainter * painter);
 public:
+    enum MeasurementMode { NoMeasurements, VisibleMeasurements, WholeMeasurements };
+    void setMeasurementMode(int mode) { measurementMode = mode; update(); }
+    void setComparator(CaptureComparator * comparator) { this->comparator = comparator; update(); }
     QSize sizeHint() const;
     void setBoard(QWidget * board) { this->board = board; }
     void paintEvent(QPaintEvent * e);
     bool isAnalog(int row) { return plots.at(row)->isAnalog(); }
-    void toggleInterpolate(int index);
+    void setInterpolation(int index, int interpolation);
     PlotCanvas(QWidget * parent = 0);
     ~PlotCanvas();
     //virtual QSize sizeHint () const;
     void addPlot(Plot * plot);
+    void addPlots(const QVector<Plot*> & newPlots);
+    void removePlots(int from);
+    int getPlotCount() const { return plots.size(); }
     int getDivCount();
     void clear();
     void setPlotActive(int index);
     QString getScaleText(uint64_t value);
     uint64_t getScale() { return scale; }
+    uint64_t getFrom() { return from; }
     double getDivSize() { return divSize; }
     Plot* getPlot(int index) { return plots.at(index); }
     QVector<Plot*> getPlots() { return plots; }
     uint64_t getMaxTime();
+    void invalidate();
+    void invalidateRows();
 public slots:
+    void setRollMode(bool enabled);
     void zoomIn();
     void zoomOut();
     void setFrom(uint64_t from);
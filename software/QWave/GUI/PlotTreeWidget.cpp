@@ -54,7 +54,7 @@ void PlotTreeWidget::setModel(PlotTreeModel * model)
 PlotTreeItem * PlotTreeWidget::selectedItem()
 {
     QModelIndex index = ui.treeView->selectionModel()->currentIndex();
-    return static_cast<PlotTreeItem*>(treeModel->itemFromIndex(index));
+    return treeModel->itemFromIndex(index);
 }
 
 /**
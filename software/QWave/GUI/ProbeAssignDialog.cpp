@@ -31,6 +31,8 @@
 
 #include "ProbeAssignDialog.h"
 #include "ui_ProbeAssignDialog.h"
+#include "../Exceptions/Exception.h"
+#include <QMessageBox>
 
 #define LOGIC_MAX_BITS 16
 
@@ -112,6 +114,16 @@ void ProbeAssignDialog::assignDialog(CaptureController * controller, Board * boa
         Plot* plot;
         int type;
         PlotData* newData;
+        char sign;
+        try
+        {
+            sign = board->getFreeSign();
+        }
+        catch(Exception e)
+        {
+            QMessageBox::warning(this, "Probe error", e.getMessage());
+            return;
+        }
         plot = board->createMeasurementPlot(type);
         if(ui->analogRadio->isChecked())
         {
@@ -119,7 +131,8 @@ void ProbeAssignDialog::assignDialog(CaptureController * controller, Board * boa
                !controller->isAnalog2Free(controller->getDeviceController()->getDevice(ui->probeChoserCombo->currentIndex())))
                 return;
             type = PlotData::Linear;
-            newData = new PlotData(type, plot->getName(), (uint64_t)1,  1, board->getRandomSign());
+            newData = new PlotData(type, plot->getName(), (uint64_t)1,  1, sign);
+            newData->setCompressed(ui->compressCheck->isChecked());
             if(!controller->isAnalog1Free(controller->getDeviceController()->getDevice(ui->probeChoserCombo->currentIndex())))
                 controller->assignDevicePlotData(newData, getDevicePointer(controller->getDeviceController()),
                                                  1, 0, 0);
@@ -134,14 +147,14 @@ void ProbeAssignDialog::assignDialog(CaptureController * controller, Board * boa
         else if(ui->wireRadio->isChecked())
         {
             type = PlotData::Logic;
-            newData = new PlotData(type, plot->getName(), (uint64_t)1,  1, board->getRandomSign());
+            newData = new PlotData(type, plot->getName(), (uint64_t)1,  1, sign);
             controller->assignDevicePlotData(newData, getDevicePointer(controller->getDeviceController()), 2,
                                                                  controller->getCurrentWireIndex(controller->getDeviceController()->getDevice(ui->probeChoserCombo->currentIndex())), 1);
         }
         else if(ui->registerRadio->isChecked())
         {
             type = PlotData::Logic;
-            newData = new PlotData(type, plot->getName(), (uint64_t)1,  ui->widthCombo->currentIndex()+1, board->getRandomSign());
+            newData = new PlotData(type, plot->getName(), (uint64_t)1,  ui->widthCombo->currentIndex()+1, sign);
             controller->assignDevicePlotData(newData, getDevicePointer(controller->getDeviceController()), 2,
                                                                  controller->getCurrentWireIndex(controller->getDeviceController()->getDevice(ui->probeChoserCombo->currentIndex())),
                                                                  ui->widthCombo->currentIndex()+1);
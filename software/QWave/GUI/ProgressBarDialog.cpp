@@ -35,12 +35,40 @@
 #include  <QMessageBox>
 
 ProgressBarDialog::ProgressBarDialog(QFuture<void> & future, QString label, QWidget * parent, Qt::WindowFlags f) :
-    QDialog(parent, f), future(future)
+    QDialog(parent, f), future(&future)
 {
     ui.setupUi(this);
     ui.operationLabel->setText(label);
 }
 
+/**
+ * @brief ProgressBarDialog::ProgressBarDialog creates dialog showing progress set by setProgress,
+ * cancel button emits cancelled().
+ */
+ProgressBarDialog::ProgressBarDialog(QString label, QWidget * parent, Qt::WindowFlags f) :
+    QDialog(parent, f), future(NULL)
+{
+    ui.setupUi(this);
+    ui.operationLabel->setText(label);
+    connect(ui.cancelButton, SIGNAL(clicked()), this, SIGNAL(cancelled()));
+}
+
+/**
+ * @brief ProgressBarDialog::setProgress
+ * @param done part of operation done, for example bytes read.
+ * @param total whole operation, unknown when 0.
+ */
+void ProgressBarDialog::setProgress(qint64 done, qint64 total)
+{
+    if(total <= 0)
+    {
+        ui.progressBar->setRange(0, 0);
+        return;
+    }
+    ui.progressBar->setRange(0, PROGRESS_STEPS);
+    ui.progressBar->setValue(static_cast<int>(qMin(done, total)*PROGRESS_STEPS/total));
+}
+
 /**
  * @brief ProgressBarDialog::wait this method presents dialog and wait for future (end of saving/loading operation)
  */
@@ -49,7 +77,7 @@ void ProgressBarDialog::wait()
     this->show();
     try
     {
-        future.waitForFinished();
+        future->waitForFinished();
     }
     catch (IOException e)
     {
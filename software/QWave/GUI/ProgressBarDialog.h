@@ -38,20 +38,24 @@
 
 /**
  * @brief The ProgressBarDialog class represents dialog which appears when user loads or saves measuremet.
+ * It either waits for future, or stays open showing progress of operation until it is closed.
  */
 class ProgressBarDialog : public QDialog
 {
     Q_OBJECT
-    QFuture<void> & future;
+    QFuture<void> * future;
 
     Ui::ProgressBarDialog ui;
 public:
+    static const int PROGRESS_STEPS = 1000;
     explicit ProgressBarDialog(QFuture<void> & future, QString label, QWidget * parent = 0, Qt::WindowFlags f = 0);
+    explicit ProgressBarDialog(QString label, QWidget * parent = 0, Qt::WindowFlags f = 0);
     void wait();
 signals:
-    
+    void cancelled();
 public slots:
-    
+    void setProgress(qint64 done, qint64 total);
+    void setText(QString text) { ui.operationLabel->setText(text); }
 };
 
 #endif // PROGRESSBARDIALOG_H
@@ -0,0 +1,127 @@
+//
+//   SincReconstructor.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "SincReconstructor.h"
+#include <math.h>
+
+/**
+ * @brief SincReconstructor::SincReconstructor precomputes Lanczos windowed sinc
+ * for every phase. Each phase is normalized to unity gain so flat signal stays flat.
+ */
+SincReconstructor::SincReconstructor()
+{
+    const double halfTaps = TAPS/2;
+    for(int phase = 0; phase <= PHASES; ++phase)
+    {
+        double fraction = (double)phase/PHASES;
+        double sum = 0;
+        for(int tap = 0; tap < TAPS; ++tap)
+        {
+            // distance of tap from interpolated position
+            double x = (tap-(halfTaps-1))-fraction;
+            double value = 1;
+            if(x != 0)
+            {
+                double pix = M_PI*x;
+                value = (sin(pix)/pix)*(sin(pix/halfTaps)/(pix/halfTaps));
+            }
+            if(fabs(x) >= halfTaps)
+                value = 0;
+            table[phase][tap] = value;
+            sum += value;
+        }
+        for(int tap = 0; tap < TAPS; ++tap)
+        {
+            table[phase][tap] = table[phase][tap]/sum;
+        }
+    }
+}
+
+/**
+ * @brief SincReconstructor::instance
+ * @return returns shared reconstructor, table is computed once on first use.
+ */
+const SincReconstructor & SincReconstructor::instance()
+{
+    static SincReconstructor reconstructor;
+    return reconstructor;
+}
+
+/**
+ * @brief SincReconstructor::reconstruct computes count interpolated values.
+ * Samples outside of data are replaced by nearest sample.
+ * @param samples data to interpolate.
+ * @param length number of samples in data.
+ * @param firstPosition position (in samples) of first interpolated value.
+ * @param step distance (in samples) between interpolated values.
+ * @param count number of values to compute.
+ * @param result array of at least count values.
+ */
+void SincReconstructor::reconstruct(const unsigned char * samples, size_t length, double firstPosition, double step, int count, float * result) const
+{
+    if(length == 0)
+        return;
+    float window[TAPS];
+    for(int i = 0; i < count; ++i)
+    {
+        double position = firstPosition+i*step;
+        long base = static_cast<long>(floor(position));
+        int phase = static_cast<int>((position-base)*PHASES+0.5);
+        long first = base-(TAPS/2-1);
+        if(first >= 0 and first+TAPS <= static_cast<long>(length))
+        {
+            const unsigned char * source = samples+first;
+            for(int tap = 0; tap < TAPS; ++tap)
+            { // plain loop so that compiler can vectorize conversion
+                window[tap] = source[tap];
+            }
+        }
+        else
+        {
+            for(int tap = 0; tap < TAPS; ++tap)
+            {
+                long index = first+tap;
+                if(index < 0)
+                    index = 0;
+                if(index >= static_cast<long>(length))
+                    index = length-1;
+                window[tap] = samples[index];
+            }
+        }
+        const float * coefficients = table[phase];
+        float value = 0;
+        for(int tap = 0; tap < TAPS; ++tap)
+        {
+            value += window[tap]*coefficients[tap];
+        }
+        result[i] = value;
+    }
+}
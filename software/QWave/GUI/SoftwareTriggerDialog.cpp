@@ -0,0 +1,147 @@
+//
+//   SoftwareTriggerDialog.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "SoftwareTriggerDialog.h"
+#include "ui_SoftwareTriggerDialog.h"
+#include <QMessageBox>
+#include <QStringList>
+
+#define WRONG_PATTERN "Failed to parse patterns, use comma separated strings of 0, 1 and X"
+
+SoftwareTriggerDialog::SoftwareTriggerDialog(QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::SoftwareTriggerDialog)
+{
+    ui->setupUi(this);
+    connect(ui->conditionCombo, SIGNAL(currentIndexChanged(int)), this, SLOT(conditionChanged(int)));
+}
+
+SoftwareTriggerDialog::~SoftwareTriggerDialog()
+{
+    delete ui;
+}
+
+/**
+ * @brief SoftwareTriggerDialog::conditionChanged enables only inputs used by selected condition.
+ * @param condition
+ */
+void SoftwareTriggerDialog::conditionChanged(int condition)
+{
+    bool levels = condition != SoftwareTrigger::Pattern;
+    bool bands = condition == SoftwareTrigger::Runt or condition == SoftwareTrigger::Window;
+    ui->sourceCombo->setEnabled(levels);
+    ui->bitSpinBox->setEnabled(levels);
+    ui->polarityCombo->setEnabled(levels);
+    ui->levelSpinBox->setEnabled(levels);
+    ui->secondLevelSpinBox->setEnabled(levels);
+    ui->levelLabel->setText(bands ? "Low level:" : "Level:");
+    ui->secondLevelLabel->setText(bands ? "High level:" : "Hysteresis:");
+    ui->comparisonCombo->setEnabled(condition == SoftwareTrigger::PulseWidth);
+    ui->widthSpinBox->setEnabled(condition == SoftwareTrigger::PulseWidth);
+    ui->patternEdit->setEnabled(condition == SoftwareTrigger::Pattern);
+}
+
+/**
+ * @brief SoftwareTriggerDialog::setupTrigger this function presents dialog and when users
+ * clicks OK it sets up software trigger.
+ * @param trigger
+ */
+void SoftwareTriggerDialog::setupTrigger(SoftwareTrigger* trigger)
+{
+    ui->enabledCheck->setChecked(trigger->isEnabled());
+    ui->conditionCombo->setCurrentIndex(trigger->getCondition());
+    ui->sourceCombo->setCurrentIndex(trigger->getSource());
+    ui->bitSpinBox->setValue(trigger->getDigitalBit());
+    ui->polarityCombo->setCurrentIndex(trigger->isPositive() ? 0 : 1);
+    ui->levelSpinBox->setValue(trigger->getLevel());
+    ui->secondLevelSpinBox->setValue(trigger->getSecondLevel());
+    ui->comparisonCombo->setCurrentIndex(trigger->isLessThan() ? 0 : 1);
+    ui->widthSpinBox->setValue(trigger->getWidth());
+    ui->preTriggerSpinBox->setValue(trigger->getPreTrigger());
+    QStringList patternTexts;
+    QVector<QPair<uint16_t, uint16_t> > patterns = trigger->getPatterns();
+    for(int i = 0; i < patterns.count(); ++i)
+    {
+        patternTexts << SoftwareTrigger::patternToString(patterns[i].first, patterns[i].second);
+    }
+    ui->patternEdit->setText(patternTexts.join(", "));
+    conditionChanged(trigger->getCondition());
+
+    int result = this->exec();
+    if(result == QDialog::Accepted)
+    {
+        int source = ui->sourceCombo->currentIndex();
+        bool positive = ui->polarityCombo->currentIndex() == 0;
+        uint8_t level = ui->levelSpinBox->value();
+        uint8_t secondLevel = ui->secondLevelSpinBox->value();
+        switch(ui->conditionCombo->currentIndex())
+        {
+        case SoftwareTrigger::Edge:
+            trigger->setEdge(source, positive, level, secondLevel);
+            break;
+        case SoftwareTrigger::PulseWidth:
+            trigger->setPulseWidth(source, positive, level, secondLevel, ui->comparisonCombo->currentIndex() == 0, ui->widthSpinBox->value());
+            break;
+        case SoftwareTrigger::Runt:
+            trigger->setRunt(source, positive, level, secondLevel);
+            break;
+        case SoftwareTrigger::Window:
+            trigger->setWindow(source, positive, level, secondLevel);
+            break;
+        case SoftwareTrigger::Pattern:
+        {
+            patterns.clear();
+            QStringList texts = ui->patternEdit->text().split(',', QString::SkipEmptyParts);
+            for(int i = 0; i < texts.count(); ++i)
+            {
+                uint16_t mask;
+                uint16_t value;
+                if(not SoftwareTrigger::parsePattern(texts[i], mask, value))
+                {
+                    QMessageBox::warning(this, "Data error", WRONG_PATTERN);
+                    return;
+                }
+                patterns.append(QPair<uint16_t, uint16_t>(mask, value));
+            }
+            if(patterns.isEmpty())
+            {
+                QMessageBox::warning(this, "Data error", WRONG_PATTERN);
+                return;
+            }
+            trigger->setPattern(patterns);
+            break;
+        }
+        }
+        trigger->setDigitalBit(ui->bitSpinBox->value());
+        trigger->setPreTrigger(ui->preTriggerSpinBox->value());
+        trigger->setEnabled(ui->enabledCheck->isChecked());
+    }
+}
@@ -0,0 +1,59 @@
+//
+//   SoftwareTriggerDialog.h
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef SOFTWARETRIGGERDIALOG_H
+#define SOFTWARETRIGGERDIALOG_H
+
+#include <QDialog>
+#include "../Device/SoftwareTrigger.h"
+
+namespace Ui {
+class SoftwareTriggerDialog;
+}
+
+/**
+ * @brief The SoftwareTriggerDialog class represents dialog which is used to setup host side software trigger.
+ */
+class SoftwareTriggerDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit SoftwareTriggerDialog(QWidget *parent = 0);
+    ~SoftwareTriggerDialog();
+    void setupTrigger(SoftwareTrigger* trigger);
+private slots:
+    void conditionChanged(int condition);
+private:
+    Ui::SoftwareTriggerDialog *ui;
+};
+
+#endif // SOFTWARETRIGGERDIALOG_H
@@ -0,0 +1,111 @@
+//
+//   SpectrumPlot.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <QPainter>
+#include "SpectrumPlot.h"
+#include "../Datamodel/Constants.h"
+
+/**
+ * @brief SpectrumPlot::SpectrumPlot
+ * @param analyzer analyzer owned by this plot, it's source data are used as plot data.
+ * @param name
+ */
+SpectrumPlot::SpectrumPlot(SpectrumAnalyzer * analyzer, QString name) :
+    Plot(analyzer->getSource(), name), analyzer(analyzer), paintedVersion(0)
+{
+}
+
+SpectrumPlot::~SpectrumPlot()
+{
+    delete(analyzer);
+}
+
+/**
+ * @brief SpectrumPlot::getFrequencyText
+ * @param frequency in Hz.
+ * @return returns frequency formatted with appropriate unit.
+ */
+QString SpectrumPlot::getFrequencyText(double frequency)
+{
+    if(frequency >= E6)
+        return QString::number(frequency/E6, 'f', 2)+" "+MHZ;
+    if(frequency >= E3)
+        return QString::number(frequency/E3, 'f', 2)+" "+KHZ;
+    return QString::number(frequency, 'f', 2)+" "+HERTZ;
+}
+
+/**
+ * @brief SpectrumPlot::paint paints spectrum in dB, when there are more bins than pixels
+ * maximum of bins falling into pixel column is painted so narrow peaks are not lost.
+ * @param painter
+ * @param startCoordY
+ * @param width
+ * @param fromTime not used, spectrum is not time based.
+ * @param divSize not used.
+ */
+void SpectrumPlot::paint(QPainter * painter, int startCoordY, int width, uint64_t fromTime, double divSize)
+{
+    Q_UNUSED(fromTime);
+    Q_UNUSED(divSize);
+    paintedVersion = analyzer->getVersion();
+    const QVector<float> & spectrum = analyzer->getSpectrum();
+    int height = getHeight();
+    painter->setPen(QColor(60, 60, 90));
+    for(double db = SPECTRUM_TOP_DB; db >= SPECTRUM_TOP_DB-SPECTRUM_RANGE_DB; db -= SPECTRUM_GRID_DB)
+    {
+        int y = startCoordY+static_cast<int>((SPECTRUM_TOP_DB-db)*height/SPECTRUM_RANGE_DB);
+        painter->drawLine(0, y, width, y);
+        painter->drawText(2, y, DATASTRING_WIDTH, DATASTRING_HEIGHT, 0, QString::number(db)+" dB");
+    }
+    if(spectrum.size() < 2 or width <= 0)
+        return;
+    painter->drawText(width-2*DATASTRING_WIDTH, startCoordY, 2*DATASTRING_WIDTH, DATASTRING_HEIGHT, Qt::AlignRight,
+                      getFrequencyText(analyzer->getBinWidth()*(spectrum.size()-1)));
+    painter->setPen(QColor(255, 200, 0));
+    double binsPerPixel = static_cast<double>(spectrum.size())/width;
+    QPolygon line;
+    for(int x = 0; x < width; ++x)
+    {
+        int first = static_cast<int>(x*binsPerPixel);
+        int last = qMax(first+1, static_cast<int>((x+1)*binsPerPixel));
+        if(first >= spectrum.size())
+            break;
+        last = qMin(last, spectrum.size());
+        float db = spectrum.at(first);
+        for(int i = first+1; i < last; ++i)
+        {
+            db = qMax(db, spectrum.at(i));
+        }
+        double clamped = qBound(SPECTRUM_TOP_DB-SPECTRUM_RANGE_DB, static_cast<double>(db), SPECTRUM_TOP_DB);
+        line << QPoint(x, startCoordY+static_cast<int>((SPECTRUM_TOP_DB-clamped)*height/SPECTRUM_RANGE_DB));
+    }
+    painter->drawPolyline(line);
+}
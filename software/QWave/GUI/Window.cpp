@@ -38,8 +38,12 @@
 #include <QtConcurrentRun>
 #include "../Exceptions/IOException.h"
 #include "ProgressBarDialog.h"
+#include "../Instrumentation/Profiler.h"
+#include "../Datamodel/MemoryManager.h"
+#include <QInputDialog>
+#include <climits>
 
-Window::Window() : currentMeasurementId(0)
+Window::Window() : currentMeasurementId(0), measurementMode(PlotCanvas::NoMeasurements)
 {   
     createMenuActions();
     createMenus();
@@ -64,6 +68,8 @@ Window::~Window()
     delete(fileMenu);
     //delete(editMenu);
     delete(measurementMenu);
+    delete(searchMenu);
+    delete(viewMenu);
     delete(helpMenu);
     //submenu items for file
     delete(newTabAction);
@@ -74,6 +80,21 @@ Window::~Window()
     delete(quitAction);
     //submenu items for measurement
     delete(addMeasurementAction);
+    delete(measurementsOffAction);
+    delete(measurementsVisibleAction);
+    delete(measurementsWholeAction);
+    delete(measurementModeGroup);
+    //submenu items for search
+    delete(findPatternAction);
+    delete(findNextAction);
+    delete(findPreviousAction);
+    delete(compareAction);
+    delete(nextDifferenceAction);
+    delete(previousDifferenceAction);
+    delete(listDifferencesAction);
+    delete(profilerOverlayAction);
+    delete(dumpProfilerAction);
+    delete(memoryBudgetAction);
     //delete(removeMeasurementAction);
     //delete(chooseMeasurementsAction);
     //submenu items for edit
@@ -130,6 +151,23 @@ void Window::createMenuActions()
     addMeasurementAction->setShortcut(tr("Ctrl+M"));
     addMeasurementAction->setStatusTip(tr("Add plot of signal from selected probe"));
     connect(addMeasurementAction, SIGNAL(triggered()), this, SLOT(addMeasurement()));
+    //automatic measurements actions
+    measurementModeGroup = new QActionGroup(this);
+    measurementsOffAction = new QAction(tr("&Off"), measurementModeGroup);
+    measurementsOffAction->setData(PlotCanvas::NoMeasurements);
+    measurementsVisibleAction = new QAction(tr("&Visible range"), measurementModeGroup);
+    measurementsVisibleAction->setData(PlotCanvas::VisibleMeasurements);
+    measurementsVisibleAction->setStatusTip(tr("Measure selected plots over visible range"));
+    measurementsWholeAction = new QAction(tr("&Whole capture"), measurementModeGroup);
+    measurementsWholeAction->setData(PlotCanvas::WholeMeasurements);
+    measurementsWholeAction->setStatusTip(tr("Measure selected plots over all captured data"));
+    QList<QAction*> measurementModeActions = measurementModeGroup->actions();
+    for(int i = 0; i < measurementModeActions.count(); ++i)
+    {
+        measurementModeActions[i]->setCheckable(true);
+    }
+    measurementsOffAction->setChecked(true);
+    connect(measurementModeGroup, SIGNAL(triggered(QAction*)), this, SLOT(setMeasurementMode(QAction*)));
     //removeMeasurementAction initialization
     //removeMeasurementAction = new QAction(tr("&Remove measurement plot"), this);
     //removeMeasurementAction->setShortcut(tr("Ctrl+K"));
@@ -140,6 +178,33 @@ void Window::createMenuActions()
     //chooseMeasurementsAction->setShortcut(tr("Ctrl+K"));
     //chooseMeasurementsAction->setStatusTip(tr("Choose probes which signal is displayed in plot"));
     //connect(addMeasurementAction, SIGNAL(triggered()), this, SLOT(chooseMeasurements()));
+    //search menu actions
+    findPatternAction = new QAction(tr("&Find pattern..."), this);
+    findPatternAction->setShortcut(tr("Ctrl+F"));
+    findPatternAction->setStatusTip(tr("Find samples of selected logic plot matching pattern"));
+    connect(findPatternAction, SIGNAL(triggered()), this, SLOT(findPattern()));
+    findNextAction = new QAction(tr("Find &next"), this);
+    findNextAction->setShortcut(tr("F3"));
+    findNextAction->setStatusTip(tr("Move to next match"));
+    connect(findNextAction, SIGNAL(triggered()), this, SLOT(findNext()));
+    findPreviousAction = new QAction(tr("Find &previous"), this);
+    findPreviousAction->setShortcut(tr("Shift+F3"));
+    findPreviousAction->setStatusTip(tr("Move to previous match"));
+    connect(findPreviousAction, SIGNAL(triggered()), this, SLOT(findPrevious()));
+    compareAction = new QAction(tr("&Compare with..."), this);
+    compareAction->setStatusTip(tr("Compare signals of current tab with another capture"));
+    connect(compareAction, SIGNAL(triggered()), this, SLOT(compareCaptures()));
+    nextDifferenceAction = new QAction(tr("Next &difference"), this);
+    nextDifferenceAction->setShortcut(tr("F4"));
+    nextDifferenceAction->setStatusTip(tr("Move to next difference from reference capture"));
+    connect(nextDifferenceAction, SIGNAL(triggered()), this, SLOT(findNextDifference()));
+    previousDifferenceAction = new QAction(tr("Previous d&ifference"), this);
+    previousDifferenceAction->setShortcut(tr("Shift+F4"));
+    previousDifferenceAction->setStatusTip(tr("Move to previous difference from reference capture"));
+    connect(previousDifferenceAction, SIGNAL(triggered()), this, SLOT(findPreviousDifference()));
+    listDifferencesAction = new QAction(tr("&List differences..."), this);
+    listDifferencesAction->setStatusTip(tr("List signals which differ from reference capture"));
+    connect(listDifferencesAction, SIGNAL(triggered()), this, SLOT(listDifferences()));
     connectDeviceAction = new QAction(tr("&Connect device..."), this);
     connectDeviceAction->setShortcut(tr("Ctrl+L"));
     connectDeviceAction->setStatusTip(tr("Connect and initialize capture device"));
@@ -155,6 +220,17 @@ void Window::createMenuActions()
     measurementPreferencesAction->setShortcut(tr("Ctrl+J"));
     measurementPreferencesAction->setStatusTip(tr("Preferences of measurement plot"));
     connect(measurementPreferencesAction, SIGNAL(triggered()), this, SLOT(measurementPreferences()));
+    //view menu actions
+    profilerOverlayAction = new QAction(tr("&Profiling overlay"), this);
+    profilerOverlayAction->setCheckable(true);
+    profilerOverlayAction->setStatusTip(tr("Measure capture and paint times and show them over plots"));
+    connect(profilerOverlayAction, SIGNAL(toggled(bool)), this, SLOT(toggleProfiler(bool)));
+    dumpProfilerAction = new QAction(tr("&Dump profiling statistics.."), this);
+    dumpProfilerAction->setStatusTip(tr("Save collected capture and paint times to file"));
+    connect(dumpProfilerAction, SIGNAL(triggered()), this, SLOT(dumpProfiler()));
+    memoryBudgetAction = new QAction(tr("&Memory budget.."), this);
+    memoryBudgetAction->setStatusTip(tr("Set memory for samples, older samples are moved to disk"));
+    connect(memoryBudgetAction, SIGNAL(triggered()), this, SLOT(setMemoryBudget()));
     //help menu actions
     aboutAction = new QAction(tr("&About"), this);
     aboutAction->setStatusTip(tr("About this application"));
@@ -184,10 +260,25 @@ void Window::createMenus()
     //measurement menu initialization
     measurementMenu = menuBar()->addMenu(tr("&Measurement"));
     measurementMenu->addAction(addMeasurementAction);
+    automaticMeasurementsMenu = measurementMenu->addMenu(tr("&Automatic measurements"));
+    automaticMeasurementsMenu->addActions(measurementModeGroup->actions());
     //measurementMenu->addAction(removeMeasurementAction);
+    searchMenu = menuBar()->addMenu(tr("&Search"));
+    searchMenu->addAction(findPatternAction);
+    searchMenu->addAction(findNextAction);
+    searchMenu->addAction(findPreviousAction);
+    searchMenu->addSeparator();
+    searchMenu->addAction(compareAction);
+    searchMenu->addAction(nextDifferenceAction);
+    searchMenu->addAction(previousDifferenceAction);
+    searchMenu->addAction(listDifferencesAction);
     deviceMenu = menuBar()->addMenu(tr("&Device"));
     deviceMenu->addAction(connectDeviceAction);
     //measurementMenu->addAction(chooseMeasurementsAction);
+    viewMenu = menuBar()->addMenu(tr("&View"));
+    viewMenu->addAction(profilerOverlayAction);
+    viewMenu->addAction(dumpProfilerAction);
+    viewMenu->addAction(memoryBudgetAction);
     //Help menu initializations
     helpMenu = menuBar()->addMenu(tr("&Help"));
     //helpMenu->addAction(helpAction);
@@ -228,6 +319,7 @@ void Window::newTab()
     Board * board = new Board(tabLabel, tabBar);
     tabBar->addTab(board, tabLabel);
     board->connectWindow(this);
+    board->getPlotCanvas()->setMeasurementMode(measurementMode);
     board->initHierarchy();
 }
 
@@ -241,29 +333,15 @@ void Window::openFile()
     QString name;
     int index = tabBar->currentIndex();
     for(int i = 0; i < files.size(); ++i)
-    {
-        try
-        {
-            QFile * file = new QFile(files.at(i));
-            QFileInfo fi(files.at(i));
-            name = fi.fileName();
-            name = name.split('.').at(0);
-            Board * newBoard = new Board(name, tabBar);
-            QFuture<void> future = QtConcurrent::run(newBoard, &Board::loadFromFile, file);
-            ProgressBarDialog dialog(future, "Loading "+name, this);
-            dialog.wait();
-            index = tabBar->addTab(newBoard, name);
-            newBoard->connectWindow(this);
-            delete(file);
-            setStatusBarText("Measurement/simulation "+name+" opened sucessfully.");
-        }
-        catch (IOException e)
-        {
-            QMessageBox::critical(this, "File error",
-                                  e.getMessage());
-            setStatusBarText("Measurement/simulation "+name+" could not be opened.");
-        }
-        
+    { // boards load in background and show signals as they are read
+        QFileInfo fi(files.at(i));
+        name = fi.fileName();
+        name = name.split('.').at(0);
+        Board * newBoard = new Board(name, tabBar);
+        newBoard->getPlotCanvas()->setMeasurementMode(measurementMode);
+        index = tabBar->addTab(newBoard, name);
+        newBoard->connectWindow(this);
+        newBoard->loadFromFile(files.at(i));
     }
     tabBar->setCurrentIndex(index);
 }
@@ -273,6 +351,11 @@ void Window::openFile()
  */
 void Window::saveFile()
 {
+    if(static_cast<Board*>(tabBar->currentWidget())->isLoading())
+    {
+        QMessageBox::warning(this, "File busy", "Measurement is still loading.");
+        return;
+    }
     if("" == ((static_cast<Board*>(tabBar->currentWidget()))->getFilePath()))
     {
         saveAsFile();
@@ -300,6 +383,11 @@ void Window::saveFile()
  */
 void Window::saveAsFile()
 {
+    if(static_cast<Board*>(tabBar->currentWidget())->isLoading())
+    {
+        QMessageBox::warning(this, "File busy", "Measurement is still loading.");
+        return;
+    }
     QString file = QFileDialog::getSaveFileName();
     try
     {
@@ -317,6 +405,69 @@ void Window::saveAsFile()
     }
 }
 
+/**
+ * @brief Window::setMeasurementMode sets automatic measurements shown in all boards.
+ * @param action chosen action, holding measurement mode in it's data.
+ */
+void Window::setMeasurementMode(QAction* action)
+{
+    measurementMode = action->data().toInt();
+    for(int i = 0; i < tabBar->count(); ++i)
+    {
+        static_cast<Board*>(tabBar->widget(i))->getPlotCanvas()->setMeasurementMode(measurementMode);
+    }
+}
+
+/**
+ * @brief Window::toggleProfiler starts or stops collection of profiling statistics and shows overlay.
+ * @param enabled
+ */
+void Window::toggleProfiler(bool enabled)
+{
+    Profiler::instance().setEnabled(enabled);
+    if(tabBar->currentWidget() != NULL)
+        static_cast<Board*>(tabBar->currentWidget())->getPlotCanvas()->update();
+}
+
+/**
+ * @brief Window::dumpProfiler saves collected profiling statistics to selected file.
+ */
+void Window::dumpProfiler()
+{
+    QString file = QFileDialog::getSaveFileName(this, tr("Dump profiling statistics"), QDir::currentPath());
+    if(file == "")
+        return;
+    try
+    {
+        QFile qfile(file);
+        Profiler::instance().dumpToFile(&qfile);
+        setStatusBarText("Profiling statistics saved to "+file);
+    }
+    catch (IOException e)
+    {
+        QMessageBox::critical(this, "File error",
+                              e.getMessage());
+    }
+}
+
+/**
+ * @brief Window::setMemoryBudget asks for memory budget of samples and enforces it.
+ */
+void Window::setMemoryBudget()
+{
+    MemoryManager & manager = MemoryManager::instance();
+    bool ok;
+    int megabytes = QInputDialog::getInt(this, tr("Memory budget"),
+                                         tr("Memory for samples in MiB (0 for unlimited):"),
+                                         int(manager.getBudget() >> 20), 0, INT_MAX, 64, &ok);
+    if(not ok)
+        return;
+    manager.setBudget(size_t(megabytes) << 20);
+    manager.enforce();
+    setStatusBarText(QString("Samples use %1 MiB, %2 MiB moved to disk.")
+                     .arg(manager.getUsedBytes() >> 20).arg(manager.getSpilledBytes() >> 20));
+}
+
 void Window::preferences()
 {
     
@@ -343,10 +494,37 @@ void Window::removeMeasurement()
  * @param index
  */
 void Window::closeTab(int index)
+{
+    delete(takeTab(index));
+}
+
+/**
+ * @brief Window::closeBoard closes tab of board, board is deleted later,
+ * because it may be closed from its own slot.
+ * @param board
+ */
+void Window::closeBoard(Board * board)
+{
+    int index = tabBar->indexOf(board);
+    if(index < 0)
+        return;
+    takeTab(index)->deleteLater();
+}
+
+/**
+ * @brief Window::takeTab removes tab without deleting its board.
+ * @param index
+ * @return returns removed board.
+ */
+Board * Window::takeTab(int index)
 {
     Board *  boardRemoved = static_cast<Board*>(tabBar->widget(index));
     tabBar->removeTab(index);
-    delete(boardRemoved);
+    for(int i = 0; i < tabBar->count(); ++i)
+    { // other boards may compare with data of removed board
+        static_cast<Board*>(tabBar->widget(i))->clearComparison();
+    }
+    return boardRemoved;
 }
 
 void Window::handleDisconnectedDeice()
@@ -394,6 +572,79 @@ void Window::connectDevice()
     static_cast<Board*>(tabBar->currentWidget())->connectDevice();
 }
 
+/**
+ * @brief Window::findPattern triggers pattern search in current Board.
+ */
+void Window::findPattern()
+{
+    if(tabBar->currentWidget() != NULL)
+        static_cast<Board*>(tabBar->currentWidget())->findPattern();
+}
+
+/**
+ * @brief Window::findNext moves current Board to next match.
+ */
+void Window::findNext()
+{
+    if(tabBar->currentWidget() != NULL)
+        static_cast<Board*>(tabBar->currentWidget())->findNext();
+}
+
+/**
+ * @brief Window::findPrevious moves current Board to previous match.
+ */
+void Window::findPrevious()
+{
+    if(tabBar->currentWidget() != NULL)
+        static_cast<Board*>(tabBar->currentWidget())->findPrevious();
+}
+
+/**
+ * @brief Window::compareCaptures compares current Board with one of other open Boards.
+ */
+void Window::compareCaptures()
+{
+    if(tabBar->currentWidget() == NULL)
+        return;
+    QStringList captures;
+    QVector<Board*> boards;
+    for(int i = 0; i < tabBar->count(); ++i)
+    {
+        if(i == tabBar->currentIndex())
+            continue;
+        captures << tabBar->tabText(i);
+        boards.append(static_cast<Board*>(tabBar->widget(i)));
+    }
+    static_cast<Board*>(tabBar->currentWidget())->compare(captures, boards);
+}
+
+/**
+ * @brief Window::findNextDifference moves current Board to next difference from reference capture.
+ */
+void Window::findNextDifference()
+{
+    if(tabBar->currentWidget() != NULL)
+        static_cast<Board*>(tabBar->currentWidget())->findNextDifference();
+}
+
+/**
+ * @brief Window::findPreviousDifference moves current Board to previous difference from reference capture.
+ */
+void Window::findPreviousDifference()
+{
+    if(tabBar->currentWidget() != NULL)
+        static_cast<Board*>(tabBar->currentWidget())->findPreviousDifference();
+}
+
+/**
+ * @brief Window::listDifferences lists signals of current Board which differ from reference capture.
+ */
+void Window::listDifferences()
+{
+    if(tabBar->currentWidget() != NULL)
+        static_cast<Board*>(tabBar->currentWidget())->listDifferences();
+}
+
 /**
  * @brief Window::setStatusBarText sets status bar text of window.
  * @param text
@@ -39,6 +39,7 @@
 #include <QPushButton>
 #include <QMenu>
 #include <QMenuBar>
+#include <QActionGroup>
 #include <QTabWidget>
 #include <QWidget>
 #include <QGridLayout>
@@ -63,6 +64,8 @@ private:
     QMenu * fileMenu;
     QMenu * deviceMenu;
     QMenu * measurementMenu;
+    QMenu * searchMenu;
+    QMenu * viewMenu;
     QMenu * helpMenu;
     //submenu items for file
     QAction * newTabAction;
@@ -75,11 +78,29 @@ private:
     QAction * addMeasurementAction;
     //QAction * removeMeasurementAction;
     QAction * chooseMeasurementsAction;
+    QMenu * automaticMeasurementsMenu;
+    QActionGroup * measurementModeGroup;
+    QAction * measurementsOffAction;
+    QAction * measurementsVisibleAction;
+    QAction * measurementsWholeAction;
+    int measurementMode;
+    //search menu
+    QAction * findPatternAction;
+    QAction * findNextAction;
+    QAction * findPreviousAction;
+    QAction * compareAction;
+    QAction * nextDifferenceAction;
+    QAction * previousDifferenceAction;
+    QAction * listDifferencesAction;
     //submenu items for edit
     QAction * preferencesAction;
     QAction * measurementPreferencesAction;
     //
     QAction * connectDeviceAction;
+    //submenu items for view
+    QAction * profilerOverlayAction;
+    QAction * dumpProfilerAction;
+    QAction * memoryBudgetAction;
     //submenu items for help menu
     QAction * aboutAction;
     QAction * helpAction;
@@ -98,6 +119,7 @@ private:
     QString getDefaultTabLabel();
     QFrame * newHorizontalSeparator();
     QLabel * newLabel(QString & label);
+    Board * takeTab(int index);
     //slots for actions
 private slots:
     void newTab();
@@ -113,11 +135,23 @@ private slots:
     void chooseMeasurements();
     void closeTab(int index);
     void connectDevice();
+    void toggleProfiler(bool enabled);
+    void dumpProfiler();
+    void setMemoryBudget();
+    void setMeasurementMode(QAction* action);
+    void findPattern();
+    void findNext();
+    void findPrevious();
+    void compareCaptures();
+    void findNextDifference();
+    void findPreviousDifference();
+    void listDifferences();
     
 public slots:
     void handleDisconnectedDeice();
     void handleConnectedDevice();
     void setStatusBarText(QString);
+    void closeBoard(Board * board);
     
 signals:
     void deviceDiscoveryInvoked();
@@ -0,0 +1,232 @@
+//
+//   Profiler.cpp
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Profiler.h"
+#include "../Exceptions/IOException.h"
+#include <QFileInfo>
+#include <QTextStream>
+#include <QMutexLocker>
+
+Profiler::Profiler() : enabled(false), frameIndex(0), frameCount(0)
+{
+    clock.start();
+    reset();
+}
+
+/**
+ * @brief Profiler::instance
+ * @return returns application wide profiler.
+ */
+Profiler & Profiler::instance()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+/**
+ * @brief Profiler::setEnabled starts or stops collection, statistics are cleared on start.
+ * @param enabled
+ */
+void Profiler::setEnabled(bool enabled)
+{
+    if(enabled and not this->enabled)
+        reset();
+    this->enabled = enabled;
+}
+
+/**
+ * @brief Profiler::reset clears all collected statistics.
+ */
+void Profiler::reset()
+{
+    QMutexLocker locker(&mutex);
+    for(int i = 0; i < STAGE_COUNT; ++i)
+    {
+        stats[i].count = 0;
+        stats[i].total = 0;
+        stats[i].min = 0;
+        stats[i].max = 0;
+        stats[i].last = 0;
+        for(int ii = 0; ii < HISTOGRAM_BUCKETS; ++ii)
+        {
+            stats[i].histogram[ii] = 0;
+        }
+    }
+    frameIndex = 0;
+    frameCount = 0;
+}
+
+/**
+ * @brief Profiler::record adds one measured duration to stage. Thread safe, as capture
+ * stages are measured in device threads.
+ * @param stage
+ * @param nsecs
+ */
+void Profiler::record(int stage, qint64 nsecs)
+{
+    if(not enabled or stage < 0 or stage >= STAGE_COUNT)
+        return;
+    int bucket = 0;
+    for(qint64 usecs = nsecs/1000; usecs > 0 and bucket < HISTOGRAM_BUCKETS-1; usecs >>= 1)
+    {
+        ++bucket;
+    }
+    QMutexLocker locker(&mutex);
+    StageStats & s = stats[stage];
+    if(s.count == 0 or nsecs < s.min)
+        s.min = nsecs;
+    if(nsecs > s.max)
+        s.max = nsecs;
+    s.last = nsecs;
+    s.total += nsecs;
+    ++s.count;
+    ++s.histogram[bucket];
+}
+
+/**
+ * @brief Profiler::frameFinished marks that canvas finished painting one frame.
+ */
+void Profiler::frameFinished()
+{
+    if(not enabled)
+        return;
+    QMutexLocker locker(&mutex);
+    frameTimes[frameIndex] = clock.nsecsElapsed();
+    frameIndex = (frameIndex+1)%FPS_FRAMES;
+    if(frameCount < FPS_FRAMES)
+        ++frameCount;
+}
+
+/**
+ * @brief Profiler::getFps
+ * @return returns frames per second averaged over last FPS_FRAMES frames.
+ */
+double Profiler::getFps()
+{
+    QMutexLocker locker(&mutex);
+    if(frameCount < 2)
+        return 0;
+    qint64 newest = frameTimes[(frameIndex+FPS_FRAMES-1)%FPS_FRAMES];
+    qint64 oldest = frameTimes[(frameIndex+FPS_FRAMES-frameCount)%FPS_FRAMES];
+    if(newest == oldest)
+        return 0;
+    return (frameCount-1)*1e9/(newest-oldest);
+}
+
+/**
+ * @brief Profiler::getStageName
+ * @param stage
+ * @return returns human readable name of stage.
+ */
+QString Profiler::getStageName(int stage)
+{
+    switch(stage)
+    {
+    case UsbRead:
+        return "USB read";
+    case Demux:
+        return "Demux";
+    case ModelAppend:
+        return "Model append";
+    case TriggerScan:
+        return "Trigger scan";
+    case Statistics:
+        return "Statistics";
+    case MaskTest:
+        return "Mask test";
+    case Decode:
+        return "Decode";
+    case PaintPlot:
+        return "Paint plot";
+    case Composite:
+        return "Composite";
+    case Spill:
+        return "Spill";
+    default:
+        return "Unknown";
+    }
+}
+
+/**
+ * @brief Profiler::getSummary
+ * @return returns one line per stage with last, average and maximal time, used by overlay.
+ */
+QStringList Profiler::getSummary()
+{
+    QStringList lines;
+    lines << QString("FPS: %1").arg(getFps(), 0, 'f', 1);
+    QMutexLocker locker(&mutex);
+    for(int i = 0; i < STAGE_COUNT; ++i)
+    {
+        const StageStats & s = stats[i];
+        double average = s.count > 0 ? (double)s.total/s.count : 0;
+        lines << QString("%1: last %2 us avg %3 us max %4 us")
+                 .arg(getStageName(i))
+                 .arg(s.last/1000.0, 0, 'f', 1)
+                 .arg(average/1000.0, 0, 'f', 1)
+                 .arg(s.max/1000.0, 0, 'f', 1);
+    }
+    return lines;
+}
+
+/**
+ * @brief Profiler::dumpToFile writes statistics and histograms of all stages to file.
+ * @param file
+ */
+void Profiler::dumpToFile(QFile * file)
+{
+    if(!file->open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+        QFileInfo fi(file->fileName());
+        throw IOException("Could not open file: "+fi.fileName());
+    }
+    QTextStream out(file);
+    out << "fps " << getFps() << endl;
+    QMutexLocker locker(&mutex);
+    for(int i = 0; i < STAGE_COUNT; ++i)
+    {
+        const StageStats & s = stats[i];
+        out << "stage " << getStageName(i) << endl;
+        out << "count " << s.count << endl;
+        out << "total_ns " << s.total << endl;
+        out << "min_ns " << s.min << endl;
+        out << "max_ns " << s.max << endl;
+        out << "avg_ns " << (s.count > 0 ? s.total/(qint64)s.count : 0) << endl;
+        for(int ii = 0; ii < HISTOGRAM_BUCKETS; ++ii)
+        {
+            if(s.histogram[ii] == 0)
+                continue;
+            // bucket ii holds durations in [2^(ii-1), 2^ii) microseconds
+            out << "bucket_us " << (ii == 0 ? 0 : (1ULL << (ii-1))) << " " << s.histogram[ii] << endl;
+        }
+    }
+    file->close();
+}
@@ -0,0 +1,118 @@
+//
+//   Profiler.h
+//   QWave
+//   Copyright (c) 2012-2013, Bruno Kremel
+//   All rights reserved.
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions are met:
+//    1. Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//    2. Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//    3. All advertising materials mentioning features or use of this software
+//       must display the following acknowledgement:
+//       This product includes software developed by Bruno Kremel.
+//    4. Neither the name of Bruno Kremel nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY Bruno Kremel ''AS IS'' AND ANY
+//    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//    DISCLAIMED. IN NO EVENT SHALL Bruno Kremel BE LIABLE FOR ANY
+//    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef QWave_Profiler_h
+#define QWave_Profiler_h
+
+#include <QString>
+#include <QStringList>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QDebug>
+#include <inttypes.h>
+
+/**
+ * Debug output inside of hot loops (per sample, per repaint) is compiled out
+ * unless QWAVE_HOT_DEBUG is defined, so it does not disturb measurements.
+ */
+#ifdef QWAVE_HOT_DEBUG
+#define qHotDebug qDebug
+#else
+#define qHotDebug while(false) qDebug
+#endif
+
+static const int HISTOGRAM_BUCKETS = 32;
+static const int FPS_FRAMES = 32;
+
+/**
+ * @brief The Profiler class collects durations of capture and paint stages.
+ * Each stage keeps count, sum, min, max and histogram with power of two buckets
+ * in microseconds. Collection is off until enabled, so disabled timers cost one
+ * flag check.
+ */
+class Profiler
+{
+public:
+    enum Stage { UsbRead, Demux, ModelAppend, TriggerScan, Statistics, MaskTest, Decode, PaintPlot, Composite, Spill, STAGE_COUNT };
+    static Profiler & instance();
+    bool isEnabled() const { return enabled; }
+    void setEnabled(bool enabled);
+    void reset();
+    void record(int stage, qint64 nsecs);
+    void frameFinished();
+    double getFps();
+    QStringList getSummary();
+    void dumpToFile(QFile * file);
+    static QString getStageName(int stage);
+private:
+    struct StageStats
+    {
+        uint64_t count;
+        qint64 total;
+        qint64 min;
+        qint64 max;
+        qint64 last;
+        uint64_t histogram[HISTOGRAM_BUCKETS];
+    };
+    Profiler();
+    volatile bool enabled;
+    QMutex mutex;
+    StageStats stats[STAGE_COUNT];
+    QElapsedTimer clock;
+    qint64 frameTimes[FPS_FRAMES];
+    int frameIndex;
+    int frameCount;
+};
+
+/**
+ * @brief The ScopedTimer class measures time from construction to destruction
+ * and records it to given profiler stage.
+ */
+class ScopedTimer
+{
+    int stage;
+    bool running;
+    QElapsedTimer timer;
+public:
+    ScopedTimer(int stage) : stage(stage), running(Profiler::instance().isEnabled())
+    {
+        if(running)
+            timer.start();
+    }
+    ~ScopedTimer()
+    {
+        if(running)
+            Profiler::instance().record(stage, timer.nsecsElapsed());
+    }
+};
+
+#endif
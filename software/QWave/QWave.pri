@@ -0,0 +1,77 @@
+#-------------------------------------------------
+#
+# Sources shared by QWave application and tools built on top of it
+#
+#-------------------------------------------------
+
+include($$PWD/Core.pri)
+
+SOURCES += \
+    $$PWD/GUI/Window.cpp \
+    $$PWD/GUI/PlotTreeWidget.cpp \
+    $$PWD/GUI/PlotCanvas.cpp \
+    $$PWD/GUI/Plot.cpp \
+    $$PWD/GUI/SpectrumPlot.cpp \
+    $$PWD/GUI/HistogramPlot.cpp \
+    $$PWD/GUI/EyePlot.cpp \
+    $$PWD/GUI/CompareDialog.cpp \
+    $$PWD/GUI/MaskDialog.cpp \
+    $$PWD/GUI/SincReconstructor.cpp \
+    $$PWD/GUI/Board.cpp \
+    $$PWD/GUI/CommonKnobs/CommonKnobs.cpp \
+    $$PWD/GUI/CommonKnobs/TimeControl.cpp \
+    $$PWD/GUI/CommonKnobs/ScaleControl.cpp \
+    $$PWD/GUI/CommonKnobs/TimeSpinBox.cpp \
+    $$PWD/GUI/ProgressBarDialog.cpp \
+    $$PWD/GUI/ProbeAssignDialog.cpp \
+    $$PWD/GUI/TriggerSetupDialog.cpp \
+    $$PWD/GUI/SoftwareTriggerDialog.cpp \
+    $$PWD/GUI/DecoderDialog.cpp \
+    $$PWD/GUI/AnnotationPlot.cpp \
+    $$PWD/GUI/MathPlot.cpp \
+    $$PWD/GUI/KnobsWidget.cpp \
+    $$PWD/GUI/ConnectDevice.cpp \
+    $$PWD/MyApplication.cpp
+
+HEADERS  += \
+    $$PWD/GUI/Window.h \
+    $$PWD/GUI/PlotTreeWidget.h \
+    $$PWD/GUI/PlotCanvas.h \
+    $$PWD/GUI/Plot.h \
+    $$PWD/GUI/SpectrumPlot.h \
+    $$PWD/GUI/HistogramPlot.h \
+    $$PWD/GUI/EyePlot.h \
+    $$PWD/GUI/CompareDialog.h \
+    $$PWD/GUI/MaskDialog.h \
+    $$PWD/GUI/SincReconstructor.h \
+    $$PWD/GUI/Board.h \
+    $$PWD/GUI/CommonKnobs/CommonKnobs.h \
+    $$PWD/GUI/CommonKnobs/TimeControl.h \
+    $$PWD/GUI/CommonKnobs/ScaleControl.h \
+    $$PWD/GUI/CommonKnobs/TimeSpinBox.h \
+    $$PWD/GUI/ProgressBarDialog.h \
+    $$PWD/GUI/ProbeAssignDialog.h \
+    $$PWD/GUI/TriggerSetupDialog.h \
+    $$PWD/GUI/SoftwareTriggerDialog.h \
+    $$PWD/GUI/DecoderDialog.h \
+    $$PWD/GUI/AnnotationPlot.h \
+    $$PWD/GUI/MathPlot.h \
+    $$PWD/GUI/KnobsWidget.h \
+    $$PWD/GUI/ConnectDevice.h \
+    $$PWD/MyApplication.h
+
+FORMS    += \
+    $$PWD/GUI/Board.ui \
+    $$PWD/GUI/CommonKnobs/TimeControl.ui \
+    $$PWD/GUI/CommonKnobs/CommonKnobs.ui \
+    $$PWD/GUI/CommonKnobs/ScaleControl.ui \
+    $$PWD/GUI/PlotTreeWidget.ui \
+    $$PWD/GUI/ProgressBarDialog.ui \
+    $$PWD/GUI/ProbeAssignDialog.ui \
+    $$PWD/GUI/TriggerSetupDialog.ui \
+    $$PWD/GUI/SoftwareTriggerDialog.ui \
+    $$PWD/GUI/DecoderDialog.ui \
+    $$PWD/GUI/CompareDialog.ui \
+    $$PWD/GUI/MaskDialog.ui \
+    $$PWD/GUI/KnobsWidget.ui \
+    $$PWD/GUI/ConnectDevice.ui